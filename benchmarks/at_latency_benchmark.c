@@ -0,0 +1,293 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief AT command round trip latency benchmark
+ *
+ * Measures the AT/OK round trip time through the AT client and the Linux
+ * UART port, first with the default UART settings and then with
+ * U_PORT_UART_FLAG_LOW_LATENCY, U_PORT_UART_FLAG_EXCLUSIVE and
+ * U_PORT_UART_FLAG_FLUSH_INPUT set in uCxAtClientConfig_t.
+ *
+ * Without arguments a responder thread answers on the master side of a PTY.
+ * A PTY has no driver latency so both runs should be about the same; run it
+ * against a module behind a USB serial adapter to see the difference.
+ *
+ * A third run connects to a responder on a loopback TCP socket through a
+ * "tcp://" device name, which shows the overhead of the socket transport.
+ *
+ * Usage: at_latency_benchmark [uart_device] [baudrate]
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "u_cx_at_client.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define DEFAULT_BAUDRATE    115200
+#define DEFAULT_ITERATIONS  200
+#define MAX_ITERATIONS      100000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    int masterFd;    /**< PTY master, or the accepted connection for TCP */
+    int slaveFd;
+    int listenFd;    /**< Listening socket for TCP, -1 for a PTY */
+    char devName[64];
+    pthread_t thread;
+    volatile bool terminate;
+} ptyResponder_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static char gRxBuf[1024];
+static char gUrcBuf[1024];
+static int64_t gRoundTripNs[MAX_ITERATIONS];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Answers every command line with OK, like a module with echo off
+static void *responderThread(void *pArg)
+{
+    ptyResponder_t *pResponder = (ptyResponder_t *)pArg;
+    static const char okRsp[] = "\r\nOK\r\n";
+
+    while (!pResponder->terminate) {
+        bool accepting = (pResponder->masterFd < 0);
+        int fd = accepting ? pResponder->listenFd : pResponder->masterFd;
+        struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+        if (accepting) {
+            pResponder->masterFd = accept(pResponder->listenFd, NULL, NULL);
+            continue;
+        }
+        char buf[64];
+        ssize_t count = read(pResponder->masterFd, buf, sizeof(buf));
+        if ((count <= 0) && (pResponder->listenFd >= 0)) {
+            // Client disconnected, wait for the next one
+            close(pResponder->masterFd);
+            pResponder->masterFd = -1;
+            continue;
+        }
+        for (ssize_t i = 0; i < count; i++) {
+            if ((buf[i] == '\r') &&
+                (write(pResponder->masterFd, okRsp, sizeof(okRsp) - 1) < 0)) {
+                return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+static const char *responderStart(ptyResponder_t *pResponder)
+{
+    memset(pResponder, 0, sizeof(ptyResponder_t));
+    pResponder->listenFd = -1;
+    pResponder->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pResponder->masterFd < 0) {
+        return NULL;
+    }
+    if ((grantpt(pResponder->masterFd) != 0) || (unlockpt(pResponder->masterFd) != 0) ||
+        (ptsname_r(pResponder->masterFd, pResponder->devName, sizeof(pResponder->devName)) != 0)) {
+        close(pResponder->masterFd);
+        return NULL;
+    }
+    // Keep the slave open so that the PTY isn't hung up between the runs
+    pResponder->slaveFd = open(pResponder->devName, O_RDWR | O_NOCTTY);
+    if ((pResponder->slaveFd < 0) ||
+        (pthread_create(&pResponder->thread, NULL, responderThread, pResponder) != 0)) {
+        if (pResponder->slaveFd >= 0) {
+            close(pResponder->slaveFd);
+        }
+        close(pResponder->masterFd);
+        return NULL;
+    }
+    return pResponder->devName;
+}
+
+// Same responder behind a loopback TCP port
+static const char *tcpResponderStart(ptyResponder_t *pResponder)
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+
+    memset(pResponder, 0, sizeof(ptyResponder_t));
+    pResponder->masterFd = -1;
+    pResponder->slaveFd = -1;
+    pResponder->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (pResponder->listenFd < 0) {
+        return NULL;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // Any free port
+    if ((bind(pResponder->listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (listen(pResponder->listenFd, 1) != 0) ||
+        (getsockname(pResponder->listenFd, (struct sockaddr *)&addr, &addrLen) != 0) ||
+        (pthread_create(&pResponder->thread, NULL, responderThread, pResponder) != 0)) {
+        close(pResponder->listenFd);
+        return NULL;
+    }
+    snprintf(pResponder->devName, sizeof(pResponder->devName), "tcp://127.0.0.1:%u",
+             (unsigned int)ntohs(addr.sin_port));
+    return pResponder->devName;
+}
+
+static void responderStop(ptyResponder_t *pResponder)
+{
+    pResponder->terminate = true;
+    pthread_join(pResponder->thread, NULL);
+    if (pResponder->slaveFd >= 0) {
+        close(pResponder->slaveFd);
+    }
+    if (pResponder->masterFd >= 0) {
+        close(pResponder->masterFd);
+    }
+    if (pResponder->listenFd >= 0) {
+        close(pResponder->listenFd);
+    }
+}
+
+static int compareNs(const void *pA, const void *pB)
+{
+    int64_t a = *(const int64_t *)pA;
+    int64_t b = *(const int64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static bool benchRoundTrip(const char *pName, const char *pDevName, int32_t baudRate,
+                           bool flowControl, uint32_t uartFlags, size_t iterations)
+{
+    uCxAtClientConfig_t config;
+    uCxAtClient_t client;
+    int64_t total = 0;
+    bool ok = true;
+
+    memset(&config, 0, sizeof(config));
+    config.pRxBuffer = gRxBuf;
+    config.rxBufferLen = sizeof(gRxBuf);
+    config.pUrcBuffer = gUrcBuf;
+    config.urcBufferLen = sizeof(gUrcBuf);
+    config.pUartDevName = pDevName;
+    config.uartFlags = uartFlags;
+    uCxAtClientInit(&config, &client);
+    if (uCxAtClientOpen(&client, baudRate, flowControl) != 0) {
+        printf("  %s: failed to open %s\n", pName, pDevName);
+        uCxAtClientDeinit(&client);
+        return false;
+    }
+
+    // Warm up, also turns off echo on a real module
+    uCxAtClientExecSimpleCmdF(&client, "ATE0", "", U_CX_AT_UTIL_PARAM_LAST);
+    for (size_t i = 0; ok && (i < iterations); i++) {
+        int64_t start = benchGetTimeNs();
+        ok = (uCxAtClientExecSimpleCmdF(&client, "AT", "", U_CX_AT_UTIL_PARAM_LAST) == 0);
+        gRoundTripNs[i] = benchGetTimeNs() - start;
+        total += gRoundTripNs[i];
+    }
+    uCxAtClientClose(&client);
+    uCxAtClientDeinit(&client);
+    if (!ok) {
+        printf("  %s: AT command failed\n", pName);
+        return false;
+    }
+
+    benchPrintResult(pName, iterations, 0, total);
+    qsort(gRoundTripNs, iterations, sizeof(gRoundTripNs[0]), compareNs);
+    printf("  %s: p50 %.0f us, p99 %.0f us, max %.0f us\n", pName,
+           (double)gRoundTripNs[iterations / 2] / 1000.0,
+           (double)gRoundTripNs[(iterations * 99) / 100] / 1000.0,
+           (double)gRoundTripNs[iterations - 1] / 1000.0);
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t iterations = benchGetIterations(DEFAULT_ITERATIONS);
+    int32_t baudRate = (argc > 2) ? atoi(argv[2]) : DEFAULT_BAUDRATE;
+    const uint32_t lowLatencyFlags = U_PORT_UART_FLAG_LOW_LATENCY | U_PORT_UART_FLAG_EXCLUSIVE |
+                                     U_PORT_UART_FLAG_FLUSH_INPUT;
+    ptyResponder_t responder;
+    const char *pDevName;
+    bool ok = true;
+
+    if (iterations > MAX_ITERATIONS) {
+        iterations = MAX_ITERATIONS;
+    }
+
+    uCxLogDisable();
+    uPortInit();
+    if (argc > 1) {
+        pDevName = argv[1];
+    } else {
+        pDevName = responderStart(&responder);
+        if (pDevName == NULL) {
+            printf("Failed to create PTY\n");
+            return 1;
+        }
+    }
+
+    // A PTY has no RTS/CTS
+    bool flowControl = (argc > 1);
+    ok = benchRoundTrip("at_round_trip_default", pDevName, baudRate, flowControl, 0, iterations) && ok;
+    ok = benchRoundTrip("at_round_trip_low_latency", pDevName, baudRate, flowControl,
+                        lowLatencyFlags, iterations) && ok;
+
+    if (argc <= 1) {
+        responderStop(&responder);
+        pDevName = tcpResponderStart(&responder);
+        if (pDevName == NULL) {
+            printf("Failed to create TCP responder\n");
+            return 1;
+        }
+        ok = benchRoundTrip("at_round_trip_tcp", pDevName, baudRate, false, 0, iterations) && ok;
+        responderStop(&responder);
+    }
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Full stack benchmark against the AT server simulator
+ *
+ * Runs the generated u-connectXpress API through the AT client, the POSIX
+ * OS port and the Linux UART port against the AT server simulator
+ * (at_simulator.c) on the other end of a PTY:
+ * - AT round trips and a command with a string response
+ * - Socket write and read throughput with binary transfers
+ * - AT round trips while the simulator sends a stream of URCs
+ *
+ * All responses are checked, so the benchmark also works as an
+ * integration test of the whole stack.
+ *
+ * Usage: at_sim_benchmark [baudrate] [rsp_latency_us] [urc_interval_us]
+ * A baud rate of 0 (default) runs the link as fast as the PTY allows.
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx.h"
+#include "u_cx_general.h"
+#include "u_cx_system.h"
+#include "u_cx_socket.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+#include "at_simulator.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define DEFAULT_ITERATIONS       500
+#define DEFAULT_URC_INTERVAL_US  1000
+#define SOCKET_CHUNK_SIZE        1000
+#define SOCKET_TOTAL_BYTES       (256 * 1000)
+#define SOCKET_SECONDS           2     // Max link time per direction with a baud rate
+#define URC_COUNT                1000
+#define URC_WAIT_MS              5000
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const atSimScript_t gScript[] = {
+    { "AT+GMI", "u-blox", AT_SIM_STATUS_OK },
+    { "AT+GMM", "NORA-W36", AT_SIM_STATUS_OK },
+    { "AT+USOCR=", "+USOCR:0", AT_SIM_STATUS_OK },
+    { "AT+USOCL=", NULL, AT_SIM_STATUS_OK },
+};
+
+static char gRxBuf[2048];
+static char gUrcBuf[2048];
+static uint8_t gData[SOCKET_CHUNK_SIZE];
+static uCxAtClientConfig_t gClientConfig;
+static uCxAtClient_t gClient;
+static uCxHandle_t gUcxHandle;
+static volatile size_t gUrcCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void dataAvailableUrc(struct uCxHandle *puCxHandle, int32_t socketHandle, int32_t numberBytes)
+{
+    (void)puCxHandle;
+    if ((socketHandle == 0) && (numberBytes == 100)) {
+        gUrcCount++;
+    }
+}
+
+static bool clientOpen(const char *pDevName, int32_t baudRate, bool urcs)
+{
+    memset(&gClientConfig, 0, sizeof(gClientConfig));
+    gClientConfig.pRxBuffer = gRxBuf;
+    gClientConfig.rxBufferLen = sizeof(gRxBuf);
+    gClientConfig.pUrcBuffer = gUrcBuf;
+    gClientConfig.urcBufferLen = sizeof(gUrcBuf);
+    gClientConfig.pUartDevName = pDevName;
+    gClientConfig.timeoutMs = 10;
+    uCxAtClientInit(&gClientConfig, &gClient);
+    if (uCxAtClientOpen(&gClient, (baudRate > 0) ? baudRate : 115200, false) != 0) {
+        printf("  failed to open %s\n", pDevName);
+        uCxAtClientDeinit(&gClient);
+        return false;
+    }
+    uCxInit(&gClient, &gUcxHandle);
+    if (urcs) {
+        uCxSocketRegisterDataAvailable(&gUcxHandle, dataAvailableUrc);
+    }
+    // The simulator starts with echo on like a module, this is also the
+    // first command which starts the URC injection
+    return (uCxSystemSetEchoOff(&gUcxHandle) == 0);
+}
+
+static void clientClose(void)
+{
+    uCxAtClientClose(&gClient);
+    uCxAtClientDeinit(&gClient);
+}
+
+static bool benchCommands(size_t iterations)
+{
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        if (uCxGeneralAttention(&gUcxHandle) != 0) {
+            printf("  AT failed\n");
+            return false;
+        }
+    }
+    benchPrintResult("sim_at_round_trip", iterations, 0, benchGetTimeNs() - start);
+
+    start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        const char *pManufacturer = NULL;
+        bool ok = uCxGeneralGetManufacturerIdentificationBegin(&gUcxHandle, &pManufacturer) &&
+                  (strcmp(pManufacturer, "u-blox") == 0);
+        if ((uCxEnd(&gUcxHandle) != 0) || !ok) {
+            printf("  AT+GMI failed\n");
+            return false;
+        }
+    }
+    benchPrintResult("sim_get_manufacturer", iterations, 0, benchGetTimeNs() - start);
+
+    // Unknown commands get ERROR from the simulator
+    if (uCxSystemReboot(&gUcxHandle) >= 0) {
+        printf("  AT+CPWROFF didn't fail\n");
+        return false;
+    }
+    return true;
+}
+
+static bool benchSocket(int32_t baudRate)
+{
+    static uint8_t rxData[SOCKET_CHUNK_SIZE];
+    size_t totalBytes = SOCKET_TOTAL_BYTES;
+    if ((baudRate > 0) && ((size_t)baudRate / 10 * SOCKET_SECONDS < totalBytes)) {
+        // Keep the run short on a slow simulated link
+        totalBytes = U_MAX((size_t)baudRate / 10 * SOCKET_SECONDS, SOCKET_CHUNK_SIZE);
+    }
+    size_t chunks = totalBytes / SOCKET_CHUNK_SIZE;
+
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < chunks; i++) {
+        if (uCxSocketWrite(&gUcxHandle, 0, gData, SOCKET_CHUNK_SIZE) != SOCKET_CHUNK_SIZE) {
+            printf("  AT+USOWB failed\n");
+            return false;
+        }
+    }
+    benchPrintResult("sim_socket_write", chunks, chunks * SOCKET_CHUNK_SIZE, benchGetTimeNs() - start);
+
+    start = benchGetTimeNs();
+    for (size_t i = 0; i < chunks; i++) {
+        memset(rxData, 0, sizeof(rxData));
+        if ((uCxSocketRead(&gUcxHandle, 0, SOCKET_CHUNK_SIZE, rxData) != SOCKET_CHUNK_SIZE) ||
+            (memcmp(rxData, gData, sizeof(rxData)) != 0)) {
+            printf("  AT+USORB failed\n");
+            return false;
+        }
+    }
+    benchPrintResult("sim_socket_read", chunks, chunks * SOCKET_CHUNK_SIZE, benchGetTimeNs() - start);
+    return true;
+}
+
+static bool benchUrcs(int32_t baudRate, int32_t rspLatencyUs, int32_t urcIntervalUs)
+{
+    atSimConfig_t config;
+    atSimStats_t stats;
+    atSim_t sim;
+    size_t atCount = 0;
+    bool ok = true;
+
+    memset(&config, 0, sizeof(config));
+    config.baudRate = baudRate;
+    config.rspLatencyUs = rspLatencyUs;
+    config.echo = true;
+    config.pUrc = "+UESODA:0,100";
+    config.urcIntervalUs = urcIntervalUs;
+    config.urcCount = URC_COUNT;
+    const char *pDevName = atSimStart(&sim, &config);
+    if (pDevName == NULL) {
+        printf("  failed to create PTY\n");
+        return false;
+    }
+    gUrcCount = 0;
+    if (!clientOpen(pDevName, baudRate, true)) {
+        atSimStop(&sim, NULL);
+        return false;
+    }
+
+    // Keep sending commands while the URCs arrive
+    int64_t start = benchGetTimeNs();
+    int64_t waitUntil = start + ((int64_t)URC_COUNT * urcIntervalUs * 1000) +
+                        ((int64_t)URC_WAIT_MS * 1000000);
+    while ((gUrcCount < URC_COUNT) && (benchGetTimeNs() < waitUntil)) {
+        if (uCxGeneralAttention(&gUcxHandle) != 0) {
+            ok = false;
+            break;
+        }
+        atCount++;
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    uCxAtUrcStats_t urcStats;
+    uCxAtClientGetUrcStats(&gClient, &urcStats);
+    clientClose();
+    atSimStop(&sim, &stats);
+
+    benchPrintResult("sim_at_during_urcs", atCount, 0, elapsed);
+    printf("  sim_urcs: %zu of %zu URCs received in %.1f ms (%.0f URCs/s)\n", gUrcCount,
+           stats.urcCount, (double)elapsed / 1e6, (double)gUrcCount * 1e9 / (double)elapsed);
+    printf("  sim_urcs: %u dispatched, %u dropped, peak queue depth %zu, max latency %d ms\n",
+           urcStats.dispatchCount, urcStats.dropCount, urcStats.peakQueueDepth,
+           urcStats.maxLatencyMs);
+    if (!ok || (gUrcCount != stats.urcCount)) {
+        printf("  ERROR: %s\n", ok ? "URCs lost" : "AT failed during URCs");
+        return false;
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t iterations = benchGetIterations(DEFAULT_ITERATIONS);
+    int32_t baudRate = (argc > 1) ? atoi(argv[1]) : 0;
+    int32_t rspLatencyUs = (argc > 2) ? atoi(argv[2]) : 0;
+    int32_t urcIntervalUs = (argc > 3) ? atoi(argv[3]) : DEFAULT_URC_INTERVAL_US;
+    atSimConfig_t config;
+    atSimStats_t stats;
+    atSim_t sim;
+    bool ok;
+
+    if ((baudRate < 0) || (rspLatencyUs < 0) || (urcIntervalUs <= 0)) {
+        printf("Usage: %s [baudrate] [rsp_latency_us] [urc_interval_us]\n", argv[0]);
+        return 1;
+    }
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gData); i++) {
+        gData[i] = (uint8_t)i;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.baudRate = baudRate;
+    config.rspLatencyUs = rspLatencyUs;
+    config.echo = true;
+    config.pScript = gScript;
+    config.scriptLength = sizeof(gScript) / sizeof(gScript[0]);
+    const char *pDevName = atSimStart(&sim, &config);
+    if (pDevName == NULL) {
+        printf("Failed to create PTY\n");
+        return 1;
+    }
+    ok = clientOpen(pDevName, baudRate, false);
+    if (ok) {
+        ok = benchCommands(iterations) && benchSocket(baudRate);
+        clientClose();
+    }
+    atSimStop(&sim, &stats);
+    printf("  simulator: %zu commands, %zu errors, %zu bytes received, %zu bytes sent\n",
+           stats.cmdCount, stats.errorCount, stats.rxBytes, stats.txBytes);
+
+    ok = ok && benchUrcs(baudRate, rspLatencyUs, urcIntervalUs);
+
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief u-connectXpress AT server simulator running on the master side of a PTY
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "at_simulator.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define SOH_CHAR            0x01
+
+/* Largest binary payload sent for AT+USORB */
+#define MAX_BINARY_TX       4096
+/* Max bytes consumed at a time, keeps the simulated baud rate smooth */
+#define READ_CHUNK_SIZE     64
+/* Interval for checking for termination while idle */
+#define POLL_INTERVAL_MS    100
+/* Interval for checking if the URC injection should start */
+#define URC_START_POLL_NS   1000000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef enum {
+    RX_STATE_LINE,
+    RX_STATE_BINARY_HEADER,
+    RX_STATE_BINARY_DATA
+} rxState_t;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static int64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static void sleepNs(int64_t ns)
+{
+    if (ns > 0) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)(ns / 1000000000);
+        ts.tv_nsec = (long)(ns % 1000000000);
+        while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR)) {
+        }
+    }
+}
+
+// Time for transferring length bytes at the simulated baud rate (8N1)
+static int64_t linkTimeNs(const atSim_t *pSim, size_t length)
+{
+    if (pSim->config.baudRate <= 0) {
+        return 0;
+    }
+    return (int64_t)length * 10 * 1000000000 / pSim->config.baudRate;
+}
+
+// Sends data to the client, the caller must hold txMutex
+static void sendLocked(atSim_t *pSim, const void *pData, size_t length)
+{
+    const uint8_t *pBytes = (const uint8_t *)pData;
+    size_t sent = 0;
+
+    while (sent < length) {
+        ssize_t ret = write(pSim->masterFd, &pBytes[sent], length - sent);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                struct pollfd pfd = { .fd = pSim->masterFd, .events = POLLOUT, .revents = 0 };
+                poll(&pfd, 1, POLL_INTERVAL_MS);
+                continue;
+            }
+            break;
+        }
+        sent += (size_t)ret;
+    }
+    pSim->stats.txBytes += sent;
+    // Hold the link for as long as the data would take on the wire
+    sleepNs(linkTimeNs(pSim, sent));
+}
+
+static void sendData(atSim_t *pSim, const void *pData, size_t length)
+{
+    pthread_mutex_lock(&pSim->txMutex);
+    sendLocked(pSim, pData, length);
+    pthread_mutex_unlock(&pSim->txMutex);
+}
+
+// Sends the response lines (may be NULL) followed by the status
+static void respond(atSim_t *pSim, const char *pRsp, int32_t status)
+{
+    char buf[AT_SIM_MAX_CMD_LEN + 64];
+    int len = 0;
+
+    if (pRsp != NULL) {
+        len = snprintf(buf, sizeof(buf), "\r\n%s\r\n", pRsp);
+    }
+    if (status == AT_SIM_STATUS_OK) {
+        len += snprintf(&buf[len], sizeof(buf) - (size_t)len, "\r\nOK\r\n");
+    } else {
+        pSim->stats.errorCount++;
+        if (status == AT_SIM_STATUS_ERROR) {
+            len += snprintf(&buf[len], sizeof(buf) - (size_t)len, "\r\nERROR\r\n");
+        } else {
+            len += snprintf(&buf[len], sizeof(buf) - (size_t)len, "\r\nERROR:%d\r\n", (int)status);
+        }
+    }
+    sendData(pSim, buf, (size_t)len);
+}
+
+// AT+USORB=<handle>,<length>: responds with length bytes of binary data
+static void respondBinary(atSim_t *pSim, int handle, size_t length)
+{
+    static uint8_t data[MAX_BINARY_TX];
+    char header[48];
+
+    if (length > sizeof(data)) {
+        length = sizeof(data);
+    }
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)i;
+    }
+    int len = snprintf(header, sizeof(header), "\r\n+USORB:%d,%c%c%c", handle, SOH_CHAR,
+                       (char)(length >> 8), (char)(length & 0xFF));
+
+    // Keep the response together so that no URC ends up inside it
+    pthread_mutex_lock(&pSim->txMutex);
+    sendLocked(pSim, header, (size_t)len);
+    sendLocked(pSim, data, length);
+    sendLocked(pSim, "\r\n\r\nOK\r\n", 8);
+    pthread_mutex_unlock(&pSim->txMutex);
+    pSim->stats.binaryTxBytes += length;
+}
+
+static const atSimScript_t *findScript(const atSim_t *pSim, const char *pCmd)
+{
+    for (size_t i = 0; i < pSim->config.scriptLength; i++) {
+        const atSimScript_t *pEntry = &pSim->config.pScript[i];
+        size_t len = strlen(pEntry->pCmd);
+        if ((len > 0) && (pEntry->pCmd[len - 1] == '=')) {
+            if (strncmp(pCmd, pEntry->pCmd, len) == 0) {
+                return pEntry;
+            }
+        } else if (strcmp(pCmd, pEntry->pCmd) == 0) {
+            return pEntry;
+        }
+    }
+    return NULL;
+}
+
+// Handles a complete command, binaryLength is the size of the binary
+// payload for commands ending with a binary transfer
+static void handleCmd(atSim_t *pSim, bool binary, size_t binaryLength)
+{
+    const char *pCmd = pSim->cmd;
+    const atSimScript_t *pEntry;
+    int handle;
+    int length;
+
+    pSim->stats.cmdCount++;
+    pSim->gotCmd = true;
+    if (pSim->echo) {
+        // Binary payloads are not echoed
+        char eol = '\r';
+        pthread_mutex_lock(&pSim->txMutex);
+        sendLocked(pSim, pCmd, strlen(pCmd));
+        sendLocked(pSim, &eol, 1);
+        pthread_mutex_unlock(&pSim->txMutex);
+    }
+    sleepNs((int64_t)pSim->config.rspLatencyUs * 1000);
+
+    pEntry = findScript(pSim, pCmd);
+    if (pEntry != NULL) {
+        respond(pSim, pEntry->pRsp, pEntry->status);
+    } else if ((strcmp(pCmd, "AT") == 0) || (strcmp(pCmd, "ATE0") == 0) ||
+               (strcmp(pCmd, "ATE1") == 0)) {
+        if (pCmd[2] == 'E') {
+            pSim->echo = (pCmd[3] == '1');
+        }
+        respond(pSim, NULL, AT_SIM_STATUS_OK);
+    } else if (binary && (sscanf(pCmd, "AT+USOWB=%d,", &handle) == 1)) {
+        char rsp[32];
+        snprintf(rsp, sizeof(rsp), "+USOWB:%d,%u", handle, (unsigned int)binaryLength);
+        respond(pSim, rsp, AT_SIM_STATUS_OK);
+    } else if (!binary && (sscanf(pCmd, "AT+USORB=%d,%d", &handle, &length) == 2) &&
+               (length >= 0)) {
+        respondBinary(pSim, handle, (size_t)length);
+    } else {
+        respond(pSim, NULL, AT_SIM_STATUS_ERROR);
+    }
+}
+
+static void *simThread(void *pArg)
+{
+    atSim_t *pSim = (atSim_t *)pArg;
+    rxState_t state = RX_STATE_LINE;
+    size_t cmdLen = 0;
+    size_t binaryLength = 0;
+    size_t binaryRemaining = 0;
+    uint8_t header[2];
+    size_t headerPos = 0;
+
+    while (!pSim->terminate) {
+        struct pollfd pfd = { .fd = pSim->masterFd, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        uint8_t buf[READ_CHUNK_SIZE];
+        ssize_t count = read(pSim->masterFd, buf, sizeof(buf));
+        if (count <= 0) {
+            continue;
+        }
+        pSim->stats.rxBytes += (size_t)count;
+        sleepNs(linkTimeNs(pSim, (size_t)count));
+
+        for (ssize_t i = 0; i < count; i++) {
+            uint8_t byte = buf[i];
+            switch (state) {
+                case RX_STATE_LINE:
+                    if ((byte == '\r') || (byte == '\n')) {
+                        if (cmdLen > 0) {
+                            pSim->cmd[cmdLen] = 0;
+                            handleCmd(pSim, false, 0);
+                            cmdLen = 0;
+                        }
+                    } else if ((byte == SOH_CHAR) && (cmdLen > 0)) {
+                        pSim->cmd[cmdLen] = 0;
+                        headerPos = 0;
+                        state = RX_STATE_BINARY_HEADER;
+                    } else if (cmdLen < sizeof(pSim->cmd) - 1) {
+                        pSim->cmd[cmdLen++] = (char)byte;
+                    }
+                    break;
+                case RX_STATE_BINARY_HEADER:
+                    header[headerPos++] = byte;
+                    if (headerPos == sizeof(header)) {
+                        binaryLength = ((size_t)header[0] << 8) | header[1];
+                        binaryRemaining = binaryLength;
+                        state = RX_STATE_BINARY_DATA;
+                    }
+                    break;
+                case RX_STATE_BINARY_DATA:
+                    binaryRemaining--;
+                    break;
+            }
+            if ((state == RX_STATE_BINARY_DATA) && (binaryRemaining == 0)) {
+                pSim->stats.binaryRxBytes += binaryLength;
+                handleCmd(pSim, true, binaryLength);
+                cmdLen = 0;
+                state = RX_STATE_LINE;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void *urcThread(void *pArg)
+{
+    atSim_t *pSim = (atSim_t *)pArg;
+    char urc[AT_SIM_MAX_CMD_LEN];
+    int len = snprintf(urc, sizeof(urc), "\r\n%s\r\n", pSim->config.pUrc);
+    size_t sent = 0;
+
+    // Wait for the first command so that the client has registered its URC handlers
+    while (!pSim->terminate && !pSim->gotCmd) {
+        sleepNs(URC_START_POLL_NS);
+    }
+    int64_t next = getTimeNs();
+
+    while (!pSim->terminate &&
+           ((pSim->config.urcCount == 0) || (sent < pSim->config.urcCount))) {
+        next += (int64_t)pSim->config.urcIntervalUs * 1000;
+        int64_t waitNs;
+        while (!pSim->terminate && ((waitNs = next - getTimeNs()) > 0)) {
+            // Sleep in steps so that a slow rate doesn't delay atSimStop()
+            sleepNs((waitNs < (POLL_INTERVAL_MS * 1000000)) ? waitNs : (POLL_INTERVAL_MS * 1000000));
+        }
+        if (pSim->terminate) {
+            break;
+        }
+        pthread_mutex_lock(&pSim->txMutex);
+        sendLocked(pSim, urc, (size_t)len);
+        pSim->stats.urcCount++;
+        pthread_mutex_unlock(&pSim->txMutex);
+        sent++;
+    }
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+const char *atSimStart(atSim_t *pSim, const atSimConfig_t *pConfig)
+{
+    memset(pSim, 0, sizeof(atSim_t));
+    pSim->config = *pConfig;
+    pSim->echo = pConfig->echo;
+    pSim->slaveFd = -1;
+    pthread_mutex_init(&pSim->txMutex, NULL);
+
+    pSim->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pSim->masterFd < 0) {
+        pthread_mutex_destroy(&pSim->txMutex);
+        return NULL;
+    }
+    if ((grantpt(pSim->masterFd) != 0) || (unlockpt(pSim->masterFd) != 0) ||
+        (ptsname_r(pSim->masterFd, pSim->devName, sizeof(pSim->devName)) != 0)) {
+        atSimStop(pSim, NULL);
+        return NULL;
+    }
+
+    // Keep the slave open so that the PTY stays usable while the client
+    // opens and closes it, and make it raw so that the line discipline
+    // doesn't touch the binary data
+    pSim->slaveFd = open(pSim->devName, O_RDWR | O_NOCTTY);
+    struct termios tty;
+    if ((pSim->slaveFd < 0) || (tcgetattr(pSim->slaveFd, &tty) != 0)) {
+        atSimStop(pSim, NULL);
+        return NULL;
+    }
+    cfmakeraw(&tty);
+    if ((tcsetattr(pSim->slaveFd, TCSANOW, &tty) != 0) ||
+        (pthread_create(&pSim->thread, NULL, simThread, pSim) != 0)) {
+        pSim->thread = 0;
+        atSimStop(pSim, NULL);
+        return NULL;
+    }
+    if ((pConfig->pUrc != NULL) &&
+        (pthread_create(&pSim->urcThread, NULL, urcThread, pSim) != 0)) {
+        pSim->urcThread = 0;
+        atSimStop(pSim, NULL);
+        return NULL;
+    }
+
+    return pSim->devName;
+}
+
+void atSimStop(atSim_t *pSim, atSimStats_t *pStats)
+{
+    pSim->terminate = true;
+    if (pSim->urcThread != 0) {
+        pthread_join(pSim->urcThread, NULL);
+        pSim->urcThread = 0;
+    }
+    if (pSim->thread != 0) {
+        pthread_join(pSim->thread, NULL);
+        pSim->thread = 0;
+    }
+    if (pSim->slaveFd >= 0) {
+        close(pSim->slaveFd);
+        pSim->slaveFd = -1;
+    }
+    if (pSim->masterFd >= 0) {
+        close(pSim->masterFd);
+        pSim->masterFd = -1;
+    }
+    pthread_mutex_destroy(&pSim->txMutex);
+    if (pStats != NULL) {
+        *pStats = pSim->stats;
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief u-connectXpress AT server simulator running on the master side of a PTY
+ *
+ * Makes it possible to run the whole stack, from uCxInit() and the
+ * generated API down to the Linux UART port, without a module. The client
+ * opens the PTY slave device returned by atSimStart() as if it was a
+ * serial port.
+ *
+ * The simulator answers with "OK", "ERROR" or "ERROR:<code>" and supports
+ * echo (ATE0/ATE1), scripted responses, binary transfers in both
+ * directions (AT+USOWB and AT+USORB) and injection of a URC at a fixed
+ * rate. The link can be paced to a simulated baud rate or run as fast as
+ * the PTY allows.
+ */
+
+#ifndef AT_SIMULATOR_H
+#define AT_SIMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** Values for atSimScript_t.status besides a positive extended error code */
+#define AT_SIM_STATUS_OK     0
+#define AT_SIM_STATUS_ERROR  (-1)
+
+/** Max length of a command line, excluding binary data */
+#define AT_SIM_MAX_CMD_LEN   1024
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Scripted response, checked before the built-in commands */
+typedef struct {
+    const char *pCmd;       /**< Command, e.g. "AT+GMR". A command ending with '=' matches
+                                 any parameters, e.g. "AT+USOCR=". */
+    const char *pRsp;       /**< Lines sent before the status, separated by "\r\n" (may be NULL) */
+    int32_t status;         /**< AT_SIM_STATUS_OK, AT_SIM_STATUS_ERROR or an extended error
+                                 code sent as "ERROR:<status>" */
+} atSimScript_t;
+
+typedef struct {
+    int32_t baudRate;       /**< Simulated link baud rate in both directions (0 = unlimited) */
+    int32_t rspLatencyUs;   /**< Delay between receiving a command and responding */
+    bool echo;              /**< Echo at start, changed with ATE0/ATE1 */
+    const atSimScript_t *pScript; /**< Scripted responses (may be NULL) */
+    size_t scriptLength;    /**< Number of entries in pScript */
+    const char *pUrc;       /**< URC line to inject, e.g. "+UESODA:0,100" (NULL = none).
+                                 The injection starts at the first received command. */
+    int32_t urcIntervalUs;  /**< Time between injected URCs */
+    size_t urcCount;        /**< Number of URCs to inject (0 = until stopped) */
+} atSimConfig_t;
+
+typedef struct {
+    size_t cmdCount;        /**< Number of commands received */
+    size_t errorCount;      /**< Number of commands answered with an error */
+    size_t urcCount;        /**< Number of injected URCs */
+    size_t rxBytes;         /**< Total number of bytes received from the client */
+    size_t txBytes;         /**< Total number of bytes sent to the client */
+    size_t binaryRxBytes;   /**< Payload bytes received in binary transfers */
+    size_t binaryTxBytes;   /**< Payload bytes sent in binary transfers */
+} atSimStats_t;
+
+typedef struct {
+    atSimConfig_t config;
+    atSimStats_t stats;
+    int masterFd;
+    int slaveFd;
+    char devName[64];
+    pthread_t thread;
+    pthread_t urcThread;
+    pthread_mutex_t txMutex;
+    volatile bool terminate;
+    volatile bool gotCmd;   /**< Set at the first command, starts the URC injection */
+    bool echo;
+    char cmd[AT_SIM_MAX_CMD_LEN];
+} atSim_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+  * @brief  Create a PTY pair and start the simulator threads
+  *
+  * @param[out] pSim:     simulator instance.
+  * @param[in]  pConfig:  simulator configuration.
+  * @return               the PTY slave device name for uPortUartOpen() or
+  *                       NULL on failure.
+  */
+const char *atSimStart(atSim_t *pSim, const atSimConfig_t *pConfig);
+
+/**
+  * @brief  Stop the simulator and release the PTY pair
+  *
+  * @param[in]  pSim:    simulator instance.
+  * @param[out] pStats:  statistics (may be NULL).
+  */
+void atSimStop(atSim_t *pSim, atSimStats_t *pStats);
+
+#endif // AT_SIMULATOR_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Common benchmark helpers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+int64_t benchGetTimeNs(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((int64_t)time.tv_sec * 1000000000) + time.tv_nsec;
+}
+
+int64_t benchGetThreadCpuTimeNs(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return ((int64_t)time.tv_sec * 1000000000) + time.tv_nsec;
+}
+
+void benchPrintResult(const char *pName, size_t iterations, size_t bytes, int64_t elapsedNs)
+{
+    double seconds = (double)elapsedNs / 1e9;
+    printf("%-32s %10zu iter %10.1f ns/iter", pName, iterations,
+           (double)elapsedNs / (double)iterations);
+    if (bytes > 0) {
+        printf(" %10.1f MB/s", ((double)bytes / (1024.0 * 1024.0)) / seconds);
+    }
+    printf("\n");
+}
+
+size_t benchGetIterations(size_t defaultIterations)
+{
+    const char *pIterations = getenv("BENCH_ITERATIONS");
+    if (pIterations != NULL) {
+        long iterations = strtol(pIterations, NULL, 10);
+        if (iterations > 0) {
+            return (size_t)iterations;
+        }
+    }
+    return defaultIterations;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Common benchmark helpers
+ */
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+  * @brief  Get a monotonic time stamp in nanoseconds
+  */
+int64_t benchGetTimeNs(void);
+
+/**
+  * @brief  Get the CPU time consumed by the calling thread in nanoseconds
+  */
+int64_t benchGetThreadCpuTimeNs(void);
+
+/**
+  * @brief  Print the result of a benchmark run
+  *
+  * @param[in]  pName:       the name of the benchmark.
+  * @param      iterations:  number of iterations that were run.
+  * @param      bytes:       number of bytes processed in total (0 if not applicable).
+  * @param      elapsedNs:   the total run time.
+  */
+void benchPrintResult(const char *pName, size_t iterations, size_t bytes, int64_t elapsedNs);
+
+/**
+  * @brief  Get the number of iterations to run
+  *
+  * Returns the value of the BENCH_ITERATIONS environment variable or
+  * defaultIterations if not set.
+  */
+size_t benchGetIterations(size_t defaultIterations);
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief XMODEM CRC16 benchmark
+ *
+ * Measures uCxXmodemCrc16() for 128 byte and 1 KB XMODEM blocks and compares
+ * it with a bit by bit implementation. Build crc_benchmark_table to compare
+ * with the single table implementation (U_CX_XMODEM_CRC_SLICING=0).
+ *
+ * Usage: crc_benchmark
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_at_util.h"
+#include "u_cx_xmodem.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const size_t gBlockSizes[] = { 128, 1024 };
+
+static uint8_t gBlock[1024];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static uint16_t bitwiseCrc16(const uint8_t *pBuf, size_t len)
+{
+    uint16_t crc = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)pBuf[i] << 8;
+        for (int j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (uint16_t)((crc << 1) ^ 0x1021);
+            } else {
+                crc = (uint16_t)(crc << 1);
+            }
+        }
+    }
+
+    return crc;
+}
+
+static void benchCrc(size_t blockSize, size_t iterations, bool bitwise)
+{
+    char name[32];
+    volatile uint16_t crc = 0;
+    snprintf(name, sizeof(name), "%s_%zu", bitwise ? "crc16_bitwise" : "crc16", blockSize);
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        // Use the previous CRC so that the calls can't be optimized away
+        gBlock[0] = (uint8_t)crc;
+        crc = bitwise ? bitwiseCrc16(gBlock, blockSize) : uCxXmodemCrc16(0, gBlock, blockSize);
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, iterations, iterations * blockSize, elapsed);
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(void)
+{
+    size_t iterations = benchGetIterations(100000);
+
+    for (size_t i = 0; i < sizeof(gBlock); i++) {
+        gBlock[i] = (uint8_t)((i * 131) + 7);
+    }
+    if (uCxXmodemCrc16(0, gBlock, sizeof(gBlock)) != bitwiseCrc16(gBlock, sizeof(gBlock))) {
+        printf("CRC mismatch\n");
+        return 1;
+    }
+    printf("Slicing-by-8: %s\n", (U_CX_XMODEM_CRC_SLICING == 1) ? "enabled" : "disabled");
+    for (size_t i = 0; i < sizeof(gBlockSizes) / sizeof(gBlockSizes[0]); i++) {
+        // Scale down the iterations for larger blocks
+        size_t sizeIterations = U_MAX(iterations * 128 / gBlockSizes[i], 1);
+        benchCrc(gBlockSizes[i], sizeIterations, true);
+        benchCrc(gBlockSizes[i], sizeIterations, false);
+    }
+    return 0;
+}
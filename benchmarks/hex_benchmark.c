@@ -0,0 +1,127 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Hex encode/decode and string escape benchmark
+ *
+ * Measures uCxAtUtilBinaryToHex(), uCxAtUtilHexToBinary() and
+ * uCxAtUtilWriteEscStringStream() for typical payload sizes: 20 bytes (BLE
+ * default ATT MTU), 244 bytes (max BLE data length) and 4 KB. Build
+ * hex_benchmark_scalar to compare with the portable implementation
+ * (U_CX_USE_SIMD=0).
+ *
+ * Usage: hex_benchmark
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_at_util.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const size_t gPayloadSizes[] = { 20, 244, 4096 };
+
+static uint8_t gData[4096];
+static uint8_t gDecoded[4096];
+static char gHex[(sizeof(gData) * 2) + 1];
+static char gString[4096];
+static size_t gWrittenBytes;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void benchEncode(size_t payloadSize, size_t iterations)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "encode_%zu", payloadSize);
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        uCxAtUtilBinaryToHex(gData, payloadSize, gHex, sizeof(gHex));
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, iterations, iterations * payloadSize, elapsed);
+}
+
+static void benchDecode(size_t payloadSize, size_t iterations)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "decode_%zu", payloadSize);
+    uCxAtUtilBinaryToHex(gData, payloadSize, gHex, sizeof(gHex));
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        uCxAtUtilHexToBinary(gHex, gDecoded, payloadSize);
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, iterations, iterations * payloadSize, elapsed);
+    if (memcmp(gData, gDecoded, payloadSize) != 0) {
+        printf("  WARNING: decoded data mismatch\n");
+    }
+}
+
+static int32_t nullWrite(void *pArg, const void *pData, size_t dataLen)
+{
+    (void)pArg;
+    (void)pData;
+    gWrittenBytes += dataLen;
+    return (int32_t)dataLen;
+}
+
+static void benchEscape(size_t payloadSize, size_t iterations)
+{
+    char name[32];
+    char scratch[42];
+    snprintf(name, sizeof(name), "escape_%zu", payloadSize);
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        uCxAtUtilWriteEscStringStream(gString, payloadSize, scratch, sizeof(scratch),
+                                      nullWrite, NULL);
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, iterations, iterations * payloadSize, elapsed);
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(void)
+{
+    size_t iterations = benchGetIterations(100000);
+
+    for (size_t i = 0; i < sizeof(gData); i++) {
+        gData[i] = (uint8_t)((i * 131) + 7);
+    }
+    // Printable text with an occasional character needing escape (e.g. JSON payload)
+    for (size_t i = 0; i < sizeof(gString); i++) {
+        gString[i] = ((i % 64) == 63) ? '"' : (char)('a' + (i % 26));
+    }
+    printf("SIMD: %s\n", (U_CX_USE_SIMD == 1) ? "enabled" : "disabled");
+    for (size_t i = 0; i < sizeof(gPayloadSizes) / sizeof(gPayloadSizes[0]); i++) {
+        // Scale down the iterations for larger payloads
+        size_t sizeIterations = U_MAX(iterations * 20 / gPayloadSizes[i], 1);
+        benchEncode(gPayloadSizes[i], sizeIterations);
+        benchDecode(gPayloadSizes[i], sizeIterations);
+        benchEscape(gPayloadSizes[i], sizeIterations);
+    }
+    return 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Full stack benchmark over an emulated UART link
+ *
+ * Runs the generated API against the AT server simulator (at_simulator.c)
+ * through the link emulator backend (link_emulator.c), which paces the
+ * bytes at the baud rate, batches RX data like a USB serial adapter and
+ * models RTS/CTS. Each scenario measures AT round trips and socket write
+ * and read throughput:
+ * - A direct wire at 115200 and 921600 baud
+ * - 921600 baud behind a USB adapter with a 16 ms and a 1 ms latency timer
+ * - A burst of URCs into a small client RX buffer, with and without
+ *   RTS/CTS, while the client only reads from its RX task
+ * - Injected bit errors and dropped bytes, where failed commands are
+ *   counted instead of ending the run
+ *
+ * Usage: link_emu_benchmark [seed]
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx.h"
+#include "u_cx_general.h"
+#include "u_cx_system.h"
+#include "u_cx_socket.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+#include "at_simulator.h"
+#include "link_emulator.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define DEFAULT_ITERATIONS   100
+#define SOCKET_CHUNK_SIZE    1000
+#define SOCKET_SECONDS       1     // Link time per direction
+#define ERROR_CMD_TIMEOUT_MS 200   // Short timeout for commands lost to injected errors
+#define ECHO_OFF_ATTEMPTS    10
+#define URC_COUNT            1000
+#define URC_INTERVAL_US      10    // Faster than the link, the URCs are sent back to back
+#define URC_WAIT_MS          5000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    const char *pName;
+    int32_t baudRate;
+    bool flowControl;
+    int32_t latencyTimerMs;
+    size_t rxBufferSize;
+    uint32_t errorPpm;
+    uint32_t dropPpm;
+    bool urcs;              /**< URC burst instead of commands */
+} scenario_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const scenario_t gScenarios[] = {
+    { "link_115200",             115200,  true,  0,  0,   0,   0,   false },
+    { "link_921600",             921600,  true,  0,  0,   0,   0,   false },
+    { "link_921600_usb16",       921600,  true,  16, 0,   0,   0,   false },
+    { "link_921600_usb1",        921600,  true,  1,  0,   0,   0,   false },
+    { "link_921600_errors",      921600,  true,  0,  0,   200, 0,   false },
+    { "link_921600_drops",       921600,  true,  0,  0,   0,   200, false },
+    { "link_3000000_urcs_rtscts", 3000000, true,  0,  256, 0,   0,   true },
+    { "link_3000000_urcs_nofc",  3000000, false, 0,  256, 0,   0,   true },
+};
+
+static char gRxBuf[2048];
+static char gUrcBuf[2048];
+static uint8_t gData[SOCKET_CHUNK_SIZE];
+static volatile size_t gUrcCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void dataAvailableUrc(struct uCxHandle *puCxHandle, int32_t socketHandle, int32_t numberBytes)
+{
+    (void)puCxHandle;
+    if ((socketHandle == 0) && (numberBytes == 100)) {
+        gUrcCount++;
+    }
+}
+
+// Leaves the reading to the RX task, returns the number of lost URCs
+static size_t benchUrcs(const char *pName)
+{
+    int64_t start = benchGetTimeNs();
+    int64_t waitUntil = start + ((int64_t)URC_WAIT_MS * 1000000);
+    while ((gUrcCount < URC_COUNT) && (benchGetTimeNs() < waitUntil)) {
+        uPortSleepMs(10);
+    }
+    benchPrintResult(pName, gUrcCount, 0, benchGetTimeNs() - start);
+    return URC_COUNT - gUrcCount;
+}
+
+static void printLinkUsage(const char *pName, size_t bytes, int32_t baudRate, int64_t elapsedNs)
+{
+    double wireNs = (double)bytes * 10.0 * 1e9 / (double)baudRate;
+    printf("  %s: %.0f%% of the link rate\n", pName, 100.0 * wireNs / (double)elapsedNs);
+}
+
+static size_t benchCommands(const char *pName, uCxHandle_t *pUcxHandle, size_t iterations)
+{
+    char name[64];
+    size_t failed = 0;
+
+    snprintf(name, sizeof(name), "%s_at", pName);
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        if (uCxGeneralAttention(pUcxHandle) != 0) {
+            failed++;
+        }
+    }
+    benchPrintResult(name, iterations, 0, benchGetTimeNs() - start);
+    return failed;
+}
+
+static size_t benchSocket(const char *pName, uCxHandle_t *pUcxHandle, int32_t baudRate)
+{
+    static uint8_t rxData[SOCKET_CHUNK_SIZE];
+    size_t chunks = ((size_t)baudRate / 10 * SOCKET_SECONDS) / SOCKET_CHUNK_SIZE;
+    size_t failed = 0;
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s_write", pName);
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < chunks; i++) {
+        if (uCxSocketWrite(pUcxHandle, 0, gData, SOCKET_CHUNK_SIZE) != SOCKET_CHUNK_SIZE) {
+            failed++;
+        }
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, chunks, chunks * SOCKET_CHUNK_SIZE, elapsed);
+    printLinkUsage(name, chunks * SOCKET_CHUNK_SIZE, baudRate, elapsed);
+
+    snprintf(name, sizeof(name), "%s_read", pName);
+    start = benchGetTimeNs();
+    for (size_t i = 0; i < chunks; i++) {
+        memset(rxData, 0, sizeof(rxData));
+        if ((uCxSocketRead(pUcxHandle, 0, SOCKET_CHUNK_SIZE, rxData) != SOCKET_CHUNK_SIZE) ||
+            (memcmp(rxData, gData, sizeof(rxData)) != 0)) {
+            failed++;
+        }
+    }
+    elapsed = benchGetTimeNs() - start;
+    benchPrintResult(name, chunks, chunks * SOCKET_CHUNK_SIZE, elapsed);
+    printLinkUsage(name, chunks * SOCKET_CHUNK_SIZE, baudRate, elapsed);
+    return failed;
+}
+
+static bool runScenario(const scenario_t *pScenario, size_t iterations, uint32_t seed)
+{
+    uCxAtClientConfig_t clientConfig;
+    uCxAtClient_t client;
+    uCxHandle_t ucxHandle;
+    linkEmuConfig_t linkConfig;
+    linkEmuStats_t linkStats;
+    atSimConfig_t simConfig;
+    atSim_t sim;
+    bool injectErrors = (pScenario->errorPpm > 0) || (pScenario->dropPpm > 0);
+    size_t failed = 0;
+
+    // The simulator runs unpaced, the link emulator does the pacing
+    memset(&simConfig, 0, sizeof(simConfig));
+    simConfig.echo = true;
+    if (pScenario->urcs) {
+        simConfig.pUrc = "+UESODA:0,100";
+        simConfig.urcIntervalUs = URC_INTERVAL_US;
+        simConfig.urcCount = URC_COUNT;
+    }
+    const char *pDevName = atSimStart(&sim, &simConfig);
+    if (pDevName == NULL) {
+        printf("  %s: failed to create PTY\n", pScenario->pName);
+        return false;
+    }
+
+    memset(&linkConfig, 0, sizeof(linkConfig));
+    linkConfig.latencyTimerMs = pScenario->latencyTimerMs;
+    linkConfig.rxBufferSize = pScenario->rxBufferSize;
+    linkConfig.errorPpm = pScenario->errorPpm;
+    linkConfig.dropPpm = pScenario->dropPpm;
+    linkConfig.seed = seed;
+    linkEmuConfigure(&linkConfig);
+
+    memset(&clientConfig, 0, sizeof(clientConfig));
+    clientConfig.pRxBuffer = gRxBuf;
+    clientConfig.rxBufferLen = sizeof(gRxBuf);
+    clientConfig.pUrcBuffer = gUrcBuf;
+    clientConfig.urcBufferLen = sizeof(gUrcBuf);
+    clientConfig.pUartDevName = pDevName;
+    clientConfig.pUartOps = &gLinkEmuOps;
+    uCxAtClientInit(&clientConfig, &client);
+    if (uCxAtClientOpen(&client, pScenario->baudRate, pScenario->flowControl) != 0) {
+        printf("  %s: failed to open %s\n", pScenario->pName, pDevName);
+        uCxAtClientDeinit(&client);
+        atSimStop(&sim, NULL);
+        return false;
+    }
+    uCxInit(&client, &ucxHandle);
+    gUrcCount = 0;
+    uCxSocketRegisterDataAvailable(&ucxHandle, dataAvailableUrc);
+    if (injectErrors) {
+        uCxAtClientSetCommandTimeout(&client, ERROR_CMD_TIMEOUT_MS, true);
+    }
+
+    // Echo off may need a few attempts when errors are injected
+    bool ok = false;
+    for (int i = 0; !ok && (i < (injectErrors ? ECHO_OFF_ATTEMPTS : 1)); i++) {
+        ok = (uCxSystemSetEchoOff(&ucxHandle) == 0);
+    }
+    if (ok && pScenario->urcs) {
+        // ATE0 started the URC burst
+        failed += benchUrcs(pScenario->pName);
+    } else if (ok) {
+        failed += benchCommands(pScenario->pName, &ucxHandle, iterations);
+        failed += benchSocket(pScenario->pName, &ucxHandle, pScenario->baudRate);
+    } else {
+        printf("  %s: ATE0 failed\n", pScenario->pName);
+    }
+
+    linkEmuGetStats(client.uartHandle, &linkStats);
+    uCxAtClientClose(&client);
+    uCxAtClientDeinit(&client);
+    atSimStop(&sim, NULL);
+
+    printf("  %s: %zu failed, tx %zu B, rx %zu B in %zu batches, overruns %zu/%zu (rx/tx), "
+           "RTS/CTS stalls %zu/%zu, %zu corrupted, %zu dropped\n", pScenario->pName, failed,
+           linkStats.txBytes, linkStats.rxBytes, linkStats.rxBatches, linkStats.rxOverruns,
+           linkStats.txOverruns, linkStats.rtsStalls, linkStats.ctsStalls,
+           linkStats.corruptedBytes, linkStats.droppedBytes);
+
+    // Without flow control or with injected errors some commands or URCs
+    // are expected to be lost, but the client must recover
+    if (!pScenario->flowControl || injectErrors) {
+        return ok;
+    }
+    if (failed > 0) {
+        printf("  ERROR: %zu commands failed or URCs lost\n", failed);
+        return false;
+    }
+    return ok;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t iterations = benchGetIterations(DEFAULT_ITERATIONS);
+    uint32_t seed = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1;
+    bool ok = true;
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gData); i++) {
+        gData[i] = (uint8_t)i;
+    }
+    for (size_t i = 0; i < sizeof(gScenarios) / sizeof(gScenarios[0]); i++) {
+        ok = runScenario(&gScenarios[i], iterations, seed) && ok;
+    }
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
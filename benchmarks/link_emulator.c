@@ -0,0 +1,500 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief UART link emulator backend
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "link_emulator.h"
+#include "uart/u_port_uart_linux.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define DEFAULT_PACKET_SIZE     64
+#define DEFAULT_BUFFER_SIZE     4096
+#define MAX_PACKET_SIZE         512
+/* Max bytes moved at a time, keeps the pacing smooth */
+#define CHUNK_SIZE              16
+/* Interval for checking for termination while idle */
+#define POLL_INTERVAL_MS        100
+/* A link that has been idle for less than this is treated as busy so
+   that oversleeping doesn't add up and lower the throughput */
+#define IDLE_THRESHOLD_NS       500000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    uint8_t *pData;
+    size_t size;
+    size_t readPos;
+    size_t count;
+} ringBuffer_t;
+
+typedef struct {
+    linkEmuConfig_t config;
+    uPortUartHandle_t inner;
+    int innerFd;            /**< For checking if the module side takes data, -1 if unknown */
+    bool flowControl;
+    int64_t byteNs;         /**< Time for one byte on the wire (0 = unpaced) */
+    pthread_mutex_t mutex;
+    pthread_cond_t rxCond;  /**< Signaled when rx changes */
+    pthread_cond_t txCond;  /**< Signaled when tx changes */
+    ringBuffer_t rx;        /**< Delivered to the client, not read yet */
+    ringBuffer_t tx;        /**< Written by the client, not sent yet */
+    uint32_t rxRandom;
+    uint32_t txRandom;
+    pthread_t rxThread;
+    pthread_t txThread;
+    volatile bool terminate;
+    linkEmuStats_t stats;
+} linkEmu_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static linkEmuConfig_t gConfig;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static int64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static void sleepUntilNs(int64_t timeNs)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(timeNs / 1000000000);
+    ts.tv_nsec = (long)(timeNs % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+// Waits on a condition that uses CLOCK_MONOTONIC, the mutex must be locked
+static void condWaitUntil(pthread_cond_t *pCond, pthread_mutex_t *pMutex, int64_t deadlineNs)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadlineNs / 1000000000);
+    ts.tv_nsec = (long)(deadlineNs % 1000000000);
+    pthread_cond_timedwait(pCond, pMutex, &ts);
+}
+
+static bool ringInit(ringBuffer_t *pRing, size_t size)
+{
+    memset(pRing, 0, sizeof(ringBuffer_t));
+    pRing->pData = malloc(size);
+    pRing->size = size;
+    return (pRing->pData != NULL);
+}
+
+static size_t ringPut(ringBuffer_t *pRing, const uint8_t *pData, size_t length)
+{
+    size_t count = 0;
+    while ((count < length) && (pRing->count < pRing->size)) {
+        pRing->pData[(pRing->readPos + pRing->count) % pRing->size] = pData[count++];
+        pRing->count++;
+    }
+    return count;
+}
+
+static size_t ringGet(ringBuffer_t *pRing, uint8_t *pData, size_t length)
+{
+    size_t count = 0;
+    while ((count < length) && (pRing->count > 0)) {
+        pData[count++] = pRing->pData[pRing->readPos];
+        pRing->readPos = (pRing->readPos + 1) % pRing->size;
+        pRing->count--;
+    }
+    return count;
+}
+
+// xorshift32, reproducible for a given seed
+static uint32_t nextRandom(uint32_t *pState)
+{
+    uint32_t x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+    return x;
+}
+
+// Applies the configured errors in place and returns the new length
+// Must be called with mutex locked.
+static size_t injectErrors(linkEmu_t *pEmu, uint32_t *pRandom, uint8_t *pData, size_t length)
+{
+    size_t outLength = 0;
+
+    if ((pEmu->config.errorPpm == 0) && (pEmu->config.dropPpm == 0)) {
+        return length;
+    }
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = pData[i];
+        if ((pEmu->config.dropPpm > 0) &&
+            ((nextRandom(pRandom) % 1000000) < pEmu->config.dropPpm)) {
+            pEmu->stats.droppedBytes++;
+            continue;
+        }
+        if ((pEmu->config.errorPpm > 0) &&
+            ((nextRandom(pRandom) % 1000000) < pEmu->config.errorPpm)) {
+            byte ^= (uint8_t)(1u << (nextRandom(pRandom) % 8));
+            pEmu->stats.corruptedBytes++;
+        }
+        pData[outLength++] = byte;
+    }
+    return outLength;
+}
+
+// Hands a batch over to the client, RTS stops the RX side while the client
+// buffer is full
+static void deliver(linkEmu_t *pEmu, uint8_t *pData, size_t length)
+{
+    size_t delivered = 0;
+    bool stalled = false;
+
+    pthread_mutex_lock(&pEmu->mutex);
+    length = injectErrors(pEmu, &pEmu->rxRandom, pData, length);
+    while (!pEmu->terminate && (delivered < length)) {
+        delivered += ringPut(&pEmu->rx, &pData[delivered], length - delivered);
+        if (delivered < length) {
+            if (!pEmu->flowControl) {
+                pEmu->stats.rxOverruns += length - delivered;
+                break;
+            }
+            if (!stalled) {
+                pEmu->stats.rtsStalls++;
+                stalled = true;
+            }
+            pthread_cond_broadcast(&pEmu->rxCond);
+            condWaitUntil(&pEmu->rxCond, &pEmu->mutex,
+                          getTimeNs() + ((int64_t)POLL_INTERVAL_MS * 1000000));
+        }
+    }
+    if (length > 0) {
+        pEmu->stats.rxBatches++;
+        pEmu->stats.rxBytes += delivered;
+        pthread_cond_broadcast(&pEmu->rxCond);
+    }
+    pthread_mutex_unlock(&pEmu->mutex);
+}
+
+// Module to client: paces the bytes read from the module side and batches
+// them like a USB serial adapter
+static void *rxThread(void *pArg)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)pArg;
+    const uPortUartOps_t *pInner = pEmu->config.pInnerOps;
+    int64_t latencyNs = (int64_t)pEmu->config.latencyTimerMs * 1000000;
+    uint8_t batch[MAX_PACKET_SIZE];
+    size_t batchLength = 0;
+    int64_t batchDeadline = 0;
+    int64_t wireTime = 0;
+
+    while (!pEmu->terminate) {
+        int64_t now = getTimeNs();
+        int32_t timeoutMs = POLL_INTERVAL_MS;
+        if (batchLength > 0) {
+            int64_t waitNs = (batchDeadline > now) ? (batchDeadline - now) : 0;
+            timeoutMs = (int32_t)((waitNs + 999999) / 1000000);
+        }
+        size_t space = pEmu->config.packetSize - batchLength;
+        int32_t count = pInner->readFn(pEmu->inner, &batch[batchLength],
+                                       (space < CHUNK_SIZE) ? space : CHUNK_SIZE, timeoutMs);
+        if (count < 0) {
+            break;
+        }
+        now = getTimeNs();
+        if (count > 0) {
+            if (wireTime + IDLE_THRESHOLD_NS < now) {
+                wireTime = now;
+            }
+            wireTime += (int64_t)count * pEmu->byteNs;
+            sleepUntilNs(wireTime);
+            if (batchLength == 0) {
+                batchDeadline = wireTime + latencyNs;
+            }
+            batchLength += (size_t)count;
+            now = getTimeNs();
+        }
+        if ((batchLength > 0) && ((latencyNs == 0) || (batchLength >= pEmu->config.packetSize) ||
+                                  (now >= batchDeadline))) {
+            deliver(pEmu, batch, batchLength);
+            batchLength = 0;
+        }
+    }
+    return NULL;
+}
+
+// True if the module side can take more data right now
+static bool moduleReady(const linkEmu_t *pEmu, int32_t timeoutMs)
+{
+    if (pEmu->innerFd < 0) {
+        return true;
+    }
+    struct pollfd pfd = { .fd = pEmu->innerFd, .events = POLLOUT, .revents = 0 };
+    return (poll(&pfd, 1, timeoutMs) > 0);
+}
+
+// Client to module: paces the bytes written by the client, CTS stops the
+// TX side while the module side doesn't take data
+static void *txThread(void *pArg)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)pArg;
+    const uPortUartOps_t *pInner = pEmu->config.pInnerOps;
+    int64_t wireTime = 0;
+
+    while (!pEmu->terminate) {
+        uint8_t buf[CHUNK_SIZE];
+        pthread_mutex_lock(&pEmu->mutex);
+        if (pEmu->tx.count == 0) {
+            condWaitUntil(&pEmu->txCond, &pEmu->mutex,
+                          getTimeNs() + ((int64_t)POLL_INTERVAL_MS * 1000000));
+        }
+        size_t count = ringGet(&pEmu->tx, buf, sizeof(buf));
+        size_t length = injectErrors(pEmu, &pEmu->txRandom, buf, count);
+        pthread_cond_broadcast(&pEmu->txCond);
+        pthread_mutex_unlock(&pEmu->mutex);
+        if (count == 0) {
+            continue;
+        }
+
+        int64_t now = getTimeNs();
+        if (wireTime + IDLE_THRESHOLD_NS < now) {
+            wireTime = now;
+        }
+        wireTime += (int64_t)count * pEmu->byteNs;
+        sleepUntilNs(wireTime);
+
+        bool ready = moduleReady(pEmu, 0);
+        if (!ready && pEmu->flowControl) {
+            pthread_mutex_lock(&pEmu->mutex);
+            pEmu->stats.ctsStalls++;
+            pthread_mutex_unlock(&pEmu->mutex);
+            while (!pEmu->terminate && !ready) {
+                ready = moduleReady(pEmu, POLL_INTERVAL_MS);
+            }
+        }
+        int32_t written = 0;
+        if (ready && (length > 0)) {
+            written = pInner->writeFn(pEmu->inner, buf, length);
+        }
+        pthread_mutex_lock(&pEmu->mutex);
+        if (ready) {
+            pEmu->stats.txBytes += (written > 0) ? (size_t)written : 0;
+        } else {
+            pEmu->stats.txOverruns += length;
+        }
+        pthread_mutex_unlock(&pEmu->mutex);
+    }
+    return NULL;
+}
+
+static void destroy(linkEmu_t *pEmu)
+{
+    pthread_cond_destroy(&pEmu->rxCond);
+    pthread_cond_destroy(&pEmu->txCond);
+    pthread_mutex_destroy(&pEmu->mutex);
+    free(pEmu->rx.pData);
+    free(pEmu->tx.pData);
+    free(pEmu);
+}
+
+static uPortUartHandle_t linkOpen(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    linkEmu_t *pEmu = calloc(1, sizeof(linkEmu_t));
+    if (pEmu == NULL) {
+        return NULL;
+    }
+    pEmu->config = gConfig;
+    if (pEmu->config.pInnerOps == NULL) {
+        pEmu->config.pInnerOps = &gUPortUartLinuxOps;
+    }
+    if (pEmu->config.packetSize == 0) {
+        pEmu->config.packetSize = DEFAULT_PACKET_SIZE;
+    } else if (pEmu->config.packetSize > MAX_PACKET_SIZE) {
+        pEmu->config.packetSize = MAX_PACKET_SIZE;
+    }
+    if (pEmu->config.rxBufferSize == 0) {
+        pEmu->config.rxBufferSize = DEFAULT_BUFFER_SIZE;
+    }
+    if (pEmu->config.txBufferSize == 0) {
+        pEmu->config.txBufferSize = DEFAULT_BUFFER_SIZE;
+    }
+    pEmu->rxRandom = (pEmu->config.seed != 0) ? pEmu->config.seed : 1;
+    pEmu->txRandom = (pEmu->rxRandom * 2654435761u) | 1u;
+    pEmu->flowControl = useFlowControl;
+    pEmu->byteNs = (baudRate > 0) ? ((int64_t)10 * 1000000000 / baudRate) : 0;
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pEmu->mutex, NULL);
+    pthread_cond_init(&pEmu->rxCond, &condAttr);
+    pthread_cond_init(&pEmu->txCond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    if (!ringInit(&pEmu->rx, pEmu->config.rxBufferSize) ||
+        !ringInit(&pEmu->tx, pEmu->config.txBufferSize)) {
+        destroy(pEmu);
+        return NULL;
+    }
+
+    // The emulator does the flow control, the module side is a PTY or similar
+    const uPortUartOps_t *pInner = pEmu->config.pInnerOps;
+    pEmu->inner = pInner->openFn(pDevName, baudRate, false, flags);
+    if (pEmu->inner == NULL) {
+        destroy(pEmu);
+        return NULL;
+    }
+    pEmu->innerFd = -1;
+    if ((pInner->caps & U_PORT_UART_CAP_POLL_FD) != 0) {
+        pEmu->innerFd = pInner->getFdFn(pEmu->inner);
+    }
+
+    if (pthread_create(&pEmu->rxThread, NULL, rxThread, pEmu) != 0) {
+        pInner->closeFn(pEmu->inner);
+        destroy(pEmu);
+        return NULL;
+    }
+    if (pthread_create(&pEmu->txThread, NULL, txThread, pEmu) != 0) {
+        pEmu->terminate = true;
+        pthread_join(pEmu->rxThread, NULL);
+        pInner->closeFn(pEmu->inner);
+        destroy(pEmu);
+        return NULL;
+    }
+    return pEmu;
+}
+
+static void linkClose(uPortUartHandle_t handle)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)handle;
+    if (pEmu == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pEmu->mutex);
+    pEmu->terminate = true;
+    pthread_cond_broadcast(&pEmu->rxCond);
+    pthread_cond_broadcast(&pEmu->txCond);
+    pthread_mutex_unlock(&pEmu->mutex);
+    pthread_join(pEmu->txThread, NULL);
+    pthread_join(pEmu->rxThread, NULL);
+    pEmu->config.pInnerOps->closeFn(pEmu->inner);
+    destroy(pEmu);
+}
+
+// Blocks while the TX buffer is full, like a UART driver
+static int32_t linkWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)handle;
+    size_t written = 0;
+
+    if ((pEmu == NULL) || (pData == NULL)) {
+        return -1;
+    }
+    pthread_mutex_lock(&pEmu->mutex);
+    while (!pEmu->terminate && (written < length)) {
+        written += ringPut(&pEmu->tx, &((const uint8_t *)pData)[written], length - written);
+        pthread_cond_broadcast(&pEmu->txCond);
+        if (written < length) {
+            condWaitUntil(&pEmu->txCond, &pEmu->mutex,
+                          getTimeNs() + ((int64_t)POLL_INTERVAL_MS * 1000000));
+        }
+    }
+    pthread_mutex_unlock(&pEmu->mutex);
+    return (int32_t)written;
+}
+
+static int32_t linkRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)handle;
+    int64_t deadline = (timeoutMs < 0) ? INT64_MAX :
+                       (getTimeNs() + ((int64_t)timeoutMs * 1000000));
+    size_t count;
+
+    if ((pEmu == NULL) || (pData == NULL) || (length == 0)) {
+        return -1;
+    }
+    pthread_mutex_lock(&pEmu->mutex);
+    while (!pEmu->terminate && (pEmu->rx.count == 0) && (timeoutMs != 0) &&
+           (getTimeNs() < deadline)) {
+        condWaitUntil(&pEmu->rxCond, &pEmu->mutex, deadline);
+    }
+    count = ringGet(&pEmu->rx, (uint8_t *)pData, length);
+    if (count > 0) {
+        // Room for more data, raises RTS again
+        pthread_cond_broadcast(&pEmu->rxCond);
+    }
+    pthread_mutex_unlock(&pEmu->mutex);
+    return (int32_t)count;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+const uPortUartOps_t gLinkEmuOps = {
+    .openFn = linkOpen,
+    .closeFn = linkClose,
+    .writeFn = linkWrite,
+    .readFn = linkRead,
+    .writevFn = NULL,
+    .getFdFn = NULL,
+    .caps = 0
+};
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+void linkEmuConfigure(const linkEmuConfig_t *pConfig)
+{
+    if (pConfig != NULL) {
+        gConfig = *pConfig;
+    } else {
+        memset(&gConfig, 0, sizeof(gConfig));
+    }
+}
+
+void linkEmuGetStats(uPortUartHandle_t handle, linkEmuStats_t *pStats)
+{
+    linkEmu_t *pEmu = (linkEmu_t *)handle;
+
+    pthread_mutex_lock(&pEmu->mutex);
+    *pStats = pEmu->stats;
+    pthread_mutex_unlock(&pEmu->mutex);
+}
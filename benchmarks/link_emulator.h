@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief UART link emulator backend
+ *
+ * A uPortUartOps_t backend that sits between the AT client and another
+ * backend (by default the Linux UART port talking to the AT server
+ * simulator over a PTY) and gives the link the properties of a real wire:
+ * - Bytes are paced at the baud rate passed to openFn in both directions
+ * - RX bytes can be batched like a USB serial adapter does, a batch is
+ *   delivered when it is full or when the latency timer expires
+ * - With flow control a full client RX buffer deasserts RTS, which stops
+ *   the RX side, and a module that doesn't take data deasserts CTS, which
+ *   stops the TX side. Without flow control the data is lost instead.
+ * - Bytes can be corrupted or dropped at a given rate in both directions
+ *
+ * The error injection uses a seeded pseudo random sequence so a run with
+ * the same configuration corrupts the same bytes.
+ */
+
+#ifndef LINK_EMULATOR_H
+#define LINK_EMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "u_port_uart.h"
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    const uPortUartOps_t *pInnerOps; /**< Backend for the module side (NULL = Linux UART port) */
+    int32_t latencyTimerMs; /**< RX batching latency timer, e.g. 16 for a default FTDI (0 = off) */
+    size_t packetSize;      /**< RX batch size that is delivered at once (0 = 64) */
+    size_t rxBufferSize;    /**< Client RX buffer size (0 = 4096) */
+    size_t txBufferSize;    /**< Client TX buffer size (0 = 4096) */
+    uint32_t errorPpm;      /**< Corrupted bytes per million (0 = none) */
+    uint32_t dropPpm;       /**< Dropped bytes per million (0 = none) */
+    uint32_t seed;          /**< Seed for the error injection (0 = 1) */
+} linkEmuConfig_t;
+
+typedef struct {
+    size_t txBytes;         /**< Bytes sent to the module side */
+    size_t rxBytes;         /**< Bytes delivered to the client */
+    size_t rxBatches;       /**< Number of RX batches delivered to the client */
+    size_t rxOverruns;      /**< RX bytes lost because the client RX buffer was full */
+    size_t txOverruns;      /**< TX bytes lost because the module side wasn't ready */
+    size_t rtsStalls;       /**< Number of times RTS stopped the RX side */
+    size_t ctsStalls;       /**< Number of times CTS stopped the TX side */
+    size_t corruptedBytes;  /**< Number of injected bit errors */
+    size_t droppedBytes;    /**< Number of injected byte drops */
+} linkEmuStats_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Link emulator backend for uCxAtClientConfig_t.pUartOps */
+extern const uPortUartOps_t gLinkEmuOps;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+  * @brief  Set the configuration used by the following gLinkEmuOps.openFn calls
+  *
+  * uPortUartOps_t has no context argument so the configuration is global.
+  * The baud rate and flow control come from openFn.
+  *
+  * @param[in]  pConfig:  link configuration, NULL for the defaults.
+  */
+void linkEmuConfigure(const linkEmuConfig_t *pConfig);
+
+/**
+  * @brief  Get the statistics of an open link
+  *
+  * @param[in]  handle:   handle returned by gLinkEmuOps.openFn.
+  * @param[out] pStats:   statistics.
+  */
+void linkEmuGetStats(uPortUartHandle_t handle, linkEmuStats_t *pStats);
+
+#endif // LINK_EMULATOR_H
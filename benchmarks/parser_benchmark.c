@@ -0,0 +1,204 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief AT parser benchmark
+ *
+ * Measures the AT client RX path (byte classification, line classification,
+ * URC queueing and parameter parsing) by feeding recorded-like AT traffic
+ * from memory.
+ *
+ * Usage: parser_benchmark
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_at_client.h"
+#include "u_cx_at_util.h"
+#include "u_cx_log.h"
+#include "u_port_uart_mem.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const char gUrcCorpus[] =
+    "\r\n+UEWLU:0,\"AABBCCDDEEFF\",6\r\n"
+    "\r\n+UEWSNU\r\n"
+    "\r\n+UESOC:0\r\n"
+    "\r\n+UESODA:0,1024\r\n"
+    "\r\n+UESODA:0,512\r\n"
+    "\r\n+UEBTBGD:AABBCCDDEEFFp,-50,\"NORA-B1\",0,0201061AFF4C000215\r\n"
+    "\r\n+UEBTBGD:112233445566p,-71,\"\",0,0201061AFF4C000215\r\n"
+    "\r\n+UEMQDA:0,1,12\r\n"
+    "\r\n+UESOCL:0\r\n"
+    "\r\n+UEWLD:0,0\r\n";
+
+static const char gCmdRsp[] =
+    "AT+GMM\r\n"
+    "\r\n+GMM:\"NORA-W36\"\r\n"
+    "\r\nOK\r\n";
+
+static const char *gLineCorpus[] = {
+    "", "OK", "ERROR", "ERROR:12", "AT+GMM", "+GMM:\"NORA-W36\"",
+    "+UEWLU:0,\"AABBCCDDEEFF\",6", "+UESODA:0,1024", "NORA-W36", "*FOO:1"
+};
+
+// HTTP header block as returned by AT+UWHTTPGH (only the quoted part)
+static const char gHttpHeaderParams[] =
+    "0,\"HTTP/1.1 200 OK\\r\\nContent-Type: application/json; charset=utf-8\\r\\n"
+    "Content-Length: 1234\\r\\nConnection: keep-alive\\r\\nCache-Control: no-cache, no-store\\r\\n"
+    "Date: Mon, 01 Jan 2025 00:00:00 GMT\\r\\nServer: nginx/1.25.3\\r\\n"
+    "ETag: \\\"33a64df551425fcc55e4d42a148795d9f25f89d4\\\"\\r\\n\\r\\n\"";
+
+static char gRxBuf[1024];
+static char gUrcBuf[4096];
+static uCxAtClient_t gClient;
+static size_t gUrcCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine,
+                        size_t lineLength, uint8_t *pBinaryData, size_t binaryDataLen)
+{
+    (void)pClient;
+    (void)pTag;
+    (void)pLine;
+    (void)lineLength;
+    (void)pBinaryData;
+    (void)binaryDataLen;
+    gUrcCount++;
+}
+
+static void benchUrcStream(size_t iterations)
+{
+    gUrcCount = 0;
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        uPortUartMemSetRxData(gUrcCorpus, sizeof(gUrcCorpus) - 1);
+        uCxAtClientHandleRx(&gClient);
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult("urc_stream", iterations, iterations * (sizeof(gUrcCorpus) - 1), elapsed);
+    if (gUrcCount != iterations * 10) {
+        printf("  WARNING: expected %zu URCs, got %zu\n", iterations * 10, gUrcCount);
+    }
+}
+
+static void benchCmdResponse(size_t iterations)
+{
+    size_t failCount = 0;
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        uPortUartMemSetRxData(gCmdRsp, sizeof(gCmdRsp) - 1);
+        uCxAtClientCmdBeginF(&gClient, "AT+GMM", "", U_CX_AT_UTIL_PARAM_LAST);
+        if (uCxAtClientCmdGetRspParamLine(&gClient, "+GMM:", NULL, NULL) == NULL) {
+            failCount++;
+        }
+        if (uCxAtClientCmdEnd(&gClient) != 0) {
+            failCount++;
+        }
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult("cmd_response", iterations, iterations * (sizeof(gCmdRsp) - 1), elapsed);
+    if (failCount > 0) {
+        printf("  WARNING: %zu commands failed\n", failCount);
+    }
+}
+
+static void benchClassifyLine(size_t iterations)
+{
+    const size_t numLines = sizeof(gLineCorpus) / sizeof(gLineCorpus[0]);
+    size_t lineLengths[sizeof(gLineCorpus) / sizeof(gLineCorpus[0])];
+    size_t bytes = 0;
+    volatile uint32_t sum = 0;
+
+    for (size_t j = 0; j < numLines; j++) {
+        lineLengths[j] = strlen(gLineCorpus[j]);
+        bytes += lineLengths[j];
+    }
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        for (size_t j = 0; j < numLines; j++) {
+            sum += (uint32_t)uCxAtUtilClassifyLine(gLineCorpus[j], lineLengths[j], "+GMM:", 5);
+        }
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult("classify_line", iterations * numLines, iterations * bytes, elapsed);
+}
+
+static void benchParseBinaryString(size_t iterations)
+{
+    char params[sizeof(gHttpHeaderParams)];
+    size_t failCount = 0;
+
+    int64_t start = benchGetTimeNs();
+    for (size_t i = 0; i < iterations; i++) {
+        int32_t session;
+        uBinaryString_t header;
+        // The params are modified in-place so a fresh copy is needed each time
+        memcpy(params, gHttpHeaderParams, sizeof(params));
+        if (uCxAtUtilParseParamsF(params, "d$", &session, &header, U_CX_AT_UTIL_PARAM_LAST) != 2) {
+            failCount++;
+        }
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+    benchPrintResult("parse_binary_string", iterations, iterations * (sizeof(gHttpHeaderParams) - 1), elapsed);
+    if (failCount > 0) {
+        printf("  WARNING: %zu parses failed\n", failCount);
+    }
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(void)
+{
+    static const uCxAtClientConfig_t config = {
+        .pRxBuffer = &gRxBuf[0],
+        .rxBufferLen = sizeof(gRxBuf),
+        .pUrcBuffer = &gUrcBuf[0],
+        .urcBufferLen = sizeof(gUrcBuf),
+        .pUartDevName = "mem",
+        .timeoutMs = 0,
+    };
+    size_t iterations = benchGetIterations(100000);
+
+    uCxLogDisable();
+    uPortInit();
+    uCxAtClientInit(&config, &gClient);
+    if (uCxAtClientOpen(&gClient, 115200, false) != 0) {
+        printf("Failed to open AT client\n");
+        return 1;
+    }
+    uCxAtClientSetUrcCallback(&gClient, urcCallback, NULL);
+
+    benchUrcStream(iterations);
+    benchCmdResponse(iterations);
+    benchClassifyLine(iterations);
+    benchParseBinaryString(iterations);
+
+    uCxAtClientClose(&gClient);
+    uCxAtClientDeinit(&gClient);
+    return 0;
+}
@@ -0,0 +1,369 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Capture and replay of AT traffic
+ *
+ * Captures a workload of commands, socket transfers and URCs against the
+ * AT server simulator (at_simulator.c) with the capture backend, reads the
+ * capture file back and replays it to the same workload at maximum and at
+ * the original speed with the replay backend. Every replay must send the
+ * captured TX and get the same responses and URCs.
+ *
+ * The captured RX is finally used as a workload for the RX parser and URC
+ * dispatching, without commands. Given a capture file, e.g. from a field
+ * gateway, only this last step is run with that file.
+ *
+ * Usage: replay_benchmark [capture_file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "u_cx.h"
+#include "u_cx_general.h"
+#include "u_cx_system.h"
+#include "u_cx_socket.h"
+#include "u_cx_log.h"
+#include "u_port_uart_capture.h"
+#include "bench_utils.h"
+#include "at_simulator.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define CMD_ITERATIONS       100
+#define SOCKET_CHUNK_SIZE    1000
+#define SOCKET_CHUNKS        64
+#define URC_COUNT            500
+#define URC_INTERVAL_US      100
+#define URC_WAIT_MS          5000
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const atSimScript_t gScript[] = {
+    { "AT+GMI", "u-blox", AT_SIM_STATUS_OK },
+};
+
+static char gRxBuf[2048];
+// At maximum speed the URCs captured after the last command are delivered at
+// once, so the URC queue must have room for all of them
+static char gUrcBuf[URC_COUNT * 64];
+static uint8_t gData[SOCKET_CHUNK_SIZE];
+static uCxAtClientConfig_t gClientConfig;
+static uCxAtClient_t gClient;
+static uCxHandle_t gUcxHandle;
+static volatile size_t gUrcCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void dataAvailableUrc(struct uCxHandle *puCxHandle, int32_t socketHandle, int32_t numberBytes)
+{
+    (void)puCxHandle;
+    if ((socketHandle == 0) && (numberBytes == 100)) {
+        gUrcCount++;
+    }
+}
+
+static void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine, size_t lineLength,
+                        uint8_t *pBinaryData, size_t binaryDataLen)
+{
+    (void)pClient;
+    (void)pTag;
+    (void)pLine;
+    (void)lineLength;
+    (void)pBinaryData;
+    (void)binaryDataLen;
+    gUrcCount++;
+}
+
+static bool clientOpen(const char *pDevName, const uPortUartOps_t *pOps, int32_t timeoutMs)
+{
+    memset(&gClientConfig, 0, sizeof(gClientConfig));
+    gClientConfig.pRxBuffer = gRxBuf;
+    gClientConfig.rxBufferLen = sizeof(gRxBuf);
+    gClientConfig.pUrcBuffer = gUrcBuf;
+    gClientConfig.urcBufferLen = sizeof(gUrcBuf);
+    gClientConfig.pUartDevName = pDevName;
+    gClientConfig.pUartOps = pOps;
+    gClientConfig.timeoutMs = timeoutMs;
+    uCxAtClientInit(&gClientConfig, &gClient);
+    if (uCxAtClientOpen(&gClient, 115200, false) != 0) {
+        printf("  failed to open %s\n", pDevName);
+        uCxAtClientDeinit(&gClient);
+        return false;
+    }
+    return true;
+}
+
+static void clientClose(void)
+{
+    uCxAtClientClose(&gClient);
+    uCxAtClientDeinit(&gClient);
+}
+
+// Waits for URCs that arrive after the last command
+static void waitForUrcs(size_t count)
+{
+    int64_t waitUntil = benchGetTimeNs() + ((int64_t)URC_WAIT_MS * 1000000);
+    while ((gUrcCount < count) && (benchGetTimeNs() < waitUntil)) {
+        uCxAtClientHandleRx(&gClient);
+    }
+}
+
+// The same commands are sent in the capture and in the replays
+static bool runWorkload(const char *pName)
+{
+    static uint8_t rxData[SOCKET_CHUNK_SIZE];
+    int64_t start = benchGetTimeNs();
+
+    gUrcCount = 0;
+    uCxInit(&gClient, &gUcxHandle);
+    uCxSocketRegisterDataAvailable(&gUcxHandle, dataAvailableUrc);
+    // The simulator starts the URCs at the first command
+    if (uCxSystemSetEchoOff(&gUcxHandle) != 0) {
+        printf("  %s: ATE0 failed\n", pName);
+        return false;
+    }
+    for (size_t i = 0; i < CMD_ITERATIONS; i++) {
+        const char *pManufacturer = NULL;
+        bool ok = (uCxGeneralAttention(&gUcxHandle) == 0) &&
+                  uCxGeneralGetManufacturerIdentificationBegin(&gUcxHandle, &pManufacturer) &&
+                  (strcmp(pManufacturer, "u-blox") == 0);
+        if ((uCxEnd(&gUcxHandle) != 0) || !ok) {
+            printf("  %s: AT or AT+GMI failed\n", pName);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < SOCKET_CHUNKS; i++) {
+        if (uCxSocketWrite(&gUcxHandle, 0, gData, SOCKET_CHUNK_SIZE) != SOCKET_CHUNK_SIZE) {
+            printf("  %s: AT+USOWB failed\n", pName);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < SOCKET_CHUNKS; i++) {
+        memset(rxData, 0, sizeof(rxData));
+        if ((uCxSocketRead(&gUcxHandle, 0, SOCKET_CHUNK_SIZE, rxData) != SOCKET_CHUNK_SIZE) ||
+            (memcmp(rxData, gData, sizeof(rxData)) != 0)) {
+            printf("  %s: AT+USORB failed\n", pName);
+            return false;
+        }
+    }
+    benchPrintResult(pName, 1 + (2 * CMD_ITERATIONS) + (2 * SOCKET_CHUNKS), 0,
+                     benchGetTimeNs() - start);
+    return true;
+}
+
+static bool capture(const char *pFileName, size_t *pUrcCount)
+{
+    uPortUartCaptureConfig_t captureConfig;
+    atSimConfig_t simConfig;
+    atSimStats_t simStats;
+    atSim_t sim;
+
+    memset(&simConfig, 0, sizeof(simConfig));
+    simConfig.echo = true;
+    simConfig.pScript = gScript;
+    simConfig.scriptLength = sizeof(gScript) / sizeof(gScript[0]);
+    simConfig.pUrc = "+UESODA:0,100";
+    simConfig.urcIntervalUs = URC_INTERVAL_US;
+    simConfig.urcCount = URC_COUNT;
+    const char *pDevName = atSimStart(&sim, &simConfig);
+    if (pDevName == NULL) {
+        printf("  failed to create PTY\n");
+        return false;
+    }
+    memset(&captureConfig, 0, sizeof(captureConfig));
+    captureConfig.pFileName = pFileName;
+    uPortUartCaptureConfigure(&captureConfig);
+    bool ok = clientOpen(pDevName, &gUPortUartCaptureOps, 10);
+    if (ok) {
+        ok = runWorkload("capture_workload");
+        waitForUrcs(URC_COUNT);
+        clientClose();
+    }
+    atSimStop(&sim, &simStats);
+    *pUrcCount = gUrcCount;
+    if (ok && (gUrcCount != simStats.urcCount)) {
+        printf("  ERROR: %zu of %zu URCs received during capture\n", gUrcCount, simStats.urcCount);
+        ok = false;
+    }
+    return ok;
+}
+
+// Reads the whole capture and checks the index, returns the capture length in us
+static bool readCapture(const char *pFileName, uint64_t *pDurationUs)
+{
+    uPortUartCaptureInfo_t info;
+    uPortUartCaptureRecord_t record;
+    size_t records = 0;
+    size_t bytes[2] = { 0, 0 };
+    uint64_t lastUs = 0;
+    bool ordered = true;
+    int32_t ret;
+
+    uPortUartCaptureReader_t reader = uPortUartCaptureReaderOpen(pFileName, &info);
+    if (reader == NULL) {
+        printf("  failed to open %s\n", pFileName);
+        return false;
+    }
+    int64_t start = benchGetTimeNs();
+    while ((ret = uPortUartCaptureReaderNext(reader, &record)) > 0) {
+        ordered = ordered && (record.timeUs >= lastUs);
+        lastUs = record.timeUs;
+        bytes[record.rx ? 1 : 0] += record.length;
+        records++;
+    }
+    int64_t elapsed = benchGetTimeNs() - start;
+
+    // Seek to the middle and compare with a sequential read
+    uint64_t middleUs = lastUs / 2;
+    uPortUartCaptureRecord_t expected;
+    memset(&expected, 0, sizeof(expected));
+    uPortUartCaptureReaderSeek(reader, 0);
+    while ((uPortUartCaptureReaderNext(reader, &expected) > 0) && (expected.timeUs < middleUs)) {
+    }
+    bool seekOk = (uPortUartCaptureReaderSeek(reader, middleUs) == 0) &&
+                  (uPortUartCaptureReaderNext(reader, &record) > 0) &&
+                  (record.timeUs == expected.timeUs) && (record.length == expected.length);
+    uPortUartCaptureReaderClose(reader);
+
+    FILE *pFile = fopen(pFileName, "rb");
+    long fileSize = 0;
+    if (pFile != NULL) {
+        fseek(pFile, 0, SEEK_END);
+        fileSize = ftell(pFile);
+        fclose(pFile);
+    }
+    benchPrintResult("capture_read", records, bytes[0] + bytes[1], elapsed);
+    printf("  capture: %zu records in %zu blocks%s, tx %zu B, rx %zu B, %.1f ms, "
+           "file %ld B (%.1f B overhead per record)\n", records, info.blockCount,
+           info.indexed ? " with index" : "", bytes[0], bytes[1], (double)lastUs / 1000.0,
+           fileSize, (double)((size_t)fileSize - bytes[0] - bytes[1]) / (double)records);
+    *pDurationUs = lastUs;
+    if ((ret < 0) || !info.indexed || !ordered || !seekOk || (records == 0)) {
+        printf("  ERROR: capture file %s\n", (ret < 0) ? "corrupt" : !info.indexed ?
+               "has no index" : !ordered ? "not in time order" : !seekOk ?
+               "seek failed" : "empty");
+        return false;
+    }
+    return true;
+}
+
+static bool replay(const char *pFileName, bool maxSpeed, size_t urcCount, uint64_t durationUs)
+{
+    uPortUartReplayConfig_t replayConfig;
+    uPortUartReplayStats_t stats;
+    const char *pName = maxSpeed ? "replay_max_speed" : "replay_original_speed";
+
+    memset(&replayConfig, 0, sizeof(replayConfig));
+    replayConfig.maxSpeed = maxSpeed;
+    uPortUartReplayConfigure(&replayConfig);
+    if (!clientOpen(pFileName, &gUPortUartReplayOps, 10)) {
+        return false;
+    }
+    int64_t start = benchGetTimeNs();
+    bool ok = runWorkload(pName);
+    waitForUrcs(urcCount);
+    int64_t elapsed = benchGetTimeNs() - start;
+    uPortUartReplayGetStats(gClient.uartHandle, &stats);
+    clientClose();
+
+    printf("  %s: %.1f ms (capture %.1f ms), tx %zu B with %zu mismatches, %zu extra, "
+           "rx %zu B, %zu of %zu URCs%s\n", pName, (double)elapsed / 1e6,
+           (double)durationUs / 1000.0, stats.txBytes, stats.txMismatches, stats.txExtraBytes,
+           stats.rxBytes, gUrcCount, urcCount, stats.complete ? "" : ", incomplete");
+    if (!ok || (stats.txMismatches > 0) || (stats.txExtraBytes > 0) || !stats.complete ||
+        (gUrcCount != urcCount)) {
+        printf("  ERROR: replay differs from capture (first TX mismatch at %lld)\n",
+               (long long)stats.firstMismatch);
+        return false;
+    }
+    return true;
+}
+
+// Captured RX as parser and URC dispatch workload, without sending commands
+static bool replayRx(const char *pFileName)
+{
+    uPortUartReplayConfig_t replayConfig;
+    uPortUartReplayStats_t stats;
+
+    memset(&replayConfig, 0, sizeof(replayConfig));
+    replayConfig.maxSpeed = true;
+    replayConfig.rxOnly = true;
+    uPortUartReplayConfigure(&replayConfig);
+    if (!clientOpen(pFileName, &gUPortUartReplayOps, 0)) {
+        return false;
+    }
+    gUrcCount = 0;
+    uCxAtClientSetUrcCallback(&gClient, urcCallback, NULL);
+    int64_t start = benchGetTimeNs();
+    do {
+        uCxAtClientHandleRx(&gClient);
+        uPortUartReplayGetStats(gClient.uartHandle, &stats);
+    } while (!stats.complete);
+    int64_t elapsed = benchGetTimeNs() - start;
+    clientClose();
+
+    benchPrintResult("replay_rx_workload", gUrcCount, stats.rxBytes, elapsed);
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    char fileName[] = "/tmp/replay_benchmark_XXXXXX";
+    uint64_t durationUs = 0;
+    size_t urcCount = 0;
+    bool ok;
+
+    uCxLogDisable();
+    uPortInit();
+    if (argc > 1) {
+        ok = replayRx(argv[1]);
+        uPortDeinit();
+        return ok ? 0 : 1;
+    }
+
+    for (size_t i = 0; i < sizeof(gData); i++) {
+        gData[i] = (uint8_t)i;
+    }
+    int fd = mkstemp(fileName);
+    if (fd < 0) {
+        printf("Failed to create capture file\n");
+        return 1;
+    }
+    close(fd);
+    ok = capture(fileName, &urcCount) &&
+         readCapture(fileName, &durationUs) &&
+         replay(fileName, true, urcCount, durationUs) &&
+         replay(fileName, false, urcCount, durationUs) &&
+         replayRx(fileName);
+    unlink(fileName);
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
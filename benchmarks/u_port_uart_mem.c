@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief In-memory UART port used by the benchmarks
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "u_port_uart_mem.h"
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    const uint8_t *pRxData;
+    size_t rxLength;
+    size_t rxPos;
+    size_t txCount;
+    uPortUartMemTxCallback_t txCallback;
+    void *pTxCallbackArg;
+} uPortUartMem_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uPortUartMem_t gUartMem;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+void uPortUartMemSetRxData(const void *pData, size_t length)
+{
+    gUartMem.pRxData = (const uint8_t *)pData;
+    gUartMem.rxLength = length;
+    gUartMem.rxPos = 0;
+}
+
+void uPortUartMemSetTxCallback(uPortUartMemTxCallback_t callback, void *pArg)
+{
+    gUartMem.txCallback = callback;
+    gUartMem.pTxCallbackArg = pArg;
+}
+
+size_t uPortUartMemGetTxCount(void)
+{
+    return gUartMem.txCount;
+}
+
+uPortUartHandle_t uPortUartOpen(const char *pDevName, int32_t baudRate, bool useFlowControl)
+{
+    return uPortUartOpenEx(pDevName, baudRate, useFlowControl, 0);
+}
+
+uPortUartHandle_t uPortUartOpenEx(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    (void)flags;
+    (void)pDevName;
+    (void)baudRate;
+    (void)useFlowControl;
+    memset(&gUartMem, 0, sizeof(gUartMem));
+    return &gUartMem;
+}
+
+void uPortUartClose(uPortUartHandle_t handle)
+{
+    (void)handle;
+}
+
+int32_t uPortUartWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    uPortUartMem_t *pUart = (uPortUartMem_t *)handle;
+    pUart->txCount += length;
+    if (pUart->txCallback != NULL) {
+        pUart->txCallback((const uint8_t *)pData, length, pUart->pTxCallbackArg);
+    }
+    return (int32_t)length;
+}
+
+int32_t uPortUartRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    uPortUartMem_t *pUart = (uPortUartMem_t *)handle;
+    size_t available = pUart->rxLength - pUart->rxPos;
+    (void)timeoutMs;
+    if (length > available) {
+        length = available;
+    }
+    memcpy(pData, &pUart->pRxData[pUart->rxPos], length);
+    pUart->rxPos += length;
+    return (int32_t)length;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief In-memory UART port used by the benchmarks
+ *
+ * uPortUartRead() returns data from a buffer set with uPortUartMemSetRxData()
+ * and returns 0 (timeout) when all data has been read. Written data is passed
+ * to the callback set with uPortUartMemSetTxCallback(), if any, and otherwise
+ * discarded.
+ */
+
+#ifndef U_PORT_UART_MEM_H
+#define U_PORT_UART_MEM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "u_port_uart.h"
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/**
+ * Callback for data written with uPortUartWrite(). Can be used for
+ * implementing a peer that responds using uPortUartMemSetRxData().
+ */
+typedef void (*uPortUartMemTxCallback_t)(const uint8_t *pData, size_t length, void *pArg);
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+  * @brief  Set the data that will be returned by uPortUartRead()
+  *
+  * @param[in]  pData:   the RX data (must be valid until it has been read).
+  * @param      length:  the length of pData.
+  */
+void uPortUartMemSetRxData(const void *pData, size_t length);
+
+/**
+  * @brief  Set a callback for data written with uPortUartWrite()
+  *
+  * Must be called after uPortUartOpen().
+  *
+  * @param  callback:  the callback or NULL to discard written data.
+  * @param  pArg:      user pointer passed to the callback.
+  */
+void uPortUartMemSetTxCallback(uPortUartMemTxCallback_t callback, void *pArg);
+
+/**
+  * @brief  Get the number of bytes written with uPortUartWrite()
+  */
+size_t uPortUartMemGetTxCount(void);
+
+#endif // U_PORT_UART_MEM_H
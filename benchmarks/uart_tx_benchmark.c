@@ -0,0 +1,235 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief UART TX path benchmark
+ *
+ * Writes a stream of small chunks (like the AT client does when sending a
+ * command) at half the link rate to a PTY whose other end is drained at a
+ * simulated baud rate, once with blocking writes and once with
+ * U_PORT_UART_FLAG_TX_QUEUE. The time the caller spends in uPortUartWrite()
+ * is reported, and for the TX queue how many write() calls the writer
+ * thread needed for all the small writes.
+ *
+ * Usage: uart_tx_benchmark [baudrate] [chunk_size]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "u_port.h"
+#include "uart/u_port_uart_linux.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define TOTAL_BYTES         (64 * 1024)
+#define DEFAULT_BAUDRATE    921600
+#define DEFAULT_CHUNK_SIZE  32
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    int masterFd;
+    int slaveFd;
+    char devName[64];
+    pthread_t thread;
+    int32_t baudRate;
+    size_t rxBytes;
+} ptySink_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uint8_t gData[TOTAL_BYTES];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Reads from the master side no faster than the simulated link
+static void *sinkThread(void *pArg)
+{
+    ptySink_t *pSink = (ptySink_t *)pArg;
+    int64_t linkTime = benchGetTimeNs();
+
+    while (pSink->rxBytes < TOTAL_BYTES) {
+        struct pollfd pfd = { .fd = pSink->masterFd, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, 5000) <= 0) {
+            break;
+        }
+        uint8_t buf[256];
+        ssize_t count = read(pSink->masterFd, buf, sizeof(buf));
+        if (count <= 0) {
+            break;
+        }
+        pSink->rxBytes += (size_t)count;
+        int64_t now = benchGetTimeNs();
+        if (linkTime < now) {
+            linkTime = now;
+        }
+        linkTime += (int64_t)count * 10 * 1000000000 / pSink->baudRate;
+        int64_t sleepNs = linkTime - now;
+        struct timespec ts = { .tv_sec = (time_t)(sleepNs / 1000000000),
+                               .tv_nsec = (long)(sleepNs % 1000000000) };
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static const char *sinkStart(ptySink_t *pSink, int32_t baudRate)
+{
+    memset(pSink, 0, sizeof(ptySink_t));
+    pSink->baudRate = baudRate;
+    pSink->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pSink->masterFd < 0) {
+        return NULL;
+    }
+    struct termios tty;
+    if ((grantpt(pSink->masterFd) != 0) || (unlockpt(pSink->masterFd) != 0) ||
+        (ptsname_r(pSink->masterFd, pSink->devName, sizeof(pSink->devName)) != 0) ||
+        ((pSink->slaveFd = open(pSink->devName, O_RDWR | O_NOCTTY)) < 0)) {
+        close(pSink->masterFd);
+        return NULL;
+    }
+    // Raw mode so that the data isn't touched by the line discipline
+    tcgetattr(pSink->slaveFd, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(pSink->slaveFd, TCSANOW, &tty);
+    if (pthread_create(&pSink->thread, NULL, sinkThread, pSink) != 0) {
+        close(pSink->slaveFd);
+        close(pSink->masterFd);
+        return NULL;
+    }
+    return pSink->devName;
+}
+
+static size_t sinkWait(ptySink_t *pSink)
+{
+    pthread_join(pSink->thread, NULL);
+    close(pSink->slaveFd);
+    close(pSink->masterFd);
+    return pSink->rxBytes;
+}
+
+static bool benchWrite(const char *pName, int32_t baudRate, size_t chunkSize, uint32_t flags)
+{
+    ptySink_t sink;
+    int64_t callerNs = 0;
+    int64_t maxCallNs = 0;
+    size_t written = 0;
+
+    const char *pDevName = sinkStart(&sink, baudRate);
+    if (pDevName == NULL) {
+        printf("  %s: failed to create PTY\n", pName);
+        return false;
+    }
+    uPortUartHandle_t handle = uPortUartOpenEx(pDevName, baudRate, false, flags);
+    if (handle == NULL) {
+        printf("  %s: failed to open %s\n", pName, pDevName);
+        sinkWait(&sink);
+        return false;
+    }
+
+    int64_t start = benchGetTimeNs();
+    while (written < TOTAL_BYTES) {
+        // Produce at half the link rate
+        int64_t aheadNs = ((int64_t)written * 2 * 10 * 1000000000 / baudRate) -
+                          (benchGetTimeNs() - start);
+        if (aheadNs > 1000000) {
+            struct timespec ts = { .tv_sec = (time_t)(aheadNs / 1000000000),
+                                   .tv_nsec = (long)(aheadNs % 1000000000) };
+            nanosleep(&ts, NULL);
+        }
+        size_t length = TOTAL_BYTES - written;
+        if (length > chunkSize) {
+            length = chunkSize;
+        }
+        int64_t callStart = benchGetTimeNs();
+        int32_t ret = uPortUartWrite(handle, &gData[written], length);
+        int64_t callNs = benchGetTimeNs() - callStart;
+        callerNs += callNs;
+        if (callNs > maxCallNs) {
+            maxCallNs = callNs;
+        }
+        if (ret < 0) {
+            break;
+        }
+        written += (size_t)ret;
+    }
+    uPortUartTxStats_t stats;
+    bool hasStats = (uPortUartGetTxStats(handle, &stats) == 0);
+    uPortUartClose(handle);
+    size_t received = sinkWait(&sink);
+    int64_t elapsed = benchGetTimeNs() - start;
+
+    benchPrintResult(pName, 1, TOTAL_BYTES, elapsed);
+    printf("  %s: %.2f us per uPortUartWrite(), longest %.2f ms\n", pName,
+           (double)callerNs / 1000.0 / (double)((TOTAL_BYTES + chunkSize - 1) / chunkSize),
+           (double)maxCallNs / 1e6);
+    if (hasStats) {
+        printf("  %s: %u writes merged into %u write() calls, max depth %zu of %zu, "
+               "%u full, %u timeouts\n", pName, stats.enqueueCount, stats.writeCount,
+               stats.maxQueued, stats.capacity, stats.fullCount, stats.timeoutCount);
+    }
+    if (received != TOTAL_BYTES) {
+        printf("  ERROR: %zu of %d bytes received\n", received, TOTAL_BYTES);
+        return false;
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    int32_t baudRate = (argc > 1) ? atoi(argv[1]) : DEFAULT_BAUDRATE;
+    size_t chunkSize = (argc > 2) ? (size_t)atoi(argv[2]) : DEFAULT_CHUNK_SIZE;
+    bool ok = true;
+
+    if ((baudRate <= 0) || (chunkSize == 0)) {
+        printf("Usage: %s [baudrate] [chunk_size]\n", argv[0]);
+        return 1;
+    }
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gData); i++) {
+        gData[i] = (uint8_t)i;
+    }
+    ok = benchWrite("uart_tx_blocking", baudRate, chunkSize, 0) && ok;
+    ok = benchWrite("uart_tx_queue", baudRate, chunkSize, U_PORT_UART_FLAG_TX_QUEUE) && ok;
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief XMODEM transfer benchmark
+ *
+ * Sends an image with uCxXmodemSend() to an in-memory XMODEM receiver
+ * stand-in, once in classic XMODEM-1K mode and once in streaming
+ * (XMODEM-G) mode. Besides the host CPU time, the transfer time over a
+ * real link is estimated from the number of bytes sent at the given baud
+ * rate plus one ACK turnaround per block in classic mode.
+ *
+ * Usage: xmodem_benchmark [baudrate] [turnaround_us]
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_xmodem.h"
+#include "u_cx_log.h"
+#include "u_port_uart_mem.h"
+#include "bench_utils.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define IMAGE_SIZE              (1536 * 1024)
+#define DEFAULT_BAUDRATE        921600
+#define DEFAULT_TURNAROUND_US   2000
+
+#define XMODEM_STX              0x02
+#define XMODEM_EOT              0x04
+#define XMODEM_ACK              0x06
+#define XMODEM_NAK              0x15
+#define XMODEM_PACKET_SIZE      (3 + 1024 + 2)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* XMODEM receiver stand-in */
+typedef struct {
+    bool streaming;
+    uint8_t packet[XMODEM_PACKET_SIZE];
+    size_t packetPos;
+    uint8_t response;
+    size_t blockCount;
+    size_t ackCount;
+    size_t errorCount;
+} receiver_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uint8_t gImage[IMAGE_SIZE];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void respond(receiver_t *pReceiver, uint8_t response)
+{
+    pReceiver->response = response;
+    uPortUartMemSetRxData(&pReceiver->response, 1);
+    pReceiver->ackCount++;
+}
+
+static void receiverTx(const uint8_t *pData, size_t length, void *pArg)
+{
+    receiver_t *pReceiver = (receiver_t *)pArg;
+
+    for (size_t i = 0; i < length; i++) {
+        if ((pReceiver->packetPos == 0) && (pData[i] == XMODEM_EOT)) {
+            respond(pReceiver, XMODEM_ACK);
+            continue;
+        }
+        pReceiver->packet[pReceiver->packetPos++] = pData[i];
+        if (pReceiver->packetPos < XMODEM_PACKET_SIZE) {
+            continue;
+        }
+        pReceiver->packetPos = 0;
+        pReceiver->blockCount++;
+        uint16_t crc = uCxXmodemCrc16(0, &pReceiver->packet[3], 1024);
+        bool valid = (pReceiver->packet[0] == XMODEM_STX) &&
+                     (pReceiver->packet[1] == (uint8_t)pReceiver->blockCount) &&
+                     (pReceiver->packet[3 + 1024] == (uint8_t)(crc >> 8)) &&
+                     (pReceiver->packet[3 + 1025] == (uint8_t)crc);
+        if (!valid) {
+            pReceiver->errorCount++;
+        }
+        if (!pReceiver->streaming) {
+            respond(pReceiver, valid ? XMODEM_ACK : XMODEM_NAK);
+        }
+    }
+}
+
+static int32_t imageDataCallback(uint8_t *pBuffer, size_t offset, size_t maxLen, void *pUserData)
+{
+    (void)pUserData;
+    size_t remaining = sizeof(gImage) - offset;
+    size_t len = (maxLen < remaining) ? maxLen : remaining;
+    memcpy(pBuffer, &gImage[offset], len);
+    return (int32_t)len;
+}
+
+static void benchTransfer(bool streaming, size_t iterations, int32_t baudRate, int32_t turnaroundUs)
+{
+    static const uint8_t startClassic = 'C';
+    static const uint8_t startStreaming = 'G';
+    const char *pName = streaming ? "xmodem_g" : "xmodem_1k";
+    uCxXmodemConfig_t config;
+    receiver_t receiver;
+    size_t failCount = 0;
+    int64_t elapsed = 0;
+
+    uCxXmodemInit("mem", &config);
+    config.blockDelayMs = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        memset(&receiver, 0, sizeof(receiver));
+        receiver.streaming = streaming;
+        uCxXmodemOpen(&config, baudRate, true);
+        uPortUartMemSetTxCallback(receiverTx, &receiver);
+        uPortUartMemSetRxData(streaming ? &startStreaming : &startClassic, 1);
+        int64_t start = benchGetTimeNs();
+        int32_t result = uCxXmodemSend(&config, sizeof(gImage), imageDataCallback, NULL, NULL);
+        elapsed += benchGetTimeNs() - start;
+        if ((result != 0) || (receiver.errorCount > 0)) {
+            failCount++;
+        }
+        uCxXmodemClose(&config);
+    }
+    benchPrintResult(pName, iterations, iterations * sizeof(gImage), elapsed);
+
+    // Estimated time on a real link: 10 bits per byte plus ACK turnarounds
+    double txSeconds = (double)uPortUartMemGetTxCount() * 10.0 / (double)baudRate;
+    double ackSeconds = (double)receiver.ackCount * (double)turnaroundUs / 1e6;
+    printf("  %s: estimated %.1f s at %d baud with %d us turnaround (%zu ACKs)\n",
+           pName, txSeconds + ackSeconds, baudRate, turnaroundUs, receiver.ackCount);
+    if (failCount > 0) {
+        printf("  WARNING: %zu transfers failed\n", failCount);
+    }
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t iterations = benchGetIterations(10);
+    int32_t baudRate = (argc > 1) ? atoi(argv[1]) : DEFAULT_BAUDRATE;
+    int32_t turnaroundUs = (argc > 2) ? atoi(argv[2]) : DEFAULT_TURNAROUND_US;
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gImage); i++) {
+        gImage[i] = (uint8_t)((i * 131) + 7);
+    }
+    benchTransfer(false, iterations, baudRate, turnaroundUs);
+    benchTransfer(true, iterations, baudRate, turnaroundUs);
+    return 0;
+}
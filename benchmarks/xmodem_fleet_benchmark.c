@@ -0,0 +1,141 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Parallel XMODEM firmware upgrade benchmark
+ *
+ * Upgrades 1, 2, 4, ... max_ports simulated modules at the same time with
+ * uCxXmodemFleetSendBuffer(). Every module is an XMODEM receiver stand-in
+ * (xmodem_receiver.c) on its own PTY. With perfect scaling the wall time
+ * stays the same as for a single port.
+ *
+ * Usage: xmodem_fleet_benchmark [max_ports] [baudrate] [ack_latency_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_xmodem_fleet.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+#include "xmodem_receiver.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define IMAGE_SIZE              (128 * 1024)
+#define MAX_PORTS               64
+#define DEFAULT_MAX_PORTS       8
+#define DEFAULT_BAUDRATE        921600
+#define DEFAULT_ACK_LATENCY_US  2000
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uint8_t gImage[IMAGE_SIZE];
+static xmodemReceiver_t gReceivers[MAX_PORTS];
+static uCxXmodemFleetPort_t gPorts[MAX_PORTS];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static bool benchFleet(size_t numPorts, int32_t baudRate, int32_t ackLatencyUs, int64_t *pElapsedNs)
+{
+    xmodemReceiverConfig_t rxConfig;
+    uCxXmodemFleetConfig_t config;
+    char name[32];
+    bool ok = true;
+
+    memset(&rxConfig, 0, sizeof(rxConfig));
+    rxConfig.baudRate = baudRate;
+    rxConfig.ackLatencyUs = ackLatencyUs;
+    for (size_t i = 0; i < numPorts; i++) {
+        gPorts[i].pUartDevName = xmodemReceiverStart(&gReceivers[i], &rxConfig);
+        if (gPorts[i].pUartDevName == NULL) {
+            printf("  failed to create PTY %zu\n", i);
+            for (size_t j = 0; j < i; j++) {
+                xmodemReceiverWait(&gReceivers[j], NULL);
+            }
+            return false;
+        }
+    }
+
+    uCxXmodemFleetInit(&config, baudRate);
+    // The receiver stand-in models the flash write time. A PTY write blocks when the
+    // receiver falls behind, which paces XMODEM-G like hardware flow control would.
+    config.blockDelayMs = 0;
+    config.maxAttempts = 1;
+
+    int64_t start = benchGetTimeNs();
+    int32_t numFailed = uCxXmodemFleetSendBuffer(&config, gImage, sizeof(gImage), gPorts, numPorts);
+    *pElapsedNs = benchGetTimeNs() - start;
+
+    for (size_t i = 0; i < numPorts; i++) {
+        xmodemReceiverStats_t stats;
+        xmodemReceiverWait(&gReceivers[i], &stats);
+        if (!stats.completed || (stats.errorCount > 0)) {
+            ok = false;
+        }
+    }
+    snprintf(name, sizeof(name), "fleet_%zu_ports", numPorts);
+    benchPrintResult(name, 1, numPorts * sizeof(gImage), *pElapsedNs);
+    if ((numFailed != 0) || !ok) {
+        printf("  ERROR: %d of %zu ports failed\n", numFailed, numPorts);
+        return false;
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t maxPorts = (argc > 1) ? (size_t)atoi(argv[1]) : DEFAULT_MAX_PORTS;
+    int32_t baudRate = (argc > 2) ? atoi(argv[2]) : DEFAULT_BAUDRATE;
+    int32_t ackLatencyUs = (argc > 3) ? atoi(argv[3]) : DEFAULT_ACK_LATENCY_US;
+    int64_t singleNs = 0;
+    bool ok = true;
+
+    if ((maxPorts == 0) || (maxPorts > MAX_PORTS)) {
+        printf("max_ports must be 1-%d\n", MAX_PORTS);
+        return 1;
+    }
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gImage); i++) {
+        gImage[i] = (uint8_t)((i * 131) + 7);
+    }
+    for (size_t numPorts = 1; ok && (numPorts <= maxPorts); numPorts *= 2) {
+        int64_t elapsed = 0;
+        ok = benchFleet(numPorts, baudRate, ackLatencyUs, &elapsed);
+        if (numPorts == 1) {
+            singleNs = elapsed;
+        }
+        // Wall time of one port compared with the wall time of all ports in parallel
+        printf("  %zu ports: %.2f s, %.0f%% of linear scaling\n", numPorts,
+               (double)elapsed / 1e9, 100.0 * (double)singleNs / (double)elapsed);
+    }
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief XMODEM firmware upload throughput benchmark over a PTY
+ *
+ * Uploads a synthetic firmware image with uCxXmodemSend() through the
+ * Linux UART port to the XMODEM receiver stand-in (xmodem_receiver.c),
+ * once in XMODEM-1K mode and once in streaming (XMODEM-G) mode. The
+ * receiver simulates the link baud rate and the ACK latency of the module
+ * so the measured wall clock time is comparable to a real upload.
+ *
+ * The received image is verified and the process exits with a non-zero
+ * status if a transfer fails or if the link utilization is below
+ * min_efficiency percent, which makes the benchmark usable in CI.
+ *
+ * The CPU time of the sending thread is also reported. Most of the upload
+ * is spent waiting for the link, so it should be a small fraction of the
+ * wall clock time.
+ *
+ * Usage: xmodem_pty_benchmark [baudrate] [ack_latency_us] [nak_every] [min_efficiency]
+ * The number of iterations can be set with the BENCH_ITERATIONS environment variable.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "u_cx_xmodem.h"
+#include "u_cx_log.h"
+#include "bench_utils.h"
+#include "xmodem_receiver.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define IMAGE_SIZE              (256 * 1024)
+#define DEFAULT_BAUDRATE        921600
+#define DEFAULT_ACK_LATENCY_US  2000
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uint8_t gImage[IMAGE_SIZE];
+static uint8_t gRxImage[IMAGE_SIZE + 1024];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static int32_t imageDataCallback(uint8_t *pBuffer, size_t offset, size_t maxLen, void *pUserData)
+{
+    (void)pUserData;
+    size_t remaining = sizeof(gImage) - offset;
+    size_t len = (maxLen < remaining) ? maxLen : remaining;
+    memcpy(pBuffer, &gImage[offset], len);
+    return (int32_t)len;
+}
+
+static bool benchUpload(bool streaming, size_t iterations, const xmodemReceiverConfig_t *pRxConfig,
+                        double minEfficiency)
+{
+    const char *pName = streaming ? "pty_xmodem_g" : "pty_xmodem_1k";
+    xmodemReceiverConfig_t rxConfig = *pRxConfig;
+    xmodemReceiver_t receiver;
+    xmodemReceiverStats_t stats;
+    uCxXmodemConfig_t config;
+    size_t failCount = 0;
+    size_t nakCount = 0;
+    int64_t elapsed = 0;
+    int64_t cpuTime = 0;
+
+    rxConfig.streaming = streaming;
+    rxConfig.pImage = gRxImage;
+    rxConfig.imageSize = sizeof(gRxImage);
+    for (size_t i = 0; i < iterations; i++) {
+        const char *pDevName = xmodemReceiverStart(&receiver, &rxConfig);
+        if (pDevName == NULL) {
+            printf("  %s: failed to create PTY\n", pName);
+            return false;
+        }
+        uCxXmodemInit(pDevName, &config);
+        // The receiver stand-in models the flash write time with its ACK latency
+        config.blockDelayMs = 0;
+        int64_t start = benchGetTimeNs();
+        int64_t cpuStart = benchGetThreadCpuTimeNs();
+        int32_t result = -1;
+        // XMODEM-G is only used with flow control. A PTY write blocks when the receiver
+        // falls behind, which paces the blocks like hardware flow control would.
+        if (uCxXmodemOpen(&config, pRxConfig->baudRate, streaming) == 0) {
+            result = uCxXmodemSend(&config, sizeof(gImage), imageDataCallback, NULL, NULL);
+            uCxXmodemClose(&config);
+        }
+        cpuTime += benchGetThreadCpuTimeNs() - cpuStart;
+        xmodemReceiverWait(&receiver, &stats);
+        elapsed += benchGetTimeNs() - start;
+        nakCount += stats.nakCount;
+        if ((result != 0) || !stats.completed || (stats.errorCount > 0) ||
+            (stats.imageLength < sizeof(gImage)) ||
+            (memcmp(gRxImage, gImage, sizeof(gImage)) != 0)) {
+            failCount++;
+        }
+    }
+    benchPrintResult(pName, iterations, iterations * sizeof(gImage), elapsed);
+
+    // Payload throughput compared with the raw link rate (10 bits per byte)
+    double seconds = (double)elapsed / 1e9;
+    double throughput = (double)(iterations * sizeof(gImage)) / seconds;
+    double efficiency = 100.0 * throughput / ((double)pRxConfig->baudRate / 10.0);
+    printf("  %s: %.1f kB/s, %.1f%% of %d baud (%zu NAKs)\n",
+           pName, throughput / 1024.0, efficiency, pRxConfig->baudRate, nakCount);
+    printf("  %s: sender CPU time %.1f%% of wall time\n",
+           pName, 100.0 * (double)cpuTime / (double)elapsed);
+    if (failCount > 0) {
+        printf("  ERROR: %zu transfers failed\n", failCount);
+        return false;
+    }
+    if (efficiency < minEfficiency) {
+        printf("  ERROR: link utilization below %.1f%%\n", minEfficiency);
+        return false;
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    size_t iterations = benchGetIterations(1);
+    xmodemReceiverConfig_t rxConfig;
+    double minEfficiency = (argc > 4) ? atof(argv[4]) : 0.0;
+    bool ok = true;
+
+    memset(&rxConfig, 0, sizeof(rxConfig));
+    rxConfig.baudRate = (argc > 1) ? atoi(argv[1]) : DEFAULT_BAUDRATE;
+    rxConfig.ackLatencyUs = (argc > 2) ? atoi(argv[2]) : DEFAULT_ACK_LATENCY_US;
+    rxConfig.nakEvery = (argc > 3) ? atoi(argv[3]) : 0;
+
+    uCxLogDisable();
+    uPortInit();
+    for (size_t i = 0; i < sizeof(gImage); i++) {
+        gImage[i] = (uint8_t)((i * 131) + 7);
+    }
+    ok = benchUpload(false, iterations, &rxConfig, minEfficiency) && ok;
+    ok = benchUpload(true, iterations, &rxConfig, minEfficiency) && ok;
+    uPortDeinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief XMODEM receiver stand-in running on the master side of a PTY
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+
+#include "u_cx_xmodem.h"
+#include "xmodem_receiver.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define XMODEM_SOH              0x01
+#define XMODEM_STX              0x02
+#define XMODEM_EOT              0x04
+#define XMODEM_ACK              0x06
+#define XMODEM_NAK              0x15
+#define XMODEM_CAN              0x18
+
+#define XMODEM_HEADER_SIZE      3
+#define XMODEM_CRC_SIZE         2
+#define XMODEM_PACKET_MAX_SIZE  (XMODEM_HEADER_SIZE + 1024 + XMODEM_CRC_SIZE)
+
+/* Interval for repeating the start character until the sender responds */
+#define START_INTERVAL_MS       1000
+/* The receiver gives up when nothing has been received for this long */
+#define IDLE_TIMEOUT_MS         10000
+/* Max bytes consumed at a time, keeps the simulated baud rate smooth */
+#define READ_CHUNK_SIZE         32
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static int64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+static void sleepNs(int64_t ns)
+{
+    if (ns > 0) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)(ns / 1000000000);
+        ts.tv_nsec = (long)(ns % 1000000000);
+        while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR)) {
+        }
+    }
+}
+
+static void sendByte(xmodemReceiver_t *pReceiver, uint8_t byte)
+{
+    while ((write(pReceiver->masterFd, &byte, 1) < 0) && (errno == EINTR)) {
+    }
+}
+
+static void respond(xmodemReceiver_t *pReceiver, uint8_t response)
+{
+    if (response == XMODEM_ACK) {
+        sleepNs((int64_t)pReceiver->config.ackLatencyUs * 1000);
+        pReceiver->stats.ackCount++;
+    } else {
+        pReceiver->stats.nakCount++;
+    }
+    sendByte(pReceiver, response);
+}
+
+static size_t packetSize(uint8_t header)
+{
+    if (header == XMODEM_SOH) {
+        return XMODEM_HEADER_SIZE + 128 + XMODEM_CRC_SIZE;
+    } else if (header == XMODEM_STX) {
+        return XMODEM_PACKET_MAX_SIZE;
+    }
+    return 0;
+}
+
+/* Handle a complete packet. Returns false if the transfer must be aborted. */
+static bool handlePacket(xmodemReceiver_t *pReceiver, const uint8_t *pPacket, size_t length,
+                         uint8_t *pExpectedBlock, bool *pNakInjected)
+{
+    xmodemReceiverStats_t *pStats = &pReceiver->stats;
+    const xmodemReceiverConfig_t *pConfig = &pReceiver->config;
+    size_t payloadLen = length - XMODEM_HEADER_SIZE - XMODEM_CRC_SIZE;
+    const uint8_t *pPayload = &pPacket[XMODEM_HEADER_SIZE];
+    uint16_t crc = uCxXmodemCrc16(0, pPayload, payloadLen);
+    bool valid = ((uint8_t)(pPacket[1] + pPacket[2]) == 0xFF) &&
+                 (pPayload[payloadLen] == (uint8_t)(crc >> 8)) &&
+                 (pPayload[payloadLen + 1] == (uint8_t)crc);
+
+    if (valid && (pPacket[1] == (uint8_t)(*pExpectedBlock - 1)) && !pConfig->streaming) {
+        // Retransmission of a block we already have (our ACK was lost)
+        respond(pReceiver, XMODEM_ACK);
+        return true;
+    }
+    if (!valid || (pPacket[1] != *pExpectedBlock)) {
+        pStats->errorCount++;
+        if (pConfig->streaming) {
+            // XMODEM-G has no retransmission
+            sendByte(pReceiver, XMODEM_CAN);
+            sendByte(pReceiver, XMODEM_CAN);
+            return false;
+        }
+        respond(pReceiver, XMODEM_NAK);
+        return true;
+    }
+    if (!pConfig->streaming && (pConfig->nakEvery > 0) && !*pNakInjected &&
+        (((pStats->blockCount + 1) % (size_t)pConfig->nakEvery) == 0)) {
+        *pNakInjected = true;
+        respond(pReceiver, XMODEM_NAK);
+        return true;
+    }
+
+    *pNakInjected = false;
+    if ((pConfig->pImage != NULL) && (pStats->imageLength + payloadLen <= pConfig->imageSize)) {
+        memcpy(&pConfig->pImage[pStats->imageLength], pPayload, payloadLen);
+    }
+    pStats->imageLength += payloadLen;
+    pStats->blockCount++;
+    (*pExpectedBlock)++;
+    if (!pConfig->streaming) {
+        respond(pReceiver, XMODEM_ACK);
+    }
+    return true;
+}
+
+static void *receiverThread(void *pArg)
+{
+    xmodemReceiver_t *pReceiver = (xmodemReceiver_t *)pArg;
+    xmodemReceiverStats_t *pStats = &pReceiver->stats;
+    uint8_t startChar = pReceiver->config.streaming ? 'G' : 'C';
+    uint8_t packet[XMODEM_PACKET_MAX_SIZE];
+    size_t packetPos = 0;
+    size_t expectedSize = 0;
+    uint8_t expectedBlock = 1;
+    bool nakInjected = false;
+    bool started = false;
+    bool running = true;
+    int64_t linkTime = 0;
+    int64_t lastStartTime = 0;
+    int64_t lastRxTime = getTimeNs();
+
+    while (running) {
+        int64_t now = getTimeNs();
+        if (!started && ((lastStartTime == 0) ||
+                         (now - lastStartTime >= (int64_t)START_INTERVAL_MS * 1000000))) {
+            sendByte(pReceiver, startChar);
+            lastStartTime = now;
+        }
+        if (now - lastRxTime >= (int64_t)IDLE_TIMEOUT_MS * 1000000) {
+            break;
+        }
+
+        // Data that is already queued in the PTY when the previous chunk has
+        // been handled arrives back to back on the link
+        struct pollfd pfd = { .fd = pReceiver->masterFd, .events = POLLIN, .revents = 0 };
+        bool queued = (poll(&pfd, 1, 0) > 0);
+        if (!queued && (poll(&pfd, 1, 100) <= 0)) {
+            continue;
+        }
+        uint8_t buffer[READ_CHUNK_SIZE];
+        ssize_t count = read(pReceiver->masterFd, buffer, sizeof(buffer));
+        if (count <= 0) {
+            continue;
+        }
+        started = true;
+        lastRxTime = getTimeNs();
+        pStats->rxBytes += (size_t)count;
+
+        // Simulate the baud rate: the bytes are not handled before they would
+        // have been completely received over the link
+        if (pReceiver->config.baudRate > 0) {
+            if (!queued || (linkTime == 0)) {
+                linkTime = lastRxTime;
+            }
+            linkTime += (int64_t)count * 10 * 1000000000 / pReceiver->config.baudRate;
+            sleepNs(linkTime - lastRxTime);
+        }
+
+        for (size_t i = 0; running && (i < (size_t)count); i++) {
+            uint8_t byte = buffer[i];
+            if (packetPos == 0) {
+                if (byte == XMODEM_EOT) {
+                    respond(pReceiver, XMODEM_ACK);
+                    pStats->completed = true;
+                    running = false;
+                } else if (byte == XMODEM_CAN) {
+                    running = false;
+                } else {
+                    // Anything but a packet header is line noise and ignored
+                    expectedSize = packetSize(byte);
+                    if (expectedSize > 0) {
+                        packet[packetPos++] = byte;
+                    }
+                }
+                continue;
+            }
+            packet[packetPos++] = byte;
+            if (packetPos == expectedSize) {
+                running = handlePacket(pReceiver, packet, packetPos, &expectedBlock, &nakInjected);
+                packetPos = 0;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+const char *xmodemReceiverStart(xmodemReceiver_t *pReceiver, const xmodemReceiverConfig_t *pConfig)
+{
+    memset(pReceiver, 0, sizeof(xmodemReceiver_t));
+    pReceiver->config = *pConfig;
+    pReceiver->slaveFd = -1;
+
+    pReceiver->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pReceiver->masterFd < 0) {
+        return NULL;
+    }
+    if ((grantpt(pReceiver->masterFd) != 0) || (unlockpt(pReceiver->masterFd) != 0) ||
+        (ptsname_r(pReceiver->masterFd, pReceiver->devName, sizeof(pReceiver->devName)) != 0)) {
+        close(pReceiver->masterFd);
+        return NULL;
+    }
+
+    // Keep the slave open so that the PTY stays usable while the sender
+    // opens and closes it, and make it raw right away so that nothing
+    // written by the receiver is echoed back before the sender is ready
+    pReceiver->slaveFd = open(pReceiver->devName, O_RDWR | O_NOCTTY);
+    struct termios tty;
+    if ((pReceiver->slaveFd < 0) || (tcgetattr(pReceiver->slaveFd, &tty) != 0)) {
+        xmodemReceiverWait(pReceiver, NULL);
+        return NULL;
+    }
+    cfmakeraw(&tty);
+    if ((tcsetattr(pReceiver->slaveFd, TCSANOW, &tty) != 0) ||
+        (pthread_create(&pReceiver->thread, NULL, receiverThread, pReceiver) != 0)) {
+        pReceiver->thread = 0;
+        xmodemReceiverWait(pReceiver, NULL);
+        return NULL;
+    }
+
+    return pReceiver->devName;
+}
+
+void xmodemReceiverWait(xmodemReceiver_t *pReceiver, xmodemReceiverStats_t *pStats)
+{
+    if (pReceiver->thread != 0) {
+        pthread_join(pReceiver->thread, NULL);
+        pReceiver->thread = 0;
+    }
+    if (pReceiver->slaveFd >= 0) {
+        close(pReceiver->slaveFd);
+        pReceiver->slaveFd = -1;
+    }
+    if (pReceiver->masterFd >= 0) {
+        close(pReceiver->masterFd);
+        pReceiver->masterFd = -1;
+    }
+    if (pStats != NULL) {
+        *pStats = pReceiver->stats;
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief XMODEM receiver stand-in running on the master side of a PTY
+ *
+ * Makes it possible to run uCxXmodemSend() through the real Linux UART
+ * port without a module in bootloader mode. The sender opens the PTY
+ * slave device returned by xmodemReceiverStart() as if it was a serial
+ * port. The receiver supports XMODEM (128 byte blocks), XMODEM-1K and
+ * XMODEM-G and can simulate the link baud rate, the time the module
+ * needs before ACKing a block and NAKed blocks.
+ */
+
+#ifndef XMODEM_RECEIVER_H
+#define XMODEM_RECEIVER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    int32_t baudRate;       /**< Simulated link baud rate (0 = unlimited) */
+    int32_t ackLatencyUs;   /**< Delay before ACKing each block (e.g. flash write time) */
+    int32_t nakEvery;       /**< NAK the first attempt of every Nth block (0 = never) */
+    bool streaming;         /**< Request XMODEM-G ('G') instead of XMODEM-CRC ('C') */
+    uint8_t *pImage;        /**< Buffer for the received data (may be NULL) */
+    size_t imageSize;       /**< Size of pImage */
+} xmodemReceiverConfig_t;
+
+typedef struct {
+    size_t blockCount;      /**< Number of accepted blocks */
+    size_t nakCount;        /**< Number of NAKs sent (injected and for bad blocks) */
+    size_t ackCount;        /**< Number of ACKs sent, including the one for EOT */
+    size_t errorCount;      /**< Number of blocks with bad header or CRC */
+    size_t rxBytes;         /**< Total number of bytes received from the sender */
+    size_t imageLength;     /**< Number of payload bytes received (including padding) */
+    bool completed;         /**< true if the transfer was ended with EOT */
+} xmodemReceiverStats_t;
+
+typedef struct {
+    xmodemReceiverConfig_t config;
+    xmodemReceiverStats_t stats;
+    int masterFd;
+    int slaveFd;
+    char devName[64];
+    pthread_t thread;
+} xmodemReceiver_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+  * @brief  Create a PTY pair and start the receiver thread
+  *
+  * The receiver starts requesting the transfer right away and stops when
+  * the sender ends it with EOT, when the transfer is cancelled or when
+  * nothing has been received for a few seconds.
+  *
+  * @param[out] pReceiver:  receiver instance.
+  * @param[in]  pConfig:    receiver configuration.
+  * @return                 the PTY slave device name for uPortUartOpen() or
+  *                         NULL on failure.
+  */
+const char *xmodemReceiverStart(xmodemReceiver_t *pReceiver, const xmodemReceiverConfig_t *pConfig);
+
+/**
+  * @brief  Wait for the receiver to finish and release the PTY pair
+  *
+  * @param[in]  pReceiver:  receiver instance.
+  * @param[out] pStats:     transfer statistics.
+  */
+void xmodemReceiverWait(xmodemReceiver_t *pReceiver, xmodemReceiverStats_t *pStats);
+
+#endif // XMODEM_RECEIVER_H
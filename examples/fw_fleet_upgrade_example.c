@@ -0,0 +1,193 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Example of how to upgrade the firmware of several modules in parallel
+ *
+ * Each module is put in bootloader mode with AT+USYFWUS and then the same
+ * firmware image is sent to all modules at the same time with
+ * uCxXmodemFleetSendFile().
+ *
+ * Execute with following args:
+ * fw_fleet_upgrade_example <firmware_file> <uart_device> [<uart_device> ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "u_cx.h"
+#include "u_cx_system.h"
+#include "u_cx_general.h"
+#include "u_cx_xmodem_fleet.h"
+#include "u_cx_log.h"
+#include "example_utils.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define AT_BAUD             115200
+#define FW_UPGRADE_BAUD     921600
+#define FW_UPGRADE_TIMEOUT  15000
+#define MAX_PORTS           32
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* AT client used for putting one module in bootloader mode */
+typedef struct {
+    char rxBuf[U_EXAMPLE_AT_RX_BUFFER_SIZE];
+    char urcBuf[U_EXAMPLE_AT_RX_BUFFER_SIZE];
+    uCxAtClientConfig_t config;
+    uCxAtClient_t client;
+} ExamplePort_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static ExamplePort_t gExamplePorts[MAX_PORTS];
+static uCxXmodemFleetPort_t gPorts[MAX_PORTS];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+ * Prepare callback - puts the module in bootloader mode
+ */
+static int32_t enterBootloader(size_t portIndex, const char *pUartDevName, int32_t attempt, void *pUserData)
+{
+    ExamplePort_t *pPort = &gExamplePorts[portIndex];
+    uCxHandle_t ucxHandle;
+    int32_t result;
+
+    (void)pUserData;
+    memset(&pPort->config, 0, sizeof(pPort->config));
+    pPort->config.pRxBuffer = pPort->rxBuf;
+    pPort->config.rxBufferLen = sizeof(pPort->rxBuf);
+    pPort->config.pUrcBuffer = pPort->urcBuf;
+    pPort->config.urcBufferLen = sizeof(pPort->urcBuf);
+    pPort->config.pUartDevName = pUartDevName;
+    uCxAtClientInit(&pPort->config, &pPort->client);
+
+    result = uCxAtClientOpen(&pPort->client, AT_BAUD, true);
+    if (result == 0) {
+        uCxInit(&pPort->client, &ucxHandle);
+        result = uCxGeneralAttention(&ucxHandle);
+        if (result == 0) {
+            result = uCxSystemStartSerialFirmwareUpdate2(&ucxHandle, FW_UPGRADE_BAUD, 1);
+        } else if (attempt > 1) {
+            // A module that doesn't answer on a retry is still in bootloader mode
+            result = 0;
+        }
+        uCxAtClientClose(&pPort->client);
+    }
+    uCxAtClientDeinit(&pPort->client);
+
+    return result;
+}
+
+/**
+ * Progress callback - prints one status line for all ports
+ */
+static void progressCallback(size_t portIndex, const uCxXmodemFleetPort_t *pPorts, void *pUserData)
+{
+    static const char *const stateChars = "-P>*!";
+    size_t numPorts = *(const size_t *)pUserData;
+    size_t fileSize = *((const size_t *)pUserData + 1);
+
+    (void)portIndex;
+    printf("\r");
+    for (size_t i = 0; i < numPorts; i++) {
+        int percent = (int)((pPorts[i].bytesTransferred * 100) / fileSize);
+        printf("[%c%3d%%] ", stateChars[pPorts[i].state], percent);
+    }
+    fflush(stdout);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("Usage: %s <firmware_file> <uart_device> [<uart_device> ...]\n", argv[0]);
+        printf("Example: %s firmware.bin /dev/ttyUSB0 /dev/ttyUSB1\n", argv[0]);
+        return -1;
+    }
+
+    const char *pFirmwareFile = argv[1];
+    size_t numPorts = (size_t)argc - 2;
+    if (numPorts > MAX_PORTS) {
+        printf("ERROR: At most %d ports are supported\n", MAX_PORTS);
+        return -1;
+    }
+    for (size_t i = 0; i < numPorts; i++) {
+        gPorts[i].pUartDevName = argv[i + 2];
+    }
+
+    FILE *pFile = fopen(pFirmwareFile, "rb");
+    if (pFile == NULL) {
+        printf("ERROR: Cannot open file: %s\n", pFirmwareFile);
+        return -1;
+    }
+    fseek(pFile, 0, SEEK_END);
+    long fileSize = ftell(pFile);
+    fclose(pFile);
+    if (fileSize <= 0) {
+        printf("ERROR: Invalid file: %s\n", pFirmwareFile);
+        return -1;
+    }
+    printf("Upgrading %zu modules with %s (%ld bytes)\n", numPorts, pFirmwareFile, fileSize);
+
+    uPortInit();
+
+    // Progress callback user data: number of ports and file size
+    size_t progressInfo[2] = { numPorts, (size_t)fileSize };
+
+    uCxXmodemFleetConfig_t config;
+    uCxXmodemFleetInit(&config, FW_UPGRADE_BAUD);
+    config.timeoutMs = FW_UPGRADE_TIMEOUT;
+    config.prepareCallback = enterBootloader;
+    config.progressCallback = progressCallback;
+    config.pUserData = progressInfo;
+
+    int32_t startTime = uPortGetTickTimeMs();
+    int32_t numFailed = uCxXmodemFleetSendFile(&config, pFirmwareFile, gPorts, numPorts);
+    int32_t elapsedMs = uPortGetTickTimeMs() - startTime;
+    printf("\n");
+
+    if (numFailed < 0) {
+        printf("ERROR: Firmware upgrade could not be started: %d\n", numFailed);
+        uPortDeinit();
+        return -1;
+    }
+
+    for (size_t i = 0; i < numPorts; i++) {
+        printf("%s: %s after %d attempt(s) (%d ms, result %d)\n", gPorts[i].pUartDevName,
+               (gPorts[i].state == U_CX_XMODEM_FLEET_STATE_DONE) ? "upgraded" : "FAILED",
+               gPorts[i].attempts, gPorts[i].elapsedMs, gPorts[i].result);
+    }
+    printf("%zu of %zu modules upgraded in %d ms\n",
+           numPorts - (size_t)numFailed, numPorts, elapsedMs);
+
+    uPortDeinit();
+    return (numFailed == 0) ? 0 : -1;
+}
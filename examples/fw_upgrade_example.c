@@ -18,7 +18,9 @@
  * @brief Example of how to perform firmware upgrade using XMODEM
  *
  * This example demonstrates upgrading module firmware using the
- * AT+USYFWUS command followed by XMODEM protocol transfer.
+ * AT+USYFWUS command followed by XMODEM protocol transfer. Before
+ * starting the upgrade the UART is switched to the highest baud rate
+ * that both the host and the module support.
  *
  * Execute with following args:
  * fw_upgrade_example <uart_device> <firmware_file>
@@ -39,7 +41,7 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
-#define FW_UPGRADE_BAUD     921600
+#define AT_BAUD             115200
 #define FW_UPGRADE_TIMEOUT  15000
 
 #define URC_FLAG_MODULE_STARTED  (1 << 0)
@@ -48,11 +50,6 @@
  * TYPES
  * -------------------------------------------------------------- */
 
-typedef struct {
-    FILE *pFile;
-    size_t fileSize;
-} FirmwareContext_t;
-
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
@@ -87,35 +84,6 @@ static void progressCallback(size_t totalBytes, size_t bytesTransferred, void *p
     }
 }
 
-/**
- * Data callback for XMODEM transfer
- */
-static int32_t firmwareDataCallback(uint8_t *pBuffer, size_t offset, size_t maxLen, void *pUserData)
-{
-    FirmwareContext_t *pCtx = (FirmwareContext_t *)pUserData;
-
-    if (pCtx == NULL || pCtx->pFile == NULL) {
-        return -1;
-    }
-
-    // Check if we've reached end of file
-    if (offset >= pCtx->fileSize) {
-        return 0;
-    }
-
-    // Seek to offset
-    if (fseek(pCtx->pFile, (long)offset, SEEK_SET) != 0) {
-        return -1;
-    }
-
-    // Read data
-    size_t remaining = pCtx->fileSize - offset;
-    size_t toRead = (maxLen < remaining) ? maxLen : remaining;
-    size_t bytesRead = fread(pBuffer, 1, toRead, pCtx->pFile);
-
-    return (int32_t)bytesRead;
-}
-
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -153,19 +121,11 @@ int main(int argc, char **argv)
         return -1;
     }
 
-    // Open firmware file
-    FILE *pFile = fopen(pFirmwareFile, "rb");
-    if (pFile == NULL) {
-        printf("ERROR: Cannot open file: %s\n", pFirmwareFile);
-        return -1;
-    }
-
     printf("Firmware file: %s (%ld bytes)\n", pFirmwareFile, (long)st.st_size);
 
     // Initialize example utilities and AT client
-    uCxAtClient_t *pClient = exampleInit(pUartDev, 115200, true);
+    uCxAtClient_t *pClient = exampleInit(pUartDev, AT_BAUD, true);
     if (pClient == NULL) {
-        fclose(pFile);
         return -1;
     }
 
@@ -183,20 +143,29 @@ int main(int argc, char **argv)
         printf("  - Baud rate is 115200\n");
         uCxAtClientClose(pClient);
         uCxAtClientDeinit(pClient);
-        fclose(pFile);
         return -1;
     }
     printf("Module communication OK\n");
 
+    // Find the highest baud rate that works with this module and UART adapter
+    int32_t fwUpgradeBaud = uCxNegotiateBaudRate(&ucxHandle, AT_BAUD, true, NULL, 0);
+    if (fwUpgradeBaud < 0) {
+        printf("ERROR: Lost connection while switching baud rate: %d\n", fwUpgradeBaud);
+        printf("Reset the module to return to %d baud\n", AT_BAUD);
+        uCxAtClientClose(pClient);
+        uCxAtClientDeinit(pClient);
+        return -1;
+    }
+    printf("Using %d baud\n", fwUpgradeBaud);
+
     printf("Starting firmware upgrade...\n");
 
     // Issue firmware update command to enter bootloader mode
-    result = uCxSystemStartSerialFirmwareUpdate2(&ucxHandle, FW_UPGRADE_BAUD, 1);
+    result = uCxSystemStartSerialFirmwareUpdate2(&ucxHandle, fwUpgradeBaud, 1);
     if (result != 0) {
         printf("ERROR: AT+USYFWUS failed: %d\n", result);
         uCxAtClientClose(pClient);
         uCxAtClientDeinit(pClient);
-        fclose(pFile);
         return -1;
     }
 
@@ -212,35 +181,31 @@ int main(int argc, char **argv)
     xmodemConfig.timeoutMs = FW_UPGRADE_TIMEOUT;
 
     // Open XMODEM UART at firmware upgrade baud rate
-    result = uCxXmodemOpen(&xmodemConfig, FW_UPGRADE_BAUD, true);
+    result = uCxXmodemOpen(&xmodemConfig, fwUpgradeBaud, true);
     if (result != 0) {
         printf("ERROR: Failed to open XMODEM UART: %d\n", result);
-        uCxAtClientOpen(pClient, 115200, false);
-        fclose(pFile);
+        uCxAtClientOpen(pClient, AT_BAUD, false);
         return -1;
     }
 
-    // Set up firmware context
-    FirmwareContext_t fwCtx = {
-        .pFile = pFile,
-        .fileSize = (size_t)st.st_size
-    };
-
-    // Perform XMODEM transfer
+    // Perform XMODEM transfer (the file is memory mapped on POSIX)
     printf("Starting XMODEM transfer...\n");
-    result = uCxXmodemSend(&xmodemConfig, fwCtx.fileSize,
-                          firmwareDataCallback, progressCallback, &fwCtx);
+    size_t fileSize = (size_t)st.st_size;
+    int32_t startTime = uPortGetTickTimeMs();
+    result = uCxXmodemSendFile(&xmodemConfig, pFirmwareFile, progressCallback, NULL);
+    int32_t elapsedMs = uPortGetTickTimeMs() - startTime;
+    if (result == 0) {
+        printf("Transferred %zu bytes in %d ms (%d bytes/s)\n", fileSize, elapsedMs,
+               (elapsedMs > 0) ? (int)((fileSize * 1000) / (size_t)elapsedMs) : 0);
+    }
 
     // Close XMODEM
     uCxXmodemClose(&xmodemConfig);
 
-    // Close firmware file
-    fclose(pFile);
-
     if (result != 0) {
         printf("ERROR: XMODEM transfer failed: %d\n", result);
         // Try to reopen AT client
-        uCxAtClientOpen(pClient, 115200, false);
+        uCxAtClientOpen(pClient, AT_BAUD, false);
         return -1;
     }
 
@@ -250,7 +215,7 @@ int main(int argc, char **argv)
     // Reopen AT client at default baud (module resets to 115200)
     printf("Waiting for module to reboot...\n");
 
-    result = uCxAtClientOpen(pClient, 115200, false);
+    result = uCxAtClientOpen(pClient, AT_BAUD, false);
     if (result != 0) {
         printf("ERROR: Failed to reopen AT client: %d\n", result);
         printf("You may need to power cycle the module.\n");
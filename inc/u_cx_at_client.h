@@ -44,6 +44,23 @@ struct uCxAtClient;
 typedef void (*uUrcCallback_t)(struct uCxAtClient *pClient, void *pTag, char *pLine,
                                size_t lineLength, uint8_t *pBinaryData, size_t binaryDataLen);
 
+/* Called from the RX context when there are URCs waiting in the URC queue.
+ * The executor is expected to call uCxAtClientProcessUrcs() from another
+ * context (e.g. a dispatch thread). */
+typedef void (*uUrcExecutor_t)(struct uCxAtClient *pClient, void *pArg);
+
+typedef struct {
+    size_t queueDepth;          /**< Number of URCs currently waiting in the URC queue. */
+    size_t peakQueueDepth;      /**< Highest number of URCs that has been waiting in the queue. */
+    uint32_t dispatchCount;     /**< Number of URCs dispatched to the URC callback. */
+    uint32_t dropCount;         /**< Number of URCs dropped due to full URC queue (all classes). */
+    size_t coalescedCount;      /**< Number of URCs merged or dropped by the URC coalescing rules. */
+    int32_t maxLatencyMs;       /**< Max time from URC reception to dispatch. */
+    int32_t avgLatencyMs;       /**< Average time from URC reception to dispatch. */
+    size_t classQueueDepth[U_CX_URC_CLASS_COUNT]; /**< Queue depth per URC class. */
+    uint32_t classDropCount[U_CX_URC_CLASS_COUNT]; /**< Dropped URCs per URC class. */
+} uCxAtUrcStats_t;
+
 typedef enum {
     U_CX_BIN_STATE_BINARY_FLUSH,
     U_CX_BIN_STATE_BINARY_RSP,
@@ -67,6 +84,7 @@ typedef struct {
 
 typedef struct uCxAtClient {
     const struct uCxAtClientConfig *pConfig;
+    const uPortUartOps_t *pUartOps;
     uPortUartHandle_t uartHandle;
     size_t rxBufferPos;
     size_t urcBufferPos;
@@ -80,10 +98,21 @@ typedef struct uCxAtClient {
     char *pRspParams;
     int32_t status;
     int32_t lastIoError;
+    bool txError;           // A write of the current command failed or was short
     uUrcCallback_t urcCallback;
     void *pUrcCallbackTag;
 #if U_CX_USE_URC_QUEUE == 1
     uCxAtUrcQueue_t urcQueue;
+    char *pUrcLine;         // Reserved URC queue slot the current line is assembled in (or NULL)
+    size_t urcLineMaxLen;   // Max line length that fits in pUrcLine
+    bool urcLineChecked;    // The current line has been checked for URC slot reservation
+    U_CX_MUTEX_HANDLE urcMutex; // Protects the URC executor and the dispatch statistics
+    uUrcExecutor_t urcExecutor;
+    void *pUrcExecutorArg;
+    uint32_t urcDispatchCount;
+    int32_t urcMaxLatencyMs;
+    uint64_t urcTotLatencyMs;
+    uint32_t urcLatencyCount;
 #endif
     bool isBinaryRx;
     uCxAtBinaryRx_t binaryRx;
@@ -100,7 +129,10 @@ typedef struct uCxAtClientConfig {
     size_t urcBufferLen;    /**< Size of the URC buffer. */
 #endif
     const char *pUartDevName;  /**< UART device name (e.g., "UART0", "/dev/ttyUSB0") */
-    int32_t timeoutMs;
+    uint32_t uartFlags;     /**< U_PORT_UART_FLAG_xxx flags for uPortUartOpenEx(), e.g. low latency */
+    const uPortUartOps_t *pUartOps; /**< UART backend, NULL for the uPortUartXxx() functions of the port */
+    int32_t timeoutMs;      /**< UART read timeout when handling RX outside of a command. While a
+                                 command is executing reads wait up to the command timeout. */
     void *pContext;
 } uCxAtClientConfig_t;
 
@@ -156,6 +188,21 @@ int32_t uCxAtClientOpen(uCxAtClient_t *pClient, int32_t baudRate, bool flowContr
   */
 void uCxAtClientClose(uCxAtClient_t *pClient);
 
+/**
+  * @brief  Get a file descriptor for waiting on RX data
+  *
+  * Lets an application wait for data from many clients with one poll().
+  * Only available when the UART backend has U_PORT_UART_CAP_POLL_FD.
+  * Call uCxAtClientHandleRx() when the descriptor is readable. It handles
+  * all data that is available, including data the port has already read
+  * ahead from the descriptor, so the descriptor can be polled again after it.
+  *
+  * @param[in]  pClient:  the AT client from uCxAtClientInit().
+  * @retval              the file descriptor, or negative if the client isn't
+  *                      open or the backend has no file descriptor.
+  */
+int32_t uCxAtClientGetPollFd(const uCxAtClient_t *pClient);
+
 /**
   * @brief  Set URC callback
   *
@@ -166,6 +213,93 @@ void uCxAtClientClose(uCxAtClient_t *pClient);
   */
 void uCxAtClientSetUrcCallback(uCxAtClient_t *pClient, uUrcCallback_t urcCallback, void *pTag);
 
+#if U_CX_USE_URC_QUEUE == 1
+/**
+  * @brief  Set URC executor
+  *
+  * By default the URC callback is called directly from the context that
+  * received the URC (i.e. uCxAtClientHandleRx() or the end of an AT command).
+  * A slow URC callback will then delay the UART reception.
+  * When an executor is set the client will instead call the executor each
+  * time there are URCs waiting in the queue and it is up to the executor
+  * to call uCxAtClientProcessUrcs() from another context.
+  *
+  * The executor is called with an internal lock held, so it must only notify
+  * the other context and never call uCxAtClientProcessUrcs() or this function
+  * itself. Once this function has returned the previous executor is no longer
+  * called, so its argument can be freed.
+  *
+  * @param[in]  pClient:      the AT client from uCxAtClientInit().
+  * @param[in]  executor:     the executor notification function.
+  *                           Set to NULL to dispatch URCs directly again.
+  * @param[in]  pArg:         a user pointer that will be passed to the executor.
+  */
+void uCxAtClientSetUrcExecutor(uCxAtClient_t *pClient, uUrcExecutor_t executor, void *pArg);
+
+/**
+  * @brief  Set URC coalescing rules
+  *
+  * Bursts of redundant URCs (e.g. "data available" URCs) can be merged or dropped
+  * before they are placed in the URC queue. This reduces the queue pressure
+  * and the number of URC callbacks. See uCxAtUrcCoalesceMode_t for the available
+  * modes.
+  *
+  * @param[in]  pClient:      the AT client from uCxAtClientInit().
+  * @param[in]  pRules:       array of rules. The array must be valid as long as it is in use.
+  *                           Set to NULL to disable coalescing.
+  * @param      numRules:     number of rules in pRules.
+  */
+void uCxAtClientSetUrcCoalesceRules(uCxAtClient_t *pClient,
+                                    const uCxAtUrcCoalesceRule_t *pRules, size_t numRules);
+
+/**
+  * @brief  Set URC classes
+  *
+  * Splits the URC queue into one partition per URC class so that a flood of
+  * URCs in one class (e.g. bulk scan results) can't starve the other classes
+  * (e.g. link state changes). Each class has its own buffer budget and drop
+  * policy, see uCxAtUrcDropPolicy_t. URCs are still dispatched in the order
+  * they were received. URCs not matching any rule are placed in the data class.
+  *
+  * NOTE: Can only be changed while the URC queue is empty.
+  *
+  * @param[in]  pClient:       the AT client from uCxAtClientInit().
+  * @param[in]  pClassConfigs: array of U_CX_URC_CLASS_COUNT class configs.
+  *                            Set to NULL to use a single queue again.
+  * @param[in]  pRules:        array of URC class rules. The array must be valid
+  *                            as long as it is in use.
+  * @param      numRules:      number of rules in pRules.
+  * @return                    0 on success, U_CX_ERROR_INVALID_PARAMETER if the
+  *                            config is invalid or the URC queue is not empty.
+  */
+int32_t uCxAtClientSetUrcClasses(uCxAtClient_t *pClient,
+                                 const uCxAtUrcClassConfig_t *pClassConfigs,
+                                 const uCxAtUrcClassRule_t *pRules, size_t numRules);
+
+/**
+  * @brief  Dispatch all URCs waiting in the URC queue
+  *
+  * Calls the URC callback for each queued URC. This is called automatically
+  * unless an URC executor has been set using uCxAtClientSetUrcExecutor().
+  * Calling it while URCs are being dispatched from another context will
+  * do nothing.
+  *
+  * @param[in]  pClient:      the AT client from uCxAtClientInit().
+  */
+void uCxAtClientProcessUrcs(uCxAtClient_t *pClient);
+
+/**
+  * @brief  Get URC queue and dispatch statistics
+  *
+  * NOTE: The dispatch latency is only measured when an URC executor or
+  *       URC coalescing rules are used.
+  *
+  * @param[in]  pClient:      the AT client from uCxAtClientInit().
+  * @param[out] pStats:       output statistics.
+  */
+void uCxAtClientGetUrcStats(uCxAtClient_t *pClient, uCxAtUrcStats_t *pStats);
+#endif
+
 /**
   * @brief  Execute an AT command without any response
   *
@@ -231,10 +365,13 @@ int32_t uCxAtClientExecSimpleCmdF(uCxAtClient_t *pClient, const char *pCmd, cons
   * @param[in]  pCmd:      the AT command to execute.
   * @param[in]  pParamFmt: format string - see uCxAtClientExecSimpleCmdF().
   * @param      args:      the AT params. Last param is always U_CX_AT_UTIL_PARAM_LAST!
-  * @retval                0 on status OK, -1 on status ERROR, negative value on error.
+  * @retval                0 when the complete command was written, U_CX_ERROR_IO if the UART
+  *                        backend failed or accepted only part of it. The rest of the command
+  *                        is then not sent and the module must be resynchronized, e.g. with
+  *                        a plain "AT".
   */
-void uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt,
-                              va_list args);
+int32_t uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt,
+                                 va_list args);
 
 /**
   * @brief  Begin an AT command with response
@@ -331,7 +468,9 @@ void uCxAtClientHandleRx(uCxAtClient_t *pClient);
   * @brief  Get last I/O error code
   *
   * If the AT client returns U_CX_ERROR_IO you can call this
-  * function to get the underlying IO error code.
+  * function to get the underlying IO error code. When a UART write
+  * only accepted part of a command (e.g. the Linux port TX queue timed
+  * out during a flow control stall) this is U_CX_ERROR_IO.
   *
   * @param[in]  pClient:   the AT client from uCxAtClientInit().
   * @retval                IO error code.
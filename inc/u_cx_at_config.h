@@ -38,8 +38,10 @@
  *
  * With "U_CX_USE_URC_QUEUE 1" you can execute new AT commands directly
  * in the URC callback. However, this comes with some penalty as you need
- * to provide the AT client with an extra URC queue buffer and whenever an
- * URC is received it will be copied from the rxBuffer to the URC buffer.
+ * to provide the AT client with an extra URC queue buffer. Lines that look
+ * like URCs are assembled directly in the URC buffer so no extra copy is
+ * needed, but when the URC buffer is full the line will be received in the
+ * rxBuffer and the URC is dropped.
  *
  * NOTE: With "U_CX_USE_URC_QUEUE 0" you must never execute any AT command
  *       directly from the URC callback.
@@ -48,6 +50,29 @@
 # define U_CX_USE_URC_QUEUE 1
 #endif
 
+/* Number of recent URCs remembered for URC coalescing using
+ * U_CX_URC_COALESCE_DEDUP (see uCxAtClientSetUrcCoalesceRules()).
+ */
+#ifndef U_CX_URC_DEDUP_HISTORY_SIZE
+# define U_CX_URC_DEDUP_HISTORY_SIZE 8
+#endif
+
+/* Configuration for enabling SIMD optimized hex conversion and string escaping.
+ * SSE2 or NEON is used when the compiler targets a CPU supporting it,
+ * otherwise the portable implementation is used.
+ */
+#ifndef U_CX_USE_SIMD
+# define U_CX_USE_SIMD 1
+#endif
+
+/* Configuration for the XMODEM CRC16 implementation.
+ * When enabled, 8 bytes are processed per iteration using 4 KB of lookup
+ * tables. When disabled a single 512 byte table is used.
+ */
+#ifndef U_CX_XMODEM_CRC_SLICING
+# define U_CX_XMODEM_CRC_SLICING 1
+#endif
+
 /* Configuration for enabling logging of AT protocol.*/
 #ifndef U_CX_LOG_AT
 # define U_CX_LOG_AT 1
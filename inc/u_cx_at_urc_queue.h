@@ -41,19 +41,98 @@
  * -------------------------------------------------------------- */
 
 typedef struct {
+    int32_t timestampMs;  // Enqueue time set with uCxAtUrcQueueEnqueueSetTimestamp() (0 if not set)
+    uint32_t seq;         // Enqueue sequence number (used for ordering URCs between classes)
+    uint32_t entrySize;   // Size of the entry slot in the queue including this header
     uint16_t strLineLen;  // String length excluding null term
     uint16_t payloadSize; // Binary payload length (0 if none)
     uint8_t data[];       // Layout is {strLineLen}{null term}{payloadSize}
 } uUrcEntry_t;
 
+typedef enum {
+    U_CX_URC_COALESCE_SUM,      /**< Merge with the last queued URC if all params except the last
+                                     are equal. The last (integer) params are summed. */
+    U_CX_URC_COALESCE_DEDUP,    /**< Drop the URC if a URC with the same first param has
+                                     been queued within windowMs. */
+} uCxAtUrcCoalesceMode_t;
+
+typedef struct {
+    const char *pPrefix;            /**< URC prefix including ':' (e.g. "+UESODA:"). */
+    uCxAtUrcCoalesceMode_t mode;
+    int32_t windowMs;               /**< Time window for U_CX_URC_COALESCE_DEDUP. */
+} uCxAtUrcCoalesceRule_t;
+
+typedef struct {
+    uint32_t hash;
+    int32_t timestampMs;
+    bool used;
+} uCxAtUrcDedupEntry_t;
+
+typedef enum {
+    U_CX_URC_CLASS_CRITICAL,    /**< State changes that must not be lost (link down, socket closed etc). */
+    U_CX_URC_CLASS_DATA,        /**< Data related URCs. Also used for URCs not matching any class rule. */
+    U_CX_URC_CLASS_BULK,        /**< Low value URCs that may come in bursts (discovery reports etc). */
+    U_CX_URC_CLASS_COUNT
+} uCxAtUrcClass_t;
+
+typedef enum {
+    U_CX_URC_DROP_NEWEST,       /**< When full the new URC is dropped. */
+    U_CX_URC_DROP_OLDEST,       /**< When full the oldest URCs in the class are dropped to make room. */
+    U_CX_URC_DROP_COALESCE,     /**< When full a queued URC with the same name and first param
+                                     is replaced by the new URC. If there is none the new URC is
+                                     dropped. */
+} uCxAtUrcDropPolicy_t;
+
+typedef struct {
+    uint8_t budgetPercent;              /**< Share of the URC buffer (0 = class not used). */
+    uCxAtUrcDropPolicy_t dropPolicy;
+} uCxAtUrcClassConfig_t;
+
+typedef struct {
+    const char *pPrefix;            /**< URC prefix including ':' (e.g. "+UEWLD:"). */
+    uCxAtUrcClass_t urcClass;
+} uCxAtUrcClassRule_t;
+
+/* Each URC class uses a separate part of the URC buffer. Each part is a
+ * ring buffer of variable sized entries. Entries are always stored
+ * contiguously so when there is not enough room at the end of the
+ * buffer the writer wraps around to the start and wrapPos marks where
+ * the entries before the wrap end.
+ */
+typedef struct {
+    uint8_t *pBuffer;
+    size_t bufferLen;
+    size_t readPos;         // Offset of the oldest entry
+    size_t writePos;        // Offset where the next entry will be written
+    size_t wrapPos;         // End of the entries before the wrap (0 when not wrapped)
+    size_t count;           // Number of entries currently in the partition
+    uUrcEntry_t *pLastEntry;    // Last enqueued entry (NULL when dequeued)
+    uCxAtUrcDropPolicy_t dropPolicy;
+    uint32_t dropCount;     // Number of URCs dropped due to full partition
+} uCxAtUrcPartition_t;
+
 typedef struct uCxAtUrcQueue {
     uint8_t *pBuffer;
     size_t bufferLen;
-    size_t bufferPos;
+    uCxAtUrcPartition_t partitions[U_CX_URC_CLASS_COUNT];
+    const uCxAtUrcClassRule_t *pClassRules;
+    size_t numClassRules;
+    uint32_t nextSeq;
     U_CX_MUTEX_HANDLE queueMutex;
     U_CX_MUTEX_HANDLE dequeueMutex;
-    uUrcEntry_t *pEnqueueEntry;
+    uUrcEntry_t *pEnqueueEntry; // Reserved entry slot (NULL when not enqueueing)
+    uCxAtUrcPartition_t *pEnqueuePartition;
+    size_t enqueueSlotLen;      // Size of the reserved slot
+    bool enqueueWrap;           // Reserved slot is located at start of buffer after a wrap
+    bool enqueueReplace;        // Reserved slot is a queued entry being replaced (U_CX_URC_DROP_COALESCE)
     uUrcEntry_t *pDequeueEntry;
+    uCxAtUrcPartition_t *pDequeuePartition;
+    size_t count;           // Number of entries currently in the queue
+    size_t peakCount;       // Highest number of entries that has been in the queue
+    const uCxAtUrcCoalesceRule_t *pCoalesceRules;
+    size_t numCoalesceRules;
+    size_t coalescedCount;      // Number of URCs merged or dropped by the coalescing rules
+    uCxAtUrcDedupEntry_t dedupHistory[U_CX_URC_DEDUP_HISTORY_SIZE];
 } uCxAtUrcQueue_t;
 
 /* ----------------------------------------------------------------
@@ -86,11 +165,96 @@ void uCxAtUrcQueueInit(uCxAtUrcQueue_t *pUrcQueue, void *pBuffer, size_t bufferL
 void uCxAtUrcQueueDeInit(uCxAtUrcQueue_t *pUrcQueue);
 
 
+/**
+  * @brief  Partition the URC queue into URC classes
+  *
+  * By default all URCs share the complete URC buffer and new URCs are dropped
+  * when it is full. Using this function the buffer is instead split into one
+  * part per URC class, each with its own drop policy. This way a flood of low
+  * value URCs can't cause important URCs to be dropped.
+  *
+  * NOTE: The queue must be empty when calling this function.
+  *
+  * @param[in]  pUrcQueue:     the URC queue initialized with uCxAtUrcQueueInit().
+  * @param[in]  pClassConfigs: array of U_CX_URC_CLASS_COUNT class configurations indexed
+  *                            by uCxAtUrcClass_t. The sum of all budgets must not exceed
+  *                            100% and the data class must have a budget. Set to NULL to
+  *                            go back to a single unpartitioned queue.
+  * @param[in]  pRules:        array of rules for classifying URCs. URCs not matching any
+  *                            rule are placed in U_CX_URC_CLASS_DATA. The array must be
+  *                            valid as long as it is in use.
+  * @param      numRules:      number of rules in pRules.
+  * @return                    true on success, false if the queue is not empty or on
+  *                            invalid configuration.
+  */
+bool uCxAtUrcQueueSetClasses(uCxAtUrcQueue_t *pUrcQueue,
+                             const uCxAtUrcClassConfig_t *pClassConfigs,
+                             const uCxAtUrcClassRule_t *pRules, size_t numRules);
+
+/**
+  * @brief  Get URC class statistics
+  *
+  * @param[in]  pUrcQueue:  the URC queue initialized with uCxAtUrcQueueInit().
+  * @param      urcClass:   the URC class.
+  * @param[out] pCount:     number of URCs currently queued in the class.
+  * @param[out] pDropCount: number of URCs of the class that have been dropped.
+  */
+void uCxAtUrcQueueGetClassStats(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcClass_t urcClass,
+                                size_t *pCount, uint32_t *pDropCount);
+
+/**
+  * @brief  Set URC coalescing rules
+  *
+  * Coalescing is applied in uCxAtUrcQueueEnqueueEnd() to URCs without binary payload.
+  * U_CX_URC_COALESCE_DEDUP uses the entry timestamp so uCxAtUrcQueueEnqueueSetTimestamp()
+  * must be called for each URC when such a rule is used.
+  *
+  * @param[in]  pUrcQueue: the URC queue initialized with uCxAtUrcQueueInit().
+  * @param[in]  pRules:    array of rules. The array must be valid as long as it is in use.
+  *                        Set to NULL to disable coalescing.
+  * @param      numRules:  number of rules in pRules.
+  */
+void uCxAtUrcQueueSetCoalesceRules(uCxAtUrcQueue_t *pUrcQueue,
+                                   const uCxAtUrcCoalesceRule_t *pRules, size_t numRules);
+
+/**
+  * @brief  Reserve a slot for writing a URC line directly into the queue
+  *
+  * This can be used for assembling an incoming line directly in the queue
+  * without knowing the final line length in advance. The beginning of the
+  * line (at least the URC name) must be known as it is used for selecting
+  * the URC class. The largest available contiguous slot is reserved and
+  * the beginning of the line is copied to it. When the line is complete the caller must
+  * either call uCxAtUrcQueueEnqueueBegin() with the line pointer (no copy
+  * will be made) or call uCxAtUrcQueueEnqueueAbort() to release the slot.
+  *
+  * NOTE: The content of a released slot remains untouched until the next
+  *       reservation, so a line that turned out not to be a URC can still
+  *       be read after uCxAtUrcQueueEnqueueAbort() has been called.
+  *
+  * @param[in]  pUrcQueue:    the URC queue initialized with uCxAtUrcQueueInit().
+  * @param[in]  pLineStart:   the beginning of the line received so far.
+  * @param      lineStartLen: the length of pLineStart.
+  * @param[out] ppLine:       the pointer value will be set to the address where the line
+  *                           should be written. The first lineStartLen chars are already
+  *                           written.
+  * @return                   the maximum line length (excluding null term) that fits in the
+  *                           slot, or 0 if the queue is full (no slot is then reserved).
+  */
+size_t uCxAtUrcQueueEnqueueReserve(uCxAtUrcQueue_t *pUrcQueue, const char *pLineStart,
+                                   size_t lineStartLen, char **ppLine);
+
 /**
   * @brief  Begin enqueueing a URC entry
   *
+  * If pUrcLine points to the slot from uCxAtUrcQueueEnqueueReserve() the line is
+  * enqueued in place, otherwise it is copied to the queue.
+  *
   * NOTE: When this function returns true caller must call either uCxAtUrcQueueEnqueueEnd()
   *       OR uCxAtUrcQueueEnqueueAbort() to complete the enqueueing.
+  *       When it returns false any reserved slot has been released.
+  *       If no slot is reserved and the URC class is full the drop policy
+  *       of the class is applied (see uCxAtUrcQueueSetClasses()).
   *
   * @param[in]  pUrcQueue: the URC queue initialized with uCxAtUrcQueueInit().
   * @return                true on success, false if there are no room for the URC string.
@@ -109,6 +273,9 @@ uint16_t uCxAtUrcQueueEnqueueGetPayloadPtr(uCxAtUrcQueue_t *pUrcQueue, uint8_t *
 /**
   * @brief  Complete the URC enqueueing
   *
+  * If the URC matches any of the coalescing rules (see uCxAtUrcQueueSetCoalesceRules())
+  * it may be merged with the last queued URC or dropped instead of being queued.
+  *
   * @param[in]  pUrcQueue:   the URC queue initialized with uCxAtUrcQueueInit().
   * @param      payloadSize: the size of the payload added by writing to pointer
   *                          fetched with uCxAtUrcQueueEnqueueGetPayloadPtr().
@@ -116,10 +283,22 @@ uint16_t uCxAtUrcQueueEnqueueGetPayloadPtr(uCxAtUrcQueue_t *pUrcQueue, uint8_t *
   */
 void uCxAtUrcQueueEnqueueEnd(uCxAtUrcQueue_t *pUrcQueue, uint16_t payloadSize);
 
+/**
+  * @brief  Set the enqueue timestamp of the URC entry being enqueued
+  *
+  * Can be called any time between uCxAtUrcQueueEnqueueBegin() and
+  * uCxAtUrcQueueEnqueueEnd(). Used for measuring the dispatch latency.
+  *
+  * @param[in]  pUrcQueue:   the URC queue initialized with uCxAtUrcQueueInit().
+  * @param      timestampMs: the timestamp in millisec.
+  */
+void uCxAtUrcQueueEnqueueSetTimestamp(uCxAtUrcQueue_t *pUrcQueue, int32_t timestampMs);
+
 /**
   * @brief  Abort the URC enqueueing
   *
   * Useful when the payload can't be fitted into the queue.
+  * This is also used for releasing a slot from uCxAtUrcQueueEnqueueReserve().
   *
   * @param[in]  pUrcQueue:   the URC queue initialized with uCxAtUrcQueueInit().
   */
@@ -146,4 +325,14 @@ uUrcEntry_t *uCxAtUrcQueueDequeueBegin(uCxAtUrcQueue_t *pUrcQueue);
   */
 void uCxAtUrcQueueDequeueEnd(uCxAtUrcQueue_t *pUrcQueue, uUrcEntry_t *pEntry);
 
+/**
+  * @brief  Get number of URC entries in the queue
+  *
+  * @param[in]  pUrcQueue:  the URC queue initialized with uCxAtUrcQueueInit().
+  * @param[out] pPeakCount: optional output for the highest number of entries that
+  *                         have been in the queue (can be NULL).
+  * @return                 the number of entries currently in the queue.
+  */
+size_t uCxAtUrcQueueGetCount(uCxAtUrcQueue_t *pUrcQueue, size_t *pPeakCount);
+
 #endif // U_CX_AT_URC_QUEUE_H
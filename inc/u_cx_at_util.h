@@ -32,6 +32,16 @@
 
 #define U_CX_AT_UTIL_PARAM_LAST  NULL
 
+/**
+ * Minimum scratch buffer size for uCxAtUtilWriteEscStringStream().
+ */
+#define U_CX_AT_UTIL_ESC_SCRATCH_MIN_SIZE  8
+
+/**
+ * Start of binary data transfer.
+ */
+#define U_CX_SOH_CHAR            0x01
+
 /**
  * Returns the maximum value of the two parameters.
  */
@@ -46,10 +56,42 @@
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Byte classes used by the AT client RX state machine (see gUCxAtByteClass). */
+typedef enum {
+    U_CX_AT_BYTE_IGNORE = 0,    /**< Non-printable byte that is discarded. */
+    U_CX_AT_BYTE_PRINT,         /**< Printable ASCII character that is part of a line. */
+    U_CX_AT_BYTE_EOL,           /**< End of line ('\r' or '\n'). */
+    U_CX_AT_BYTE_SOH            /**< Start of binary data (U_CX_SOH_CHAR). */
+} uCxAtByteClass_t;
+
+/** Line types returned by uCxAtUtilClassifyLine(). */
+typedef enum {
+    U_CX_AT_LINE_EMPTY,         /**< Empty line. */
+    U_CX_AT_LINE_OK,            /**< "OK" status. */
+    U_CX_AT_LINE_ERROR,         /**< Line starting with "ERROR" (may have an extended error code). */
+    U_CX_AT_LINE_EXPECTED_RSP,  /**< Line starting with the expected response. */
+    U_CX_AT_LINE_URC,           /**< Line starting with '+' or '*'. */
+    U_CX_AT_LINE_ECHO,          /**< Echo of an "AT+" command. */
+    U_CX_AT_LINE_OTHER          /**< Any other line (e.g. a response without prefix). */
+} uCxAtLineType_t;
+
+/**
+ * Write function used by uCxAtUtilWriteEscStringStream().
+ * Returns the number of bytes written or negative value on error.
+ */
+typedef int32_t (*uCxAtUtilWriteFunc_t)(void *pArg, const void *pData, size_t dataLen);
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/**
+ * Byte class lookup table indexed by the received byte (uCxAtByteClass_t values).
+ * Only printable ASCII (0x20-0x7E) is classed as U_CX_AT_BYTE_PRINT which is
+ * the same as isprint() in the "C" locale.
+ */
+extern const uint8_t gUCxAtByteClass[256];
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -215,4 +257,53 @@ void uCxAtUtilReplaceChar(char *pData, size_t dataLen, char from, char to);
   */
 size_t uCxAtUtilWriteEscString(const char *pStr, size_t length, char *pOutBuf, size_t outBufSize);
 
+/**
+  * @brief  Find the first character that needs escaping
+  *
+  * Characters that need escaping are non-printable characters, '"' and '\\'.
+  *
+  * @param[in]  pStr:    the string to scan.
+  * @param      length:  the length of the string.
+  * @retval              the index of the first character that needs escaping or
+  *                      length if no character needs escaping.
+  */
+size_t uCxAtUtilFindEscapeChar(const char *pStr, size_t length);
+
+/**
+  * @brief  Write an escaped string with quotes using a write function
+  *
+  * Same escaping as uCxAtUtilWriteEscString() but without any limitation of
+  * the string length. Short sequences are collected in pScratch before being
+  * written while long runs of characters not needing escape are passed
+  * directly to writeFunc.
+  *
+  * @param[in]  pStr:         the string to escape.
+  * @param      length:       the length of the string.
+  * @param[in]  pScratch:     scratch buffer (at least U_CX_AT_UTIL_ESC_SCRATCH_MIN_SIZE bytes).
+  * @param      scratchSize:  size of the scratch buffer.
+  * @param      writeFunc:    function called for writing the output.
+  * @param[in]  pArg:         user pointer passed to writeFunc.
+  * @retval                   the total number of bytes passed to writeFunc.
+  */
+size_t uCxAtUtilWriteEscStringStream(const char *pStr, size_t length,
+                                     char *pScratch, size_t scratchSize,
+                                     uCxAtUtilWriteFunc_t writeFunc, void *pArg);
+
+/**
+  * @brief  Classify a received AT line
+  *
+  * Determines the line type by looking at the start of the line only once.
+  * The line does not need to be null terminated.
+  * The expected response takes precedence over all other line types so
+  * that responses starting with '+' are not classified as URCs.
+  *
+  * @param[in]  pLine:           the line to classify (without CR/LF).
+  * @param      lineLength:      the length of the line.
+  * @param[in]  pExpectedRsp:    the expected response prefix or NULL if no response is expected.
+  * @param      expectedRspLen:  the length of pExpectedRsp.
+  * @retval                      the line type.
+  */
+uCxAtLineType_t uCxAtUtilClassifyLine(const char *pLine, size_t lineLength,
+                                      const char *pExpectedRsp, size_t expectedRspLen);
+
 #endif // U_CX_AT_UTIL_H
\ No newline at end of file
@@ -47,7 +47,12 @@ typedef struct {
     uPortUartHandle_t uartHandle; /**< Internal UART handle */
     bool use1K;                 /**< Use 1K blocks (XMODEM-1K) instead of 128-byte blocks */
     int32_t timeoutMs;          /**< Timeout for receiving ACK/NAK (milliseconds) */
+    int32_t blockDelayMs;       /**< Delay after each 1K block for the receiver to write flash
+                                     (milliseconds, 0 to disable) */
+    bool allowStreaming;        /**< Use streaming mode (XMODEM-G) when requested by the receiver.
+                                     Only used when opened with hardware flow control. */
     int32_t instance;           /**< Instance number for logging */
+    bool flowControl;           /**< Internal hardware flow control state */
     volatile bool opened;       /**< UART opened state */
 } uCxXmodemConfig_t;
 
@@ -77,6 +82,19 @@ typedef void (*uCxXmodemProgressCallback_t)(size_t totalBytes, size_t bytesTrans
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+/**
+ * @brief Calculate CRC16-CCITT as used by XMODEM
+ *
+ * Can be called repeatedly for calculating the CRC of data in several chunks
+ * by passing the result of the previous call as crc.
+ *
+ * @param     crc      Initial CRC value (0 for a new calculation)
+ * @param[in] pData    Data to calculate the CRC for
+ * @param     dataLen  Length of the data in bytes
+ * @return             Updated CRC value
+ */
+uint16_t uCxXmodemCrc16(uint16_t crc, const uint8_t *pData, size_t dataLen);
+
 /**
  * @brief Initialize XMODEM configuration with defaults
  *
@@ -108,6 +126,13 @@ void uCxXmodemClose(uCxXmodemConfig_t *pConfig);
  * This function sends data using the XMODEM protocol with CRC16 error checking.
  * It waits for the receiver to initiate the transfer by sending 'C' or NAK,
  * then repeatedly calls the data callback to retrieve blocks of data to send.
+ * If the receiver initiates the transfer with 'G', allowStreaming is set and
+ * the UART was opened with hardware flow control, the blocks are streamed
+ * without waiting for ACK (XMODEM-G); the receiver then cancels the transfer
+ * on any error. Otherwise 'G' is ignored and classic XMODEM is used.
+ * The next block is retrieved while waiting for the receiver to acknowledge
+ * the current one, so the data callback and CRC calculation overlap with
+ * the UART round trip.
  *
  * Must be called after uCxXmodemOpen().
  *
@@ -124,11 +149,54 @@ int32_t uCxXmodemSend(uCxXmodemConfig_t *pConfig,
                       uCxXmodemProgressCallback_t progressCallback,
                       void *pUserData);
 
+/**
+ * @brief Calculate the CRC of each XMODEM block of in-memory data
+ *
+ * The result can be passed to uCxXmodemSendBuffer() so that no CRC needs to
+ * be calculated during the transfer. The last block is padded the same way
+ * as when it is sent.
+ *
+ * @param[in]  pConfig     XMODEM configuration (for the block size)
+ * @param[in]  pData       Data to send
+ * @param      dataLen     Length of data in bytes
+ * @param[out] pBlockCrcs  Output with room for one CRC per block, i.e.
+ *                         (dataLen + 1023) / 1024 entries for 1K blocks
+ *                         and (dataLen + 127) / 128 entries otherwise
+ */
+void uCxXmodemCalcBlockCrcs(const uCxXmodemConfig_t *pConfig, const uint8_t *pData,
+                            size_t dataLen, uint16_t *pBlockCrcs);
+
+/**
+ * @brief Send in-memory data using XMODEM protocol
+ *
+ * Same as uCxXmodemSend() but the blocks are taken directly from pData
+ * instead of using a data callback.
+ *
+ * Must be called after uCxXmodemOpen().
+ *
+ * @param[in] pConfig         XMODEM configuration
+ * @param[in] pData           Data to send (e.g. a memory mapped file)
+ * @param     dataLen         Length of data in bytes
+ * @param[in] pBlockCrcs      Optional CRC of each block from uCxXmodemCalcBlockCrcs()
+ *                            (NULL to calculate the CRC during the transfer)
+ * @param     progressCallback  Optional progress callback (NULL to disable)
+ * @param     pUserData       User data pointer passed to the progress callback
+ * @return                    0 on success, negative error code on failure
+ */
+int32_t uCxXmodemSendBuffer(uCxXmodemConfig_t *pConfig,
+                            const uint8_t *pData,
+                            size_t dataLen,
+                            const uint16_t *pBlockCrcs,
+                            uCxXmodemProgressCallback_t progressCallback,
+                            void *pUserData);
+
 #if U_CX_XMODEM_FILE_SUPPORT
 /**
  * @brief Send file using XMODEM protocol (convenience function)
  *
  * Reads the specified file and sends it using XMODEM protocol.
+ * On POSIX the file is memory mapped and the CRC of all blocks is
+ * calculated before the transfer starts.
  * This function is only available when U_CX_XMODEM_FILE_SUPPORT is defined.
  *
  * Must be called after uCxXmodemOpen().
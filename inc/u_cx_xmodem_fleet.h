@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Parallel XMODEM firmware upgrade of several modules
+ *
+ * Sends the same firmware image to modules connected to several UARTs at
+ * the same time, one XMODEM session per UART running on a pool of worker
+ * threads. The image and the CRC of all blocks are shared by the sessions
+ * so each additional port only costs its UART time.
+ *
+ * The transfer functions are only available with the POSIX port.
+ */
+
+#ifndef U_CX_XMODEM_FLEET_H
+#define U_CX_XMODEM_FLEET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "u_cx_xmodem.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/**
+ * Upgrade state of a port
+ */
+typedef enum {
+    U_CX_XMODEM_FLEET_STATE_PENDING = 0,  /**< Waiting for a free worker */
+    U_CX_XMODEM_FLEET_STATE_PREPARING,    /**< Prepare callback running */
+    U_CX_XMODEM_FLEET_STATE_SENDING,      /**< XMODEM transfer in progress */
+    U_CX_XMODEM_FLEET_STATE_DONE,         /**< Image transferred successfully */
+    U_CX_XMODEM_FLEET_STATE_FAILED        /**< All attempts failed */
+} uCxXmodemFleetState_t;
+
+/**
+ * Per port upgrade status
+ */
+typedef struct {
+    const char *pUartDevName;       /**< UART device name, set by the caller */
+    uCxXmodemFleetState_t state;    /**< Current state */
+    int32_t attempts;               /**< Number of attempts started */
+    int32_t result;                 /**< Result of the last attempt (0 on success) */
+    size_t bytesTransferred;        /**< Bytes transferred in the current attempt */
+    int32_t elapsedMs;              /**< Duration of the last finished attempt */
+} uCxXmodemFleetPort_t;
+
+/**
+ * Prepare callback
+ *
+ * Called by the worker before each attempt, e.g. for putting the module in
+ * bootloader mode with AT+USYFWUS. Runs in the worker thread so it may block.
+ *
+ * @param     portIndex     Index of the port in the port array
+ * @param[in] pUartDevName  UART device name of the port
+ * @param     attempt       Attempt number starting at 1
+ * @param     pUserData     User data pointer from the configuration
+ * @return                  0 to start the transfer, negative value to fail the attempt
+ */
+typedef int32_t (*uCxXmodemFleetPrepareCallback_t)(size_t portIndex, const char *pUartDevName,
+                                                   int32_t attempt, void *pUserData);
+
+/**
+ * Progress callback
+ *
+ * Called on every state change and for every block sent. The calls are
+ * serialized so all entries of the port array can be read consistently.
+ *
+ * @param     portIndex  Index of the port that changed
+ * @param[in] pPorts     The port array passed to the send function
+ * @param     pUserData  User data pointer from the configuration
+ */
+typedef void (*uCxXmodemFleetProgressCallback_t)(size_t portIndex, const uCxXmodemFleetPort_t *pPorts,
+                                                 void *pUserData);
+
+/**
+ * Fleet upgrade configuration
+ */
+typedef struct {
+    int32_t baudRate;               /**< XMODEM baud rate */
+    bool flowControl;               /**< Use hardware flow control */
+    bool use1K;                     /**< Use 1K blocks (XMODEM-1K) */
+    int32_t timeoutMs;              /**< Timeout for receiving ACK/NAK (milliseconds) */
+    int32_t blockDelayMs;           /**< Delay after each 1K block (milliseconds) */
+    bool allowStreaming;            /**< Use XMODEM-G when requested by the receiver */
+    int32_t maxAttempts;            /**< Attempts per port before giving up */
+    size_t numWorkers;              /**< Number of worker threads (0 = one per port) */
+    uCxXmodemFleetPrepareCallback_t prepareCallback;    /**< Optional prepare callback */
+    uCxXmodemFleetProgressCallback_t progressCallback;  /**< Optional progress callback */
+    void *pUserData;                /**< User data pointer passed to the callbacks */
+} uCxXmodemFleetConfig_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+ * @brief Initialize fleet configuration with defaults
+ *
+ * The XMODEM settings are the same as for uCxXmodemInit(). Three attempts
+ * are made per port and one worker is used per port.
+ *
+ * @param[out] pConfig   Pointer to configuration structure to initialize
+ * @param      baudRate  XMODEM baud rate
+ */
+void uCxXmodemFleetInit(uCxXmodemFleetConfig_t *pConfig, int32_t baudRate);
+
+#ifdef U_PORT_POSIX
+/**
+ * @brief Send in-memory data to several ports in parallel
+ *
+ * The CRC of all blocks is calculated once before the workers start.
+ * Each port is then handled by one worker: the prepare callback is called,
+ * the UART is opened and the data is sent with uCxXmodemSendBuffer(). On
+ * failure this is repeated until maxAttempts is reached. The function
+ * returns when all ports are done or have failed.
+ *
+ * @param[in]     pConfig    Fleet configuration
+ * @param[in]     pData      Data to send (e.g. a memory mapped file)
+ * @param         dataLen    Length of data in bytes
+ * @param[in,out] pPorts     Ports to upgrade. Only pUartDevName must be set,
+ *                           the other fields are updated with the status.
+ * @param         numPorts   Number of ports
+ * @return                   Number of ports that failed (0 if all succeeded)
+ *                           or negative error code
+ */
+int32_t uCxXmodemFleetSendBuffer(const uCxXmodemFleetConfig_t *pConfig,
+                                 const uint8_t *pData,
+                                 size_t dataLen,
+                                 uCxXmodemFleetPort_t *pPorts,
+                                 size_t numPorts);
+
+#if U_CX_XMODEM_FILE_SUPPORT
+/**
+ * @brief Send a file to several ports in parallel
+ *
+ * Memory maps the file once and sends it with uCxXmodemFleetSendBuffer().
+ * This function is only available when U_CX_XMODEM_FILE_SUPPORT is defined.
+ *
+ * @param[in]     pConfig    Fleet configuration
+ * @param[in]     pFilePath  Path to file to send
+ * @param[in,out] pPorts     Ports to upgrade (see uCxXmodemFleetSendBuffer())
+ * @param         numPorts   Number of ports
+ * @return                   Number of ports that failed (0 if all succeeded)
+ *                           or negative error code
+ */
+int32_t uCxXmodemFleetSendFile(const uCxXmodemFleetConfig_t *pConfig,
+                               const char *pFilePath,
+                               uCxXmodemFleetPort_t *pPorts,
+                               size_t numPorts);
+#endif // U_CX_XMODEM_FILE_SUPPORT
+#endif // U_PORT_POSIX
+
+#endif // U_CX_XMODEM_FLEET_H
@@ -40,12 +40,24 @@ typedef struct {
     volatile bool terminateRxTask;
 } uPortRxContext_t;
 
+typedef struct {
+    uCxAtClient_t *pClient;
+    pthread_t dispatchThread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool pending;
+    bool terminate;
+} uPortUrcDispatchContext_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
 static int32_t gBootTime = 0;
 static uPortRxContext_t gRxContext;
+#if U_CX_USE_URC_QUEUE == 1
+static uPortUrcDispatchContext_t gUrcDispatchContext;
+#endif
 
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
@@ -88,6 +100,43 @@ static void *rxTask(void *pArg)
     return NULL;
 }
 
+#if U_CX_USE_URC_QUEUE == 1
+// URC executor called from the RX context
+static void urcDispatchNotify(uCxAtClient_t *pClient, void *pArg)
+{
+    (void)pClient;
+    uPortUrcDispatchContext_t *pCtx = (uPortUrcDispatchContext_t *)pArg;
+
+    pthread_mutex_lock(&pCtx->mutex);
+    pCtx->pending = true;
+    pthread_cond_signal(&pCtx->cond);
+    pthread_mutex_unlock(&pCtx->mutex);
+}
+
+static void *urcDispatchTask(void *pArg)
+{
+    uPortUrcDispatchContext_t *pCtx = (uPortUrcDispatchContext_t *)pArg;
+
+    while (true) {
+        pthread_mutex_lock(&pCtx->mutex);
+        while (!pCtx->pending && !pCtx->terminate) {
+            pthread_cond_wait(&pCtx->cond, &pCtx->mutex);
+        }
+        bool terminate = pCtx->terminate;
+        pCtx->pending = false;
+        pthread_mutex_unlock(&pCtx->mutex);
+
+        if (terminate) {
+            break;
+        }
+        uCxAtClientProcessUrcs(pCtx->pClient);
+    }
+
+    U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pCtx->pClient->instance, "URC dispatch task terminated");
+    return NULL;
+}
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -153,3 +202,39 @@ void uPortBgRxTaskDestroy(uCxAtClient_t *pClient)
     gRxContext.terminateRxTask = true;
     pthread_join(gRxContext.rxThread, NULL);
 }
+
+#if U_CX_USE_URC_QUEUE == 1
+int32_t uPortUrcDispatchTaskCreate(uCxAtClient_t *pClient)
+{
+    uPortUrcDispatchContext_t *pCtx = &gUrcDispatchContext;
+
+    memset(pCtx, 0, sizeof(uPortUrcDispatchContext_t));
+    pCtx->pClient = pClient;
+    pthread_mutex_init(&pCtx->mutex, NULL);
+    pthread_cond_init(&pCtx->cond, NULL);
+    if (pthread_create(&pCtx->dispatchThread, NULL, urcDispatchTask, pCtx) != 0) {
+        pthread_cond_destroy(&pCtx->cond);
+        pthread_mutex_destroy(&pCtx->mutex);
+        return -1;
+    }
+    uCxAtClientSetUrcExecutor(pClient, urcDispatchNotify, pCtx);
+
+    return 0;
+}
+
+void uPortUrcDispatchTaskDestroy(uCxAtClient_t *pClient)
+{
+    uPortUrcDispatchContext_t *pCtx = &gUrcDispatchContext;
+
+    uCxAtClientSetUrcExecutor(pClient, NULL, NULL);
+
+    pthread_mutex_lock(&pCtx->mutex);
+    pCtx->terminate = true;
+    pthread_cond_signal(&pCtx->cond);
+    pthread_mutex_unlock(&pCtx->mutex);
+    pthread_join(pCtx->dispatchThread, NULL);
+
+    pthread_cond_destroy(&pCtx->cond);
+    pthread_mutex_destroy(&pCtx->mutex);
+}
+#endif
@@ -56,4 +56,27 @@
   */
 int32_t uPortMutexTryLock(pthread_mutex_t *pMutex, uint32_t timeoutMs);
 
+/**
+  * @brief Create a URC dispatch thread
+  *
+  * Installs an URC executor (see uCxAtClientSetUrcExecutor()) that wakes up
+  * a dedicated thread which calls the URC callback. This way a slow URC
+  * callback will never delay the UART reception.
+  * Only available with U_CX_USE_URC_QUEUE enabled.
+  *
+  * @param pClient  Pointer to AT client instance
+  * @return         0 on success, negative value on error
+  */
+int32_t uPortUrcDispatchTaskCreate(struct uCxAtClient *pClient);
+
+/**
+  * @brief Destroy the URC dispatch thread
+  *
+  * Removes the URC executor so that URCs are dispatched from the
+  * RX context again and stops the dispatch thread.
+  *
+  * @param pClient  Pointer to AT client instance
+  */
+void uPortUrcDispatchTaskDestroy(struct uCxAtClient *pClient);
+
 #endif
\ No newline at end of file
@@ -36,6 +36,18 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** Flags for uPortUartOpenEx(). A port ignores flags it doesn't support. */
+#define U_PORT_UART_FLAG_LOW_LATENCY  (1u << 0)  /**< Minimize driver RX latency (e.g. ASYNC_LOW_LATENCY) */
+#define U_PORT_UART_FLAG_EXCLUSIVE    (1u << 1)  /**< Deny other processes access to the device */
+#define U_PORT_UART_FLAG_FLUSH_INPUT  (1u << 2)  /**< Discard stale RX data when opening */
+#define U_PORT_UART_FLAG_TX_QUEUE     (1u << 3)  /**< Queue TX data for a writer thread instead of
+                                                      blocking the caller (Linux port only) */
+
+/** Capabilities of a UART backend, see uPortUartOps_t */
+#define U_PORT_UART_CAP_POLL_FD       (1u << 0)  /**< getFdFn returns a file descriptor that can be
+                                                      used with poll()/select() for RX */
+#define U_PORT_UART_CAP_WRITEV        (1u << 1)  /**< writevFn writes several buffers in one call */
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -43,6 +55,36 @@ extern "C" {
 /** UART handle - platform-specific implementation */
 typedef void *uPortUartHandle_t;
 
+/** One buffer for uPortUartOps_t.writevFn */
+typedef struct {
+    const void *pData;
+    size_t length;
+} uPortUartIoVec_t;
+
+/**
+ * UART backend operations
+ *
+ * Lets an AT client use another backend than the uPortUartXxx() functions
+ * linked into the binary (see uCxAtClientConfig_t.pUartOps), so one process
+ * can mix for example local UARTs, sockets and simulators. openFn, closeFn,
+ * writeFn and readFn have the same semantics as uPortUartOpenEx(),
+ * uPortUartClose(), uPortUartWrite() and uPortUartRead(). The optional
+ * functions may be NULL and are only used when the matching
+ * U_PORT_UART_CAP_xxx bit is set in caps.
+ */
+typedef struct {
+    uPortUartHandle_t (*openFn)(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                uint32_t flags);
+    void (*closeFn)(uPortUartHandle_t handle);
+    int32_t (*writeFn)(uPortUartHandle_t handle, const void *pData, size_t length);
+    int32_t (*readFn)(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs);
+    /** Write all buffers in order, returns the total number of bytes written or negative on error */
+    int32_t (*writevFn)(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov, size_t iovCount);
+    /** File descriptor for RX readiness, negative if there is none */
+    int32_t (*getFdFn)(uPortUartHandle_t handle);
+    uint32_t caps;  /**< Bitmask of U_PORT_UART_CAP_xxx */
+} uPortUartOps_t;
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -59,6 +101,21 @@ typedef void *uPortUartHandle_t;
  */
 uPortUartHandle_t uPortUartOpen(const char *pDevName, int32_t baudRate, bool useFlowControl);
 
+/**
+ * @brief Open UART device with extra options
+ *
+ * Same as uPortUartOpen() but with U_PORT_UART_FLAG_xxx flags for tuning
+ * the device. uPortUartOpen() is the same as calling this with flags 0.
+ *
+ * @param[in]  pDevName        Device name (e.g., "/dev/ttyUSB0", "COM3", etc.)
+ * @param      baudRate        Baud rate (e.g., 115200)
+ * @param      useFlowControl  true to enable RTS/CTS hardware flow control
+ * @param      flags           Bitmask of U_PORT_UART_FLAG_xxx
+ * @return                     UART handle on success, NULL on failure
+ */
+uPortUartHandle_t uPortUartOpenEx(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags);
+
 /**
  * @brief Close UART device
  *
@@ -74,6 +131,11 @@ void uPortUartClose(uPortUartHandle_t handle);
  * Writes data to the UART device. This function should block until
  * all data is written or an error occurs.
  *
+ * When the port was opened with U_PORT_UART_FLAG_TX_QUEUE the data is only
+ * queued. If the queue is full the call waits for space for a limited time
+ * and then returns the number of bytes queued so far.
+ * The AT client fails a command with U_CX_ERROR_IO on such a short write.
+ *
  * @param[in]  handle  UART handle from uPortUartOpen()
  * @param[in]  pData   Pointer to data to write
  * @param      length  Number of bytes to write
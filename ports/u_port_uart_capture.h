@@ -0,0 +1,204 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief UART traffic capture and replay backends (POSIX)
+ *
+ * gUPortUartCaptureOps sits between the AT client and another backend and
+ * records every TX and RX byte with a microsecond timestamp to a capture
+ * file. gUPortUartReplayOps plays a capture file back to an AT client
+ * instead of a module, either with the original timing or as fast as
+ * possible, and checks that the client sends the same bytes as in the
+ * capture.
+ *
+ * Capture file format (all integers little endian):
+ * - File header: "UCXC", version (u16), header size (u16), baud rate (u32),
+ *   flags (u32, bit 0 = flow control), start time in us since the epoch (u64)
+ * - Blocks: "UCXB", payload size (u32), record count (u32), time of the
+ *   first record (u64), followed by the records. A record is the time
+ *   since the previous record in us (varint), length << 1 | direction
+ *   (varint, direction 1 = RX) and the data.
+ * - Index, written when the capture is closed: block offset (u64), time
+ *   of the first record (u64) and record count (u32) of every block,
+ *   followed by the offset of the index (u64), the number of blocks (u32)
+ *   and "UCXI".
+ *
+ * Record times are relative to the start of the capture. A file without
+ * index, e.g. after a crash, can still be read up to the last complete
+ * block.
+ */
+
+#ifndef U_PORT_UART_CAPTURE_H
+#define U_PORT_UART_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "u_port_uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_PORT_UART_CAPTURE_BLOCK_SIZE
+/** Max payload size of a capture file block */
+# define U_PORT_UART_CAPTURE_BLOCK_SIZE  16384
+#endif
+
+#ifndef U_PORT_UART_CAPTURE_MERGE_US
+/** Data in the same direction within this time of the previous data is
+    added to the same record */
+# define U_PORT_UART_CAPTURE_MERGE_US  100
+#endif
+
+#ifndef U_PORT_UART_CAPTURE_FLUSH_MS
+/** Max time a record stays in memory before its block is written to the file */
+# define U_PORT_UART_CAPTURE_FLUSH_MS  1000
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Capture file reader handle */
+typedef void *uPortUartCaptureReader_t;
+
+typedef struct {
+    const uPortUartOps_t *pInnerOps; /**< Backend that is recorded (NULL = Linux UART port) */
+    const char *pFileName;           /**< Capture file, overwritten if it exists */
+} uPortUartCaptureConfig_t;
+
+typedef struct {
+    int32_t baudRate;       /**< Baud rate the capture was opened with */
+    bool flowControl;       /**< Flow control the capture was opened with */
+    uint64_t startTimeUs;   /**< Start of the capture in us since the epoch */
+    size_t blockCount;      /**< Number of complete blocks */
+    bool indexed;           /**< The file has an index, i.e. the capture was closed */
+} uPortUartCaptureInfo_t;
+
+/** One record of a capture file, see uPortUartCaptureReaderNext() */
+typedef struct {
+    uint64_t timeUs;        /**< Time since the start of the capture */
+    bool rx;                /**< true for data from the module, false for data to it */
+    const uint8_t *pData;   /**< Valid until the next call with the same reader */
+    size_t length;
+} uPortUartCaptureRecord_t;
+
+typedef struct {
+    bool maxSpeed;          /**< Deliver RX data as fast as the client reads it instead
+                                 of with the original timing */
+    bool rxOnly;            /**< Don't wait for or check the client TX, e.g. for using a
+                                 capture from another application as RX workload */
+} uPortUartReplayConfig_t;
+
+typedef struct {
+    size_t txBytes;         /**< Bytes written by the client */
+    size_t txMismatches;    /**< Written bytes that differ from the capture */
+    int64_t firstMismatch;  /**< TX offset of the first differing byte, -1 if none */
+    size_t txExtraBytes;    /**< Bytes written after the end of the captured TX */
+    size_t rxBytes;         /**< Captured RX bytes delivered to the client */
+    bool complete;          /**< All captured TX was written and all RX delivered */
+} uPortUartReplayStats_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Capture backend for uCxAtClientConfig_t.pUartOps, see uPortUartCaptureConfigure() */
+extern const uPortUartOps_t gUPortUartCaptureOps;
+
+/** Replay backend for uCxAtClientConfig_t.pUartOps, the device name is the capture file */
+extern const uPortUartOps_t gUPortUartReplayOps;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+ * @brief Set the configuration used by the following gUPortUartCaptureOps.openFn calls
+ *
+ * uPortUartOps_t has no context argument so the configuration is global.
+ * The device name, baud rate, flow control and flags are passed on to the
+ * inner backend.
+ *
+ * @param[in]  pConfig  Capture configuration, NULL for the defaults
+ */
+void uPortUartCaptureConfigure(const uPortUartCaptureConfig_t *pConfig);
+
+/**
+ * @brief Set the configuration used by the following gUPortUartReplayOps.openFn calls
+ *
+ * @param[in]  pConfig  Replay configuration, NULL for the defaults
+ */
+void uPortUartReplayConfigure(const uPortUartReplayConfig_t *pConfig);
+
+/**
+ * @brief Get the statistics of a replay
+ *
+ * @param[in]  handle  Handle returned by gUPortUartReplayOps.openFn
+ * @param[out] pStats  Statistics
+ */
+void uPortUartReplayGetStats(uPortUartHandle_t handle, uPortUartReplayStats_t *pStats);
+
+/**
+ * @brief Open a capture file for reading
+ *
+ * @param[in]  pFileName  Capture file
+ * @param[out] pInfo      Information from the file header (may be NULL)
+ * @return                Reader handle on success, NULL on failure
+ */
+uPortUartCaptureReader_t uPortUartCaptureReaderOpen(const char *pFileName,
+                                                    uPortUartCaptureInfo_t *pInfo);
+
+/**
+ * @brief Get the next record
+ *
+ * @param[in]  reader   Reader handle
+ * @param[out] pRecord  Record
+ * @return              1 on success, 0 at the end of the capture, negative
+ *                      if the file is corrupt
+ */
+int32_t uPortUartCaptureReaderNext(uPortUartCaptureReader_t reader,
+                                   uPortUartCaptureRecord_t *pRecord);
+
+/**
+ * @brief Move to the first record at or after a time
+ *
+ * Uses the index to find the block, so only one block is read.
+ *
+ * @param[in]  reader  Reader handle
+ * @param      timeUs  Time since the start of the capture
+ * @return             0 on success, negative on error
+ */
+int32_t uPortUartCaptureReaderSeek(uPortUartCaptureReader_t reader, uint64_t timeUs);
+
+/**
+ * @brief Close a reader
+ *
+ * @param[in]  reader  Reader handle
+ */
+void uPortUartCaptureReaderClose(uPortUartCaptureReader_t reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U_PORT_UART_CAPTURE_H
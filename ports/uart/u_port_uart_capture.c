@@ -0,0 +1,1019 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief UART traffic capture and replay backends for POSIX systems.
+ *
+ * The capture backend collects the data of consecutive calls in the same
+ * direction in one record and the records in a block, so that the AT
+ * parser reading one byte at a time doesn't cost one record per byte.
+ * A block is written to the file when it is full or when its first record
+ * is older than U_PORT_UART_CAPTURE_FLUSH_MS.
+ *
+ * The replay backend reads the capture file with two readers, one for the
+ * TX records that the client writes are compared with and one for the RX
+ * records. An RX record is only delivered when the client has written all
+ * TX that was captured before it, so responses and URCs come in the same
+ * order relative to the commands as in the capture, independent of the
+ * timing. With the original timing an RX record is in addition delayed by
+ * its captured time since the previous record.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "u_port_uart.h"
+#include "u_port_uart_capture.h"
+#include "u_port_uart_linux.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define FILE_MAGIC        "UCXC"
+#define BLOCK_MAGIC       "UCXB"
+#define INDEX_MAGIC       "UCXI"
+#define FILE_VERSION      1
+#define FILE_HEADER_SIZE  24
+#define BLOCK_HEADER_SIZE 20
+#define INDEX_ENTRY_SIZE  20
+#define TRAILER_SIZE      16
+
+#define FLAG_FLOW_CONTROL  (1u << 0)
+
+/* Max size of the two varints in front of the record data */
+#define MAX_RECORD_HEADER  20
+#define MAX_RECORD_SIZE    (U_PORT_UART_CAPTURE_BLOCK_SIZE - MAX_RECORD_HEADER)
+
+/* Replay waits shorter than this are done by yielding instead of sleeping,
+   as a sleep can take tens of microseconds longer than asked for */
+#define SPIN_WAIT_NS       200000
+
+/* Sanity limit for block payloads when reading a file */
+#define MAX_BLOCK_SIZE     (16 * 1024 * 1024)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+typedef struct {
+    uint64_t offset;        /**< File offset of the block header */
+    uint64_t firstTimeUs;   /**< Time of the first record */
+    uint32_t recordCount;
+} blockIndex_t;
+
+typedef struct {
+    const uPortUartOps_t *pInner;
+    uPortUartHandle_t inner;
+    FILE *pFile;
+    pthread_mutex_t mutex;
+    int64_t startNs;
+    bool error;             /**< Writing the file failed, the capture is incomplete */
+    uint64_t fileOffset;
+    blockIndex_t *pIndex;
+    size_t indexCount;
+    size_t indexCapacity;
+    // Block being collected
+    size_t blockLength;
+    uint32_t blockRecords;
+    uint64_t blockTimeUs;
+    uint64_t lastTimeUs;    /**< Time of the previous record in the block */
+    uint8_t block[U_PORT_UART_CAPTURE_BLOCK_SIZE];
+    // Record being collected
+    bool pending;
+    bool pendingRx;
+    uint64_t pendingTimeUs;
+    uint64_t pendingLastUs; /**< Time data was last added to the record */
+    size_t pendingLength;
+    uint8_t pendingData[MAX_RECORD_SIZE];
+} captureHandle;
+
+typedef struct {
+    FILE *pFile;
+    uPortUartCaptureInfo_t info;
+    blockIndex_t *pIndex;
+    size_t nextBlock;
+    uint8_t *pBlock;
+    size_t blockSize;       /**< Size of the pBlock allocation */
+    size_t blockLength;
+    size_t blockPos;
+    uint32_t recordsLeft;
+    uint64_t timeUs;        /**< Time of the previous record */
+    bool havePeek;          /**< peek is returned by the next call, set by seek */
+    uPortUartCaptureRecord_t peek;
+} captureReader;
+
+/** Position in the records of one direction */
+typedef struct {
+    uPortUartCaptureReader_t reader;
+    uPortUartCaptureRecord_t record;
+    size_t pos;             /**< Bytes of record already written or delivered */
+    bool end;
+} replayCursor_t;
+
+typedef struct {
+    uPortUartReplayConfig_t config;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;    /**< Signaled when the client writes */
+    replayCursor_t tx;
+    replayCursor_t rx;
+    size_t rxTxNeeded;      /**< Captured TX bytes before the current RX record */
+    size_t txCaptured;      /**< Captured TX bytes passed by the TX cursor */
+    int64_t anchorNs;       /**< Replay time that corresponds to anchorUs */
+    uint64_t anchorUs;      /**< Captured time of the last TX or RX the replay has reached */
+    uPortUartReplayStats_t stats;
+} replayHandle;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uPortUartCaptureConfig_t gCaptureConfig;
+static uPortUartReplayConfig_t gReplayConfig;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static int64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+// Waits on a condition that uses CLOCK_MONOTONIC, the mutex must be locked
+static void condWaitUntil(pthread_cond_t *pCond, pthread_mutex_t *pMutex, int64_t deadlineNs)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadlineNs / 1000000000);
+    ts.tv_nsec = (long)(deadlineNs % 1000000000);
+    pthread_cond_timedwait(pCond, pMutex, &ts);
+}
+
+static void putLe(uint8_t *pBuf, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        pBuf[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t getLe(const uint8_t *pBuf, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value |= (uint64_t)pBuf[i] << (8 * i);
+    }
+    return value;
+}
+
+static size_t putVarint(uint8_t *pBuf, uint64_t value)
+{
+    size_t length = 0;
+    while (value >= 0x80) {
+        pBuf[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    pBuf[length++] = (uint8_t)value;
+    return length;
+}
+
+// Returns false if the varint doesn't end before pEnd
+static bool getVarint(const uint8_t **ppBuf, const uint8_t *pEnd, uint64_t *pValue)
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; (*ppBuf < pEnd) && (shift < 64); shift += 7) {
+        uint8_t byte = *(*ppBuf)++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *pValue = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Capture backend
+
+static uint64_t captureTimeUs(const captureHandle *pCapture)
+{
+    return (uint64_t)((getTimeNs() - pCapture->startNs) / 1000);
+}
+
+static void writeFile(captureHandle *pCapture, const void *pData, size_t length)
+{
+    if (!pCapture->error && (fwrite(pData, 1, length, pCapture->pFile) != length)) {
+        pCapture->error = true;
+    }
+    pCapture->fileOffset += length;
+}
+
+static void flushBlock(captureHandle *pCapture)
+{
+    uint8_t header[BLOCK_HEADER_SIZE];
+
+    if (pCapture->blockRecords == 0) {
+        return;
+    }
+    if (pCapture->indexCount == pCapture->indexCapacity) {
+        size_t capacity = (pCapture->indexCapacity > 0) ? (pCapture->indexCapacity * 2) : 64;
+        blockIndex_t *pIndex = realloc(pCapture->pIndex, capacity * sizeof(blockIndex_t));
+        if (pIndex == NULL) {
+            pCapture->error = true;
+        } else {
+            pCapture->pIndex = pIndex;
+            pCapture->indexCapacity = capacity;
+        }
+    }
+    if (pCapture->indexCount < pCapture->indexCapacity) {
+        blockIndex_t *pEntry = &pCapture->pIndex[pCapture->indexCount++];
+        pEntry->offset = pCapture->fileOffset;
+        pEntry->firstTimeUs = pCapture->blockTimeUs;
+        pEntry->recordCount = pCapture->blockRecords;
+    }
+
+    memcpy(header, BLOCK_MAGIC, 4);
+    putLe(&header[4], pCapture->blockLength, 4);
+    putLe(&header[8], pCapture->blockRecords, 4);
+    putLe(&header[12], pCapture->blockTimeUs, 8);
+    writeFile(pCapture, header, sizeof(header));
+    writeFile(pCapture, pCapture->block, pCapture->blockLength);
+    // Complete blocks survive a crash of the application
+    fflush(pCapture->pFile);
+    pCapture->blockLength = 0;
+    pCapture->blockRecords = 0;
+}
+
+static void finishRecord(captureHandle *pCapture)
+{
+    uint8_t header[MAX_RECORD_HEADER];
+    size_t headerLength;
+
+    if (!pCapture->pending) {
+        return;
+    }
+    if ((pCapture->blockLength + MAX_RECORD_HEADER + pCapture->pendingLength) >
+        sizeof(pCapture->block)) {
+        flushBlock(pCapture);
+    }
+    if (pCapture->blockRecords == 0) {
+        pCapture->blockTimeUs = pCapture->pendingTimeUs;
+        pCapture->lastTimeUs = pCapture->pendingTimeUs;
+    }
+    headerLength = putVarint(header, pCapture->pendingTimeUs - pCapture->lastTimeUs);
+    headerLength += putVarint(&header[headerLength],
+                              ((uint64_t)pCapture->pendingLength << 1) |
+                              (pCapture->pendingRx ? 1u : 0u));
+    memcpy(&pCapture->block[pCapture->blockLength], header, headerLength);
+    pCapture->blockLength += headerLength;
+    memcpy(&pCapture->block[pCapture->blockLength], pCapture->pendingData,
+           pCapture->pendingLength);
+    pCapture->blockLength += pCapture->pendingLength;
+    pCapture->blockRecords++;
+    pCapture->lastTimeUs = pCapture->pendingTimeUs;
+    pCapture->pending = false;
+}
+
+// Writes the data to the file when it has been in memory for too long, the mutex must be locked
+static void checkFlush(captureHandle *pCapture, uint64_t nowUs)
+{
+    uint64_t oldestUs = (pCapture->blockRecords > 0) ? pCapture->blockTimeUs :
+                        pCapture->pendingTimeUs;
+    if ((pCapture->pending || (pCapture->blockRecords > 0)) &&
+        ((nowUs - oldestUs) >= ((uint64_t)U_PORT_UART_CAPTURE_FLUSH_MS * 1000))) {
+        finishRecord(pCapture);
+        flushBlock(pCapture);
+    }
+}
+
+static void captureData(captureHandle *pCapture, bool rx, const uint8_t *pData, size_t length)
+{
+    pthread_mutex_lock(&pCapture->mutex);
+    // The time is taken with the mutex locked so that the records are in time order
+    uint64_t nowUs = captureTimeUs(pCapture);
+    while (length > 0) {
+        if (pCapture->pending &&
+            ((pCapture->pendingRx != rx) ||
+             ((nowUs - pCapture->pendingLastUs) > U_PORT_UART_CAPTURE_MERGE_US) ||
+             (pCapture->pendingLength == sizeof(pCapture->pendingData)))) {
+            finishRecord(pCapture);
+        }
+        if (!pCapture->pending) {
+            pCapture->pending = true;
+            pCapture->pendingRx = rx;
+            pCapture->pendingTimeUs = nowUs;
+            pCapture->pendingLength = 0;
+        }
+        size_t count = sizeof(pCapture->pendingData) - pCapture->pendingLength;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(&pCapture->pendingData[pCapture->pendingLength], pData, count);
+        pCapture->pendingLength += count;
+        pCapture->pendingLastUs = nowUs;
+        pData += count;
+        length -= count;
+    }
+    checkFlush(pCapture, nowUs);
+    pthread_mutex_unlock(&pCapture->mutex);
+}
+
+static bool writeFileHeader(captureHandle *pCapture, int32_t baudRate, bool useFlowControl)
+{
+    uint8_t header[FILE_HEADER_SIZE];
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    memcpy(header, FILE_MAGIC, 4);
+    putLe(&header[4], FILE_VERSION, 2);
+    putLe(&header[6], FILE_HEADER_SIZE, 2);
+    putLe(&header[8], (uint32_t)baudRate, 4);
+    putLe(&header[12], useFlowControl ? FLAG_FLOW_CONTROL : 0, 4);
+    putLe(&header[16], ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000), 8);
+    writeFile(pCapture, header, sizeof(header));
+    return !pCapture->error;
+}
+
+static void writeIndex(captureHandle *pCapture)
+{
+    uint8_t entry[INDEX_ENTRY_SIZE];
+    uint8_t trailer[TRAILER_SIZE];
+    uint64_t indexOffset = pCapture->fileOffset;
+
+    for (size_t i = 0; i < pCapture->indexCount; i++) {
+        putLe(&entry[0], pCapture->pIndex[i].offset, 8);
+        putLe(&entry[8], pCapture->pIndex[i].firstTimeUs, 8);
+        putLe(&entry[16], pCapture->pIndex[i].recordCount, 4);
+        writeFile(pCapture, entry, sizeof(entry));
+    }
+    putLe(&trailer[0], indexOffset, 8);
+    putLe(&trailer[8], pCapture->indexCount, 4);
+    memcpy(&trailer[12], INDEX_MAGIC, 4);
+    writeFile(pCapture, trailer, sizeof(trailer));
+}
+
+static uPortUartHandle_t captureOpen(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                     uint32_t flags)
+{
+    if (gCaptureConfig.pFileName == NULL) {
+        return NULL;
+    }
+    captureHandle *pCapture = calloc(1, sizeof(captureHandle));
+    if (pCapture == NULL) {
+        return NULL;
+    }
+    pCapture->pInner = (gCaptureConfig.pInnerOps != NULL) ? gCaptureConfig.pInnerOps :
+                       &gUPortUartLinuxOps;
+    pCapture->pFile = fopen(gCaptureConfig.pFileName, "wb");
+    if (pCapture->pFile == NULL) {
+        free(pCapture);
+        return NULL;
+    }
+    pCapture->startNs = getTimeNs();
+    if (!writeFileHeader(pCapture, baudRate, useFlowControl)) {
+        fclose(pCapture->pFile);
+        free(pCapture);
+        return NULL;
+    }
+    pCapture->inner = pCapture->pInner->openFn(pDevName, baudRate, useFlowControl, flags);
+    if (pCapture->inner == NULL) {
+        fclose(pCapture->pFile);
+        free(pCapture);
+        return NULL;
+    }
+    pthread_mutex_init(&pCapture->mutex, NULL);
+    return pCapture;
+}
+
+static void captureClose(uPortUartHandle_t handle)
+{
+    captureHandle *pCapture = (captureHandle *)handle;
+    if (pCapture == NULL) {
+        return;
+    }
+    pCapture->pInner->closeFn(pCapture->inner);
+    finishRecord(pCapture);
+    flushBlock(pCapture);
+    writeIndex(pCapture);
+    fclose(pCapture->pFile);
+    pthread_mutex_destroy(&pCapture->mutex);
+    free(pCapture->pIndex);
+    free(pCapture);
+}
+
+static int32_t captureWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    captureHandle *pCapture = (captureHandle *)handle;
+    if ((pCapture == NULL) || (pData == NULL)) {
+        return -1;
+    }
+    int32_t written = pCapture->pInner->writeFn(pCapture->inner, pData, length);
+    if (written > 0) {
+        captureData(pCapture, false, (const uint8_t *)pData, (size_t)written);
+    }
+    return written;
+}
+
+static int32_t captureWritev(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov,
+                             size_t iovCount)
+{
+    captureHandle *pCapture = (captureHandle *)handle;
+    int32_t written = 0;
+
+    if ((pCapture == NULL) || (pIov == NULL)) {
+        return -1;
+    }
+    if ((pCapture->pInner->caps & U_PORT_UART_CAP_WRITEV) == 0) {
+        for (size_t i = 0; i < iovCount; i++) {
+            int32_t ret = captureWrite(handle, pIov[i].pData, pIov[i].length);
+            if (ret < 0) {
+                return ret;
+            }
+            written += ret;
+            if ((size_t)ret < pIov[i].length) {
+                break;
+            }
+        }
+        return written;
+    }
+    written = pCapture->pInner->writevFn(pCapture->inner, pIov, iovCount);
+    size_t remaining = (written > 0) ? (size_t)written : 0;
+    for (size_t i = 0; (i < iovCount) && (remaining > 0); i++) {
+        size_t length = (pIov[i].length < remaining) ? pIov[i].length : remaining;
+        captureData(pCapture, false, (const uint8_t *)pIov[i].pData, length);
+        remaining -= length;
+    }
+    return written;
+}
+
+static int32_t captureRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    captureHandle *pCapture = (captureHandle *)handle;
+    if ((pCapture == NULL) || (pData == NULL)) {
+        return -1;
+    }
+    int32_t count = pCapture->pInner->readFn(pCapture->inner, pData, length, timeoutMs);
+    if (count > 0) {
+        captureData(pCapture, true, (const uint8_t *)pData, (size_t)count);
+    } else {
+        // The client keeps polling an idle line, which writes out old data
+        pthread_mutex_lock(&pCapture->mutex);
+        checkFlush(pCapture, captureTimeUs(pCapture));
+        pthread_mutex_unlock(&pCapture->mutex);
+    }
+    return count;
+}
+
+static int32_t captureGetFd(uPortUartHandle_t handle)
+{
+    captureHandle *pCapture = (captureHandle *)handle;
+    if ((pCapture == NULL) || ((pCapture->pInner->caps & U_PORT_UART_CAP_POLL_FD) == 0)) {
+        return -1;
+    }
+    return pCapture->pInner->getFdFn(pCapture->inner);
+}
+
+// Capture file reader
+
+static bool readAt(FILE *pFile, uint64_t offset, void *pData, size_t length)
+{
+    return (fseeko(pFile, (off_t)offset, SEEK_SET) == 0) &&
+           (fread(pData, 1, length, pFile) == length);
+}
+
+static bool parseBlockHeader(const uint8_t *pHeader, uint32_t *pLength, blockIndex_t *pEntry)
+{
+    if (memcmp(pHeader, BLOCK_MAGIC, 4) != 0) {
+        return false;
+    }
+    *pLength = (uint32_t)getLe(&pHeader[4], 4);
+    pEntry->recordCount = (uint32_t)getLe(&pHeader[8], 4);
+    pEntry->firstTimeUs = getLe(&pHeader[12], 8);
+    return (*pLength <= MAX_BLOCK_SIZE);
+}
+
+static bool addIndexEntry(captureReader *pReader, size_t *pCapacity, const blockIndex_t *pEntry)
+{
+    if (pReader->info.blockCount == *pCapacity) {
+        size_t capacity = (*pCapacity > 0) ? (*pCapacity * 2) : 64;
+        blockIndex_t *pIndex = realloc(pReader->pIndex, capacity * sizeof(blockIndex_t));
+        if (pIndex == NULL) {
+            return false;
+        }
+        pReader->pIndex = pIndex;
+        *pCapacity = capacity;
+    }
+    pReader->pIndex[pReader->info.blockCount++] = *pEntry;
+    return true;
+}
+
+static bool loadIndex(captureReader *pReader, uint64_t fileSize)
+{
+    uint8_t trailer[TRAILER_SIZE];
+    uint8_t entry[INDEX_ENTRY_SIZE];
+
+    if ((fileSize < (FILE_HEADER_SIZE + TRAILER_SIZE)) ||
+        !readAt(pReader->pFile, fileSize - TRAILER_SIZE, trailer, sizeof(trailer)) ||
+        (memcmp(&trailer[12], INDEX_MAGIC, 4) != 0)) {
+        return false;
+    }
+    uint64_t indexOffset = getLe(&trailer[0], 8);
+    size_t blockCount = (size_t)getLe(&trailer[8], 4);
+    if ((indexOffset + ((uint64_t)blockCount * INDEX_ENTRY_SIZE) + TRAILER_SIZE) != fileSize) {
+        return false;
+    }
+    pReader->pIndex = malloc((blockCount > 0 ? blockCount : 1) * sizeof(blockIndex_t));
+    if ((pReader->pIndex == NULL) ||
+        (fseeko(pReader->pFile, (off_t)indexOffset, SEEK_SET) != 0)) {
+        return false;
+    }
+    for (size_t i = 0; i < blockCount; i++) {
+        if (fread(entry, 1, sizeof(entry), pReader->pFile) != sizeof(entry)) {
+            return false;
+        }
+        pReader->pIndex[i].offset = getLe(&entry[0], 8);
+        pReader->pIndex[i].firstTimeUs = getLe(&entry[8], 8);
+        pReader->pIndex[i].recordCount = (uint32_t)getLe(&entry[16], 4);
+    }
+    pReader->info.blockCount = blockCount;
+    pReader->info.indexed = true;
+    return true;
+}
+
+// Builds the index from the blocks of a file that wasn't closed properly
+static bool scanBlocks(captureReader *pReader, uint64_t offset, uint64_t fileSize)
+{
+    uint8_t header[BLOCK_HEADER_SIZE];
+    size_t capacity = 0;
+    blockIndex_t entry;
+    uint32_t length;
+
+    free(pReader->pIndex);
+    pReader->pIndex = NULL;
+    pReader->info.blockCount = 0;
+    while (((offset + BLOCK_HEADER_SIZE) <= fileSize) &&
+           readAt(pReader->pFile, offset, header, sizeof(header)) &&
+           parseBlockHeader(header, &length, &entry) &&
+           ((offset + BLOCK_HEADER_SIZE + length) <= fileSize)) {
+        entry.offset = offset;
+        if (!addIndexEntry(pReader, &capacity, &entry)) {
+            return false;
+        }
+        offset += BLOCK_HEADER_SIZE + length;
+    }
+    return true;
+}
+
+// Returns 1 if a block was loaded, 0 at the end and negative on error
+static int32_t loadBlock(captureReader *pReader, size_t blockIndex)
+{
+    uint8_t header[BLOCK_HEADER_SIZE];
+    blockIndex_t entry;
+    uint32_t length;
+
+    if (blockIndex >= pReader->info.blockCount) {
+        return 0;
+    }
+    if (!readAt(pReader->pFile, pReader->pIndex[blockIndex].offset, header, sizeof(header)) ||
+        !parseBlockHeader(header, &length, &entry)) {
+        return -1;
+    }
+    if (length > pReader->blockSize) {
+        uint8_t *pBlock = realloc(pReader->pBlock, length);
+        if (pBlock == NULL) {
+            return -1;
+        }
+        pReader->pBlock = pBlock;
+        pReader->blockSize = length;
+    }
+    if (fread(pReader->pBlock, 1, length, pReader->pFile) != length) {
+        return -1;
+    }
+    pReader->nextBlock = blockIndex + 1;
+    pReader->blockLength = length;
+    pReader->blockPos = 0;
+    pReader->recordsLeft = entry.recordCount;
+    pReader->timeUs = entry.firstTimeUs;
+    pReader->havePeek = false;
+    return 1;
+}
+
+// Replay backend
+
+static bool cursorNext(replayHandle *pReplay, replayCursor_t *pCursor, bool rx)
+{
+    uPortUartCaptureRecord_t record;
+
+    pCursor->pos = 0;
+    while (uPortUartCaptureReaderNext(pCursor->reader, &record) > 0) {
+        if (record.rx == rx) {
+            pCursor->record = record;
+            return true;
+        }
+        if (rx) {
+            // The RX record has to wait for this TX
+            pReplay->rxTxNeeded += record.length;
+        }
+    }
+    pCursor->end = true;
+    return false;
+}
+
+// Moves the replay time forward when the replay reaches a later record, the mutex must be locked
+static void setAnchor(replayHandle *pReplay, int64_t timeNs, uint64_t timeUs)
+{
+    if (timeUs >= pReplay->anchorUs) {
+        pReplay->anchorNs = timeNs;
+        pReplay->anchorUs = timeUs;
+    }
+}
+
+static void updateComplete(replayHandle *pReplay)
+{
+    pReplay->stats.complete = (pReplay->config.rxOnly || pReplay->tx.end) && pReplay->rx.end;
+}
+
+static void replayDestroy(replayHandle *pReplay)
+{
+    uPortUartCaptureReaderClose(pReplay->tx.reader);
+    uPortUartCaptureReaderClose(pReplay->rx.reader);
+    free(pReplay);
+}
+
+static uPortUartHandle_t replayOpen(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                    uint32_t flags)
+{
+    (void)baudRate;
+    (void)useFlowControl;
+    (void)flags;
+
+    replayHandle *pReplay = calloc(1, sizeof(replayHandle));
+    if (pReplay == NULL) {
+        return NULL;
+    }
+    pReplay->config = gReplayConfig;
+    pReplay->stats.firstMismatch = -1;
+    pReplay->tx.reader = uPortUartCaptureReaderOpen(pDevName, NULL);
+    pReplay->rx.reader = uPortUartCaptureReaderOpen(pDevName, NULL);
+    if ((pReplay->tx.reader == NULL) || (pReplay->rx.reader == NULL)) {
+        replayDestroy(pReplay);
+        return NULL;
+    }
+    cursorNext(pReplay, &pReplay->tx, false);
+    cursorNext(pReplay, &pReplay->rx, true);
+    updateComplete(pReplay);
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pReplay->mutex, NULL);
+    pthread_cond_init(&pReplay->cond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    pReplay->anchorNs = getTimeNs();
+    return pReplay;
+}
+
+static void replayClose(uPortUartHandle_t handle)
+{
+    replayHandle *pReplay = (replayHandle *)handle;
+    if (pReplay == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&pReplay->cond);
+    pthread_mutex_destroy(&pReplay->mutex);
+    replayDestroy(pReplay);
+}
+
+// Compares the written data with the captured TX, the mutex must be locked
+static void checkTx(replayHandle *pReplay, const uint8_t *pData, size_t length)
+{
+    replayCursor_t *pTx = &pReplay->tx;
+
+    while ((length > 0) && !pTx->end) {
+        size_t count = pTx->record.length - pTx->pos;
+        if (count > length) {
+            count = length;
+        }
+        const uint8_t *pCaptured = &pTx->record.pData[pTx->pos];
+        if (memcmp(pData, pCaptured, count) != 0) {
+            for (size_t i = 0; i < count; i++) {
+                if (pData[i] != pCaptured[i]) {
+                    if (pReplay->stats.firstMismatch < 0) {
+                        pReplay->stats.firstMismatch = (int64_t)(pReplay->txCaptured + i);
+                    }
+                    pReplay->stats.txMismatches++;
+                }
+            }
+        }
+        pTx->pos += count;
+        pReplay->txCaptured += count;
+        pData += count;
+        length -= count;
+        if (pTx->pos == pTx->record.length) {
+            // Responses are timed from when the client sent the command
+            setAnchor(pReplay, getTimeNs(), pTx->record.timeUs);
+            cursorNext(pReplay, pTx, false);
+        }
+    }
+    pReplay->stats.txExtraBytes += length;
+}
+
+static int32_t replayWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    replayHandle *pReplay = (replayHandle *)handle;
+    if ((pReplay == NULL) || (pData == NULL)) {
+        return -1;
+    }
+    pthread_mutex_lock(&pReplay->mutex);
+    pReplay->stats.txBytes += length;
+    if (!pReplay->config.rxOnly) {
+        checkTx(pReplay, (const uint8_t *)pData, length);
+        updateComplete(pReplay);
+    }
+    pthread_cond_broadcast(&pReplay->cond);
+    pthread_mutex_unlock(&pReplay->mutex);
+    return (int32_t)length;
+}
+
+static int32_t replayWritev(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov,
+                            size_t iovCount)
+{
+    int32_t written = 0;
+
+    if (pIov == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < iovCount; i++) {
+        int32_t ret = replayWrite(handle, pIov[i].pData, pIov[i].length);
+        if (ret < 0) {
+            return ret;
+        }
+        written += ret;
+    }
+    return written;
+}
+
+// Returns the time the current RX record is due, the mutex must be locked
+static int64_t rxDueNs(const replayHandle *pReplay)
+{
+    uint64_t timeUs = pReplay->rx.record.timeUs;
+    if (pReplay->config.maxSpeed || (timeUs <= pReplay->anchorUs)) {
+        return 0;
+    }
+    return pReplay->anchorNs + ((int64_t)(timeUs - pReplay->anchorUs) * 1000);
+}
+
+static int32_t replayRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    replayHandle *pReplay = (replayHandle *)handle;
+    int64_t deadline = (timeoutMs < 0) ? INT64_MAX :
+                       (getTimeNs() + ((int64_t)timeoutMs * 1000000));
+    replayCursor_t *pRx = &pReplay->rx;
+    size_t count = 0;
+    bool end;
+
+    if ((pReplay == NULL) || (pData == NULL) || (length == 0)) {
+        return -1;
+    }
+    pthread_mutex_lock(&pReplay->mutex);
+    while (count < length) {
+        int64_t now = getTimeNs();
+        int64_t due = INT64_MAX;
+        if (!pRx->end &&
+            (pReplay->config.rxOnly || (pReplay->txCaptured >= pReplay->rxTxNeeded))) {
+            due = rxDueNs(pReplay);
+        }
+        if (now >= due) {
+            size_t chunk = pRx->record.length - pRx->pos;
+            if (chunk > (length - count)) {
+                chunk = length - count;
+            }
+            memcpy(&((uint8_t *)pData)[count], &pRx->record.pData[pRx->pos], chunk);
+            pRx->pos += chunk;
+            count += chunk;
+            pReplay->stats.rxBytes += chunk;
+            if (pRx->pos == pRx->record.length) {
+                if (due > 0) {
+                    setAnchor(pReplay, due, pRx->record.timeUs);
+                }
+                cursorNext(pReplay, pRx, true);
+                updateComplete(pReplay);
+            }
+        } else if ((count > 0) || (now >= deadline) || (pRx->end && (timeoutMs < 0))) {
+            break;
+        } else if ((due - now) < SPIN_WAIT_NS) {
+            pthread_mutex_unlock(&pReplay->mutex);
+            while ((getTimeNs() < due) && (getTimeNs() < deadline)) {
+                sched_yield();
+            }
+            pthread_mutex_lock(&pReplay->mutex);
+        } else {
+            // A write that releases the record wakes up early
+            condWaitUntil(&pReplay->cond, &pReplay->mutex, (due < deadline) ? due : deadline);
+        }
+    }
+    end = pRx->end;
+    pthread_mutex_unlock(&pReplay->mutex);
+    if ((count == 0) && end && (timeoutMs < 0)) {
+        // Nothing more will come, like a closed connection
+        return -1;
+    }
+    return (int32_t)count;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+const uPortUartOps_t gUPortUartCaptureOps = {
+    .openFn = captureOpen,
+    .closeFn = captureClose,
+    .writeFn = captureWrite,
+    .readFn = captureRead,
+    .writevFn = captureWritev,
+    .getFdFn = captureGetFd,
+    .caps = U_PORT_UART_CAP_POLL_FD | U_PORT_UART_CAP_WRITEV
+};
+
+const uPortUartOps_t gUPortUartReplayOps = {
+    .openFn = replayOpen,
+    .closeFn = replayClose,
+    .writeFn = replayWrite,
+    .readFn = replayRead,
+    .writevFn = replayWritev,
+    .getFdFn = NULL,
+    .caps = U_PORT_UART_CAP_WRITEV
+};
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+void uPortUartCaptureConfigure(const uPortUartCaptureConfig_t *pConfig)
+{
+    if (pConfig != NULL) {
+        gCaptureConfig = *pConfig;
+    } else {
+        memset(&gCaptureConfig, 0, sizeof(gCaptureConfig));
+    }
+}
+
+void uPortUartReplayConfigure(const uPortUartReplayConfig_t *pConfig)
+{
+    if (pConfig != NULL) {
+        gReplayConfig = *pConfig;
+    } else {
+        memset(&gReplayConfig, 0, sizeof(gReplayConfig));
+    }
+}
+
+void uPortUartReplayGetStats(uPortUartHandle_t handle, uPortUartReplayStats_t *pStats)
+{
+    replayHandle *pReplay = (replayHandle *)handle;
+
+    pthread_mutex_lock(&pReplay->mutex);
+    *pStats = pReplay->stats;
+    pthread_mutex_unlock(&pReplay->mutex);
+}
+
+uPortUartCaptureReader_t uPortUartCaptureReaderOpen(const char *pFileName,
+                                                    uPortUartCaptureInfo_t *pInfo)
+{
+    uint8_t header[FILE_HEADER_SIZE];
+
+    if (pFileName == NULL) {
+        return NULL;
+    }
+    captureReader *pReader = calloc(1, sizeof(captureReader));
+    if (pReader == NULL) {
+        return NULL;
+    }
+    pReader->pFile = fopen(pFileName, "rb");
+    if ((pReader->pFile == NULL) || !readAt(pReader->pFile, 0, header, sizeof(header)) ||
+        (memcmp(header, FILE_MAGIC, 4) != 0) || (getLe(&header[4], 2) != FILE_VERSION) ||
+        (getLe(&header[6], 2) < FILE_HEADER_SIZE) ||
+        (fseeko(pReader->pFile, 0, SEEK_END) != 0)) {
+        uPortUartCaptureReaderClose(pReader);
+        return NULL;
+    }
+    uint64_t headerSize = getLe(&header[6], 2);
+    uint64_t fileSize = (uint64_t)ftello(pReader->pFile);
+    pReader->info.baudRate = (int32_t)getLe(&header[8], 4);
+    pReader->info.flowControl = (getLe(&header[12], 4) & FLAG_FLOW_CONTROL) != 0;
+    pReader->info.startTimeUs = getLe(&header[16], 8);
+    if (!loadIndex(pReader, fileSize) && !scanBlocks(pReader, headerSize, fileSize)) {
+        uPortUartCaptureReaderClose(pReader);
+        return NULL;
+    }
+    if (pInfo != NULL) {
+        *pInfo = pReader->info;
+    }
+    return pReader;
+}
+
+int32_t uPortUartCaptureReaderNext(uPortUartCaptureReader_t reader,
+                                   uPortUartCaptureRecord_t *pRecord)
+{
+    captureReader *pReader = (captureReader *)reader;
+    uint64_t delta;
+    uint64_t lengthDir;
+
+    if ((pReader == NULL) || (pRecord == NULL)) {
+        return -1;
+    }
+    if (pReader->havePeek) {
+        pReader->havePeek = false;
+        *pRecord = pReader->peek;
+        return 1;
+    }
+    while (pReader->recordsLeft == 0) {
+        int32_t ret = loadBlock(pReader, pReader->nextBlock);
+        if (ret <= 0) {
+            return ret;
+        }
+    }
+    const uint8_t *pPos = &pReader->pBlock[pReader->blockPos];
+    const uint8_t *pEnd = &pReader->pBlock[pReader->blockLength];
+    if (!getVarint(&pPos, pEnd, &delta) || !getVarint(&pPos, pEnd, &lengthDir) ||
+        ((lengthDir >> 1) > (uint64_t)(pEnd - pPos))) {
+        return -1;
+    }
+    pReader->timeUs += delta;
+    pRecord->timeUs = pReader->timeUs;
+    pRecord->rx = (lengthDir & 1) != 0;
+    pRecord->pData = pPos;
+    pRecord->length = (size_t)(lengthDir >> 1);
+    pReader->blockPos = (size_t)(pPos - pReader->pBlock) + pRecord->length;
+    pReader->recordsLeft--;
+    return 1;
+}
+
+int32_t uPortUartCaptureReaderSeek(uPortUartCaptureReader_t reader, uint64_t timeUs)
+{
+    captureReader *pReader = (captureReader *)reader;
+    size_t low = 0;
+    size_t high;
+    int32_t ret;
+
+    if (pReader == NULL) {
+        return -1;
+    }
+    if (pReader->info.blockCount == 0) {
+        pReader->recordsLeft = 0;
+        pReader->havePeek = false;
+        return 0;
+    }
+    // Last block that starts at or before timeUs
+    high = pReader->info.blockCount - 1;
+    while (low < high) {
+        size_t mid = (low + high + 1) / 2;
+        if (pReader->pIndex[mid].firstTimeUs <= timeUs) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    ret = loadBlock(pReader, low);
+    if (ret < 0) {
+        return ret;
+    }
+    do {
+        ret = uPortUartCaptureReaderNext(reader, &pReader->peek);
+    } while ((ret > 0) && (pReader->peek.timeUs < timeUs));
+    pReader->havePeek = (ret > 0);
+    return (ret < 0) ? ret : 0;
+}
+
+void uPortUartCaptureReaderClose(uPortUartCaptureReader_t reader)
+{
+    captureReader *pReader = (captureReader *)reader;
+    if (pReader == NULL) {
+        return;
+    }
+    if (pReader->pFile != NULL) {
+        fclose(pReader->pFile);
+    }
+    free(pReader->pIndex);
+    free(pReader->pBlock);
+    free(pReader);
+}
@@ -16,6 +16,22 @@
 
 /** @file
  * @brief Linux UART port implementation using termios.
+ *
+ * The port is configured with the termios2 ioctls so that any baud rate
+ * supported by the UART driver can be used (BOTHER), not only the ones
+ * with a Bxxx constant.
+ *
+ * Received data is read from the driver in large chunks into a read-ahead
+ * buffer, so the many small reads done by the AT parser and XMODEM are
+ * served from memory instead of costing one system call each.
+ *
+ * With U_PORT_UART_FLAG_TX_QUEUE uPortUartWrite() only copies the data to a
+ * TX queue that a writer thread drains, so a caller is not blocked while
+ * the device can't accept data (e.g. CTS deasserted).
+ *
+ * Besides tty devices the port can connect to a module behind a socket,
+ * e.g. ser2net or a simulator, using "tcp://host:port" or "unix:///path"
+ * as device name. The baud rate and the tty flags are ignored then.
  */
 
 #include <stdint.h>
@@ -25,24 +41,94 @@
 #include <string.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #include <unistd.h>
-#include <termios.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <asm/termbits.h>  // struct termios2, must not be mixed with <termios.h>
+#include <linux/serial.h>  // struct serial_struct, ASYNC_LOW_LATENCY
 
 #include "u_port_uart.h"
+#include "u_port_uart_linux.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_PORT_UART_READ_AHEAD_SIZE
+/** Size of the read-ahead buffer of each UART handle (0 = disabled) */
+# define U_PORT_UART_READ_AHEAD_SIZE  1024
+#endif
+
+#ifndef U_PORT_UART_TX_QUEUE_SIZE
+/** Size of the TX queue used with U_PORT_UART_FLAG_TX_QUEUE */
+# define U_PORT_UART_TX_QUEUE_SIZE  4096
+#endif
+
+#ifndef U_PORT_UART_TX_QUEUE_TIMEOUT_MS
+/** Max time uPortUartWrite() waits for space in a full TX queue, and
+    uPortUartClose() waits for the TX queue to drain */
+# define U_PORT_UART_TX_QUEUE_TIMEOUT_MS  1000
+#endif
+
+#ifndef U_PORT_UART_CONNECT_TIMEOUT_MS
+/** Timeout for connecting tcp:// and unix:// devices */
+# define U_PORT_UART_CONNECT_TIMEOUT_MS  5000
+#endif
+
+#define TCP_PREFIX   "tcp://"
+#define UNIX_PREFIX  "unix://"
+
+/* Max difference between the requested baud rate and the one the driver
+   reports back. Drivers round to the nearest divisor, which a UART on the
+   other end tolerates, but some keep the old rate or fall back to a default
+   for rates they can't do. */
+#define BAUD_RATE_TOLERANCE_PERCENT  2
+
+/* Max number of buffers passed to one writev() */
+#define MAX_IOV  16
+
+/* Interval for the writer thread to check for termination while the
+   device doesn't accept data */
+#define TX_POLL_INTERVAL_MS  100
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** TX queue drained by a writer thread.
+ */
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t dataCond;   /**< Signaled when data is queued or on termination */
+    pthread_cond_t spaceCond;  /**< Signaled when the writer has made room */
+    size_t head;               /**< Position of the first queued byte */
+    size_t count;              /**< Number of queued bytes */
+    bool terminate;
+    bool error;                /**< A write() failed, the port is unusable */
+    uPortUartTxStats_t stats;
+    uint8_t buf[U_PORT_UART_TX_QUEUE_SIZE];
+} uPortUartTxQueue;
+
 /** Structure representing a UART handle.
  */
 typedef struct {
-    int fd;  /**< File descriptor for the UART device */
+    int fd;  /**< File descriptor for the UART device or socket */
+    bool isSocket;  /**< Opened from a tcp:// or unix:// device name */
+    uPortUartTxQueue *pTxQueue;  /**< TX queue, NULL when writing directly */
+#if U_PORT_UART_READ_AHEAD_SIZE > 0
+    size_t rxPos;    /**< Position of the first unread byte in rxBuf */
+    size_t rxCount;  /**< Number of unread bytes in rxBuf */
+    uint8_t rxBuf[U_PORT_UART_READ_AHEAD_SIZE];  /**< Read-ahead buffer */
+#endif
 } uPortUartHandle;
 
 /* ----------------------------------------------------------------
@@ -50,70 +136,125 @@ typedef struct {
  * -------------------------------------------------------------- */
 
 /* ----------------------------------------------------------------
- * PUBLIC FUNCTIONS
+ * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-uPortUartHandle_t uPortUartOpen(const char *pDevice, int32_t baudRate, bool useFlowControl)
+static int32_t readFd(const uPortUartHandle *pHandle, void *pData, size_t length, short revents)
 {
-    if (pDevice == NULL) {
-        return NULL;
+    ssize_t bytesRead = read(pHandle->fd, pData, length);
+    if (bytesRead < 0) {
+        return ((errno == EINTR) || (errno == EAGAIN)) ? 0 : -1;
+    }
+    if ((bytesRead == 0) && (pHandle->isSocket || ((revents & POLLHUP) != 0))) {
+        return -1;  // Device disconnected or connection closed by the peer
     }
+    return (int32_t)bytesRead;
+}
 
-    uPortUartHandle *pHandle = (uPortUartHandle *)malloc(sizeof(uPortUartHandle));
-    if (pHandle == NULL) {
-        return NULL;
+// Writes what the fd accepts right now. Sockets use send() so that a
+// closed connection gives an error instead of SIGPIPE.
+static ssize_t writeFd(const uPortUartHandle *pHandle, const void *pData, size_t length)
+{
+    if (pHandle->isSocket) {
+        return send(pHandle->fd, pData, length, MSG_NOSIGNAL);
+    }
+    return write(pHandle->fd, pData, length);
+}
+
+// Writes all buffers, waiting while a non-blocking fd (socket) is full.
+// pIov is modified.
+static int32_t writeAll(const uPortUartHandle *pHandle, struct iovec *pIov, int iovCount)
+{
+    size_t totalWritten = 0;
+
+    while (iovCount > 0) {
+        ssize_t written;
+        if (pHandle->isSocket) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = pIov;
+            msg.msg_iovlen = (size_t)iovCount;
+            written = sendmsg(pHandle->fd, &msg, MSG_NOSIGNAL);
+        } else {
+            written = writev(pHandle->fd, pIov, iovCount);
+        }
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;  // Interrupted, try again
+            }
+            if (errno == EAGAIN) {
+                // Non-blocking fd (socket) is full, wait until it can take more
+                struct pollfd pfd = { .fd = pHandle->fd, .events = POLLOUT, .revents = 0 };
+                poll(&pfd, 1, -1);
+                continue;
+            }
+            return -1;
+        }
+        totalWritten += (size_t)written;
+        // Skip what has been written
+        size_t remaining = (size_t)written;
+        while ((iovCount > 0) && (remaining >= pIov->iov_len)) {
+            remaining -= pIov->iov_len;
+            pIov++;
+            iovCount--;
+        }
+        if (iovCount > 0) {
+            pIov->iov_base = (uint8_t *)pIov->iov_base + remaining;
+            pIov->iov_len -= remaining;
+        }
+    }
+
+    return (int32_t)totalWritten;
+}
+
+static int32_t getFd(uPortUartHandle_t handle)
+{
+    return (handle != NULL) ? ((const uPortUartHandle *)handle)->fd : -1;
+}
+
+// Ask the driver to push received data to the TTY layer right away. For
+// USB serial adapters (e.g. FTDI) this also lowers the latency timer, which
+// otherwise delays every read by up to 16 ms. Not all drivers support it,
+// so failures are ignored.
+static void setLowLatency(int fd)
+{
+    struct serial_struct serial;
+    if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags = (int)((unsigned int)serial.flags | ASYNC_LOW_LATENCY);
+        ioctl(fd, TIOCSSERIAL, &serial);
+    }
+}
+
+static int openTty(const char *pDevice, int32_t baudRate, bool useFlowControl, uint32_t flags)
+{
+    if (baudRate <= 0) {
+        return -1;
     }
 
     // Open the UART device
-    pHandle->fd = open(pDevice, O_RDWR | O_NOCTTY);
-    if (pHandle->fd < 0) {
-        free(pHandle);
-        return NULL;
+    int fd = open(pDevice, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
     }
 
-    // Configure the UART
-    struct termios tty;
-    if (tcgetattr(pHandle->fd, &tty) != 0) {
-        close(pHandle->fd);
-        free(pHandle);
-        return NULL;
+    // Prevent other processes from opening the device while we use it
+    if (((flags & U_PORT_UART_FLAG_EXCLUSIVE) != 0) && (ioctl(fd, TIOCEXCL) != 0)) {
+        close(fd);
+        return -1;
     }
 
-    // Set baud rate
-    speed_t speed;
-    switch (baudRate) {
-        case 9600:
-            speed = B9600;
-            break;
-        case 19200:
-            speed = B19200;
-            break;
-        case 38400:
-            speed = B38400;
-            break;
-        case 57600:
-            speed = B57600;
-            break;
-        case 115200:
-            speed = B115200;
-            break;
-        case 230400:
-            speed = B230400;
-            break;
-        case 460800:
-            speed = B460800;
-            break;
-        case 921600:
-            speed = B921600;
-            break;
-        default:
-            close(pHandle->fd);
-            free(pHandle);
-            return NULL;
+    // Configure the UART
+    struct termios2 tty;
+    if (ioctl(fd, TCGETS2, &tty) != 0) {
+        close(fd);
+        return -1;
     }
 
-    cfsetospeed(&tty, speed);
-    cfsetispeed(&tty, speed);
+    // Set baud rate, BOTHER makes the driver use c_ispeed/c_ospeed as is
+    tty.c_cflag &= (unsigned int)~(CBAUD | CIBAUD);
+    tty.c_cflag |= BOTHER;
+    tty.c_ispeed = (speed_t)baudRate;
+    tty.c_ospeed = (speed_t)baudRate;
 
     // 8N1 mode
     tty.c_cflag &= (unsigned int)~PARENB;  // No parity
@@ -136,11 +277,329 @@ uPortUartHandle_t uPortUartOpen(const char *pDevice, int32_t baudRate, bool useF
     tty.c_iflag &= (unsigned int)~(IXON | IXOFF | IXANY);
     tty.c_oflag &= (unsigned int)~OPOST;
 
-    // Non-blocking reads with timeout handled by poll
+    // Non-blocking reads, uPortUartRead() waits for data with poll()
     tty.c_cc[VMIN] = 0;
     tty.c_cc[VTIME] = 0;
 
-    if (tcsetattr(pHandle->fd, TCSANOW, &tty) != 0) {
+    if (ioctl(fd, TCSETS2, &tty) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // TCSETS2 succeeds for rates the driver can't do, check what it actually set
+    if (ioctl(fd, TCGETS2, &tty) != 0) {
+        close(fd);
+        return -1;
+    }
+    int64_t rateDiff = (int64_t)tty.c_ospeed - baudRate;
+    if ((rateDiff * 100 > (int64_t)baudRate * BAUD_RATE_TOLERANCE_PERCENT) ||
+        (-rateDiff * 100 > (int64_t)baudRate * BAUD_RATE_TOLERANCE_PERCENT)) {
+        close(fd);
+        return -1;
+    }
+
+    if ((flags & U_PORT_UART_FLAG_LOW_LATENCY) != 0) {
+        setLowLatency(fd);
+    }
+    if ((flags & U_PORT_UART_FLAG_FLUSH_INPUT) != 0) {
+        // Drop anything received before the port was opened
+        ioctl(fd, TCFLSH, TCIFLUSH);
+    }
+
+    return fd;
+}
+
+// Connects a non-blocking socket, waiting at most U_PORT_UART_CONNECT_TIMEOUT_MS
+static int connectSocket(int domain, const struct sockaddr *pAddr, socklen_t addrLen)
+{
+    int fd = socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, pAddr, addrLen) != 0) {
+        struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+        int error = 0;
+        socklen_t errorLen = sizeof(error);
+        if ((errno != EINPROGRESS) || (poll(&pfd, 1, U_PORT_UART_CONNECT_TIMEOUT_MS) <= 0) ||
+            (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &errorLen) != 0) || (error != 0)) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+// pAddress is "host:port" where host may be a name, an IPv4 address or an
+// IPv6 address in brackets, e.g. "[::1]:2000"
+static int openTcp(const char *pAddress)
+{
+    char host[256];
+    const char *pHostStart = pAddress;
+    const char *pPort = strrchr(pAddress, ':');
+    if ((pPort == NULL) || (pPort[1] == 0)) {
+        return -1;
+    }
+    size_t hostLen = (size_t)(pPort - pAddress);
+    if ((hostLen >= 2) && (pAddress[0] == '[') && (pAddress[hostLen - 1] == ']')) {
+        pHostStart++;
+        hostLen -= 2;
+    }
+    if ((hostLen == 0) || (hostLen >= sizeof(host))) {
+        return -1;
+    }
+    memcpy(host, pHostStart, hostLen);
+    host[hostLen] = 0;
+
+    struct addrinfo hints;
+    struct addrinfo *pResult = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, &pPort[1], &hints, &pResult) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo *pAi = pResult; (pAi != NULL) && (fd < 0); pAi = pAi->ai_next) {
+        fd = connectSocket(pAi->ai_family, pAi->ai_addr, pAi->ai_addrlen);
+    }
+    freeaddrinfo(pResult);
+
+    if (fd >= 0) {
+        // AT commands and XMODEM ACKs are small, don't let Nagle hold them back
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static int openUnix(const char *pPath)
+{
+    struct sockaddr_un addr;
+    size_t pathLen = strlen(pPath);
+    if ((pathLen == 0) || (pathLen >= sizeof(addr.sun_path))) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, pPath, pathLen);
+    return connectSocket(AF_UNIX, (const struct sockaddr *)&addr, sizeof(addr));
+}
+
+static void getDeadline(struct timespec *pTime, int32_t timeoutMs)
+{
+    clock_gettime(CLOCK_MONOTONIC, pTime);
+    pTime->tv_sec += timeoutMs / 1000;
+    pTime->tv_nsec += (long)(timeoutMs % 1000) * 1000000;
+    if (pTime->tv_nsec >= 1000000000) {
+        pTime->tv_nsec -= 1000000000;
+        pTime->tv_sec++;
+    }
+}
+
+static void *txWriterThread(void *pArg)
+{
+    uPortUartHandle *pHandle = (uPortUartHandle *)pArg;
+    uPortUartTxQueue *pQueue = pHandle->pTxQueue;
+
+    pthread_mutex_lock(&pQueue->mutex);
+    while (true) {
+        while ((pQueue->count == 0) && !pQueue->terminate) {
+            pthread_cond_wait(&pQueue->dataCond, &pQueue->mutex);
+        }
+        if ((pQueue->count == 0) || pQueue->error) {
+            break;
+        }
+        // Everything that has been queued since the last write() goes out
+        // in one system call, which merges the small writes of the callers.
+        // The callers only append behind head + count so the data can be
+        // written without holding the mutex.
+        size_t length = U_PORT_UART_TX_QUEUE_SIZE - pQueue->head;
+        if (length > pQueue->count) {
+            length = pQueue->count;
+        }
+        const uint8_t *pData = &pQueue->buf[pQueue->head];
+        pthread_mutex_unlock(&pQueue->mutex);
+
+        struct pollfd pfd = { .fd = pHandle->fd, .events = POLLOUT, .revents = 0 };
+        ssize_t written = 0;
+        if (poll(&pfd, 1, TX_POLL_INTERVAL_MS) > 0) {
+            written = writeFd(pHandle, pData, length);
+        }
+
+        pthread_mutex_lock(&pQueue->mutex);
+        if (written > 0) {
+            pQueue->head = (pQueue->head + (size_t)written) % U_PORT_UART_TX_QUEUE_SIZE;
+            pQueue->count -= (size_t)written;
+            pQueue->stats.writeCount++;
+            pthread_cond_broadcast(&pQueue->spaceCond);
+        } else if ((written < 0) && (errno != EINTR) && (errno != EAGAIN)) {
+            pQueue->error = true;
+            pthread_cond_broadcast(&pQueue->spaceCond);
+        } else if (pQueue->terminate && (pQueue->count > 0)) {
+            // The device doesn't take any data and the queue didn't drain
+            // within the close timeout
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pQueue->mutex);
+
+    return NULL;
+}
+
+static bool txQueueStart(uPortUartHandle *pHandle)
+{
+    uPortUartTxQueue *pQueue = (uPortUartTxQueue *)malloc(sizeof(uPortUartTxQueue));
+    if (pQueue == NULL) {
+        return false;
+    }
+    memset(pQueue, 0, sizeof(uPortUartTxQueue));
+    pQueue->stats.capacity = U_PORT_UART_TX_QUEUE_SIZE;
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&pQueue->mutex, NULL);
+    pthread_cond_init(&pQueue->dataCond, &condAttr);
+    pthread_cond_init(&pQueue->spaceCond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    // The writer thread must be able to give up on a device that doesn't
+    // accept data, so it polls a non-blocking fd. Reads are not affected
+    // since they always poll() before read().
+    int fileFlags = fcntl(pHandle->fd, F_GETFL);
+    pHandle->pTxQueue = pQueue;
+    if ((fileFlags < 0) || (fcntl(pHandle->fd, F_SETFL, fileFlags | O_NONBLOCK) != 0) ||
+        (pthread_create(&pQueue->thread, NULL, txWriterThread, pHandle) != 0)) {
+        pHandle->pTxQueue = NULL;
+        pthread_cond_destroy(&pQueue->spaceCond);
+        pthread_cond_destroy(&pQueue->dataCond);
+        pthread_mutex_destroy(&pQueue->mutex);
+        free(pQueue);
+        return false;
+    }
+    return true;
+}
+
+static void txQueueStop(uPortUartHandle *pHandle)
+{
+    uPortUartTxQueue *pQueue = pHandle->pTxQueue;
+    struct timespec deadline;
+
+    // Give the writer some time to send what is still queued
+    getDeadline(&deadline, U_PORT_UART_TX_QUEUE_TIMEOUT_MS);
+    pthread_mutex_lock(&pQueue->mutex);
+    while ((pQueue->count > 0) && !pQueue->error &&
+           (pthread_cond_timedwait(&pQueue->spaceCond, &pQueue->mutex, &deadline) == 0)) {
+    }
+    pQueue->terminate = true;
+    pthread_cond_signal(&pQueue->dataCond);
+    pthread_mutex_unlock(&pQueue->mutex);
+    pthread_join(pQueue->thread, NULL);
+
+    pthread_cond_destroy(&pQueue->spaceCond);
+    pthread_cond_destroy(&pQueue->dataCond);
+    pthread_mutex_destroy(&pQueue->mutex);
+    free(pQueue);
+    pHandle->pTxQueue = NULL;
+}
+
+static int32_t txQueueWrite(uPortUartTxQueue *pQueue, const uint8_t *pData, size_t length)
+{
+    struct timespec deadline;
+    bool waited = false;
+    size_t total = 0;
+
+    pthread_mutex_lock(&pQueue->mutex);
+    pQueue->stats.enqueueCount++;
+    while ((total < length) && !pQueue->error) {
+        size_t space = U_PORT_UART_TX_QUEUE_SIZE - pQueue->count;
+        if (space == 0) {
+            // Backpressure: wait for the writer to make room, but not forever
+            if (!waited) {
+                waited = true;
+                pQueue->stats.fullCount++;
+                getDeadline(&deadline, U_PORT_UART_TX_QUEUE_TIMEOUT_MS);
+            }
+            if (pthread_cond_timedwait(&pQueue->spaceCond, &pQueue->mutex, &deadline) != 0) {
+                pQueue->stats.timeoutCount++;
+                break;
+            }
+            continue;
+        }
+        size_t tail = (pQueue->head + pQueue->count) % U_PORT_UART_TX_QUEUE_SIZE;
+        size_t chunk = U_PORT_UART_TX_QUEUE_SIZE - tail;
+        if (chunk > space) {
+            chunk = space;
+        }
+        if (chunk > length - total) {
+            chunk = length - total;
+        }
+        memcpy(&pQueue->buf[tail], &pData[total], chunk);
+        pQueue->count += chunk;
+        total += chunk;
+        if (pQueue->count > pQueue->stats.maxQueued) {
+            pQueue->stats.maxQueued = pQueue->count;
+        }
+        pthread_cond_signal(&pQueue->dataCond);
+    }
+    bool error = pQueue->error;
+    pthread_mutex_unlock(&pQueue->mutex);
+
+    return ((total == 0) && error) ? -1 : (int32_t)total;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+const uPortUartOps_t gUPortUartLinuxOps = {
+    .openFn = uPortUartOpenEx,
+    .closeFn = uPortUartClose,
+    .writeFn = uPortUartWrite,
+    .readFn = uPortUartRead,
+    .writevFn = uPortUartWritev,
+    .getFdFn = getFd,
+    .caps = U_PORT_UART_CAP_POLL_FD | U_PORT_UART_CAP_WRITEV
+};
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+uPortUartHandle_t uPortUartOpen(const char *pDevice, int32_t baudRate, bool useFlowControl)
+{
+    return uPortUartOpenEx(pDevice, baudRate, useFlowControl, 0);
+}
+
+uPortUartHandle_t uPortUartOpenEx(const char *pDevice, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    if (pDevice == NULL) {
+        return NULL;
+    }
+
+    uPortUartHandle *pHandle = (uPortUartHandle *)malloc(sizeof(uPortUartHandle));
+    if (pHandle == NULL) {
+        return NULL;
+    }
+
+    memset(pHandle, 0, sizeof(uPortUartHandle));
+
+    if (strncmp(pDevice, TCP_PREFIX, strlen(TCP_PREFIX)) == 0) {
+        pHandle->fd = openTcp(&pDevice[strlen(TCP_PREFIX)]);
+        pHandle->isSocket = true;
+    } else if (strncmp(pDevice, UNIX_PREFIX, strlen(UNIX_PREFIX)) == 0) {
+        pHandle->fd = openUnix(&pDevice[strlen(UNIX_PREFIX)]);
+        pHandle->isSocket = true;
+    } else {
+        pHandle->fd = openTty(pDevice, baudRate, useFlowControl, flags);
+    }
+    if (pHandle->fd < 0) {
+        free(pHandle);
+        return NULL;
+    }
+
+    if (((flags & U_PORT_UART_FLAG_TX_QUEUE) != 0) && !txQueueStart(pHandle)) {
         close(pHandle->fd);
         free(pHandle);
         return NULL;
@@ -153,6 +612,9 @@ void uPortUartClose(uPortUartHandle_t handle)
 {
     if (handle != NULL) {
         uPortUartHandle *pHandle = (uPortUartHandle *)handle;
+        if (pHandle->pTxQueue != NULL) {
+            txQueueStop(pHandle);
+        }
         close(pHandle->fd);
         free(pHandle);
     }
@@ -167,21 +629,67 @@ int32_t uPortUartWrite(uPortUartHandle_t handle,
     }
 
     uPortUartHandle *pHandle = (uPortUartHandle *)handle;
-    const uint8_t *pBytes = (const uint8_t *)pData;
-    size_t totalWritten = 0;
 
-    while (totalWritten < length) {
-        ssize_t written = write(pHandle->fd, pBytes + totalWritten, length - totalWritten);
-        if (written < 0) {
-            if (errno == EINTR) {
-                continue;  // Interrupted, try again
+    if (pHandle->pTxQueue != NULL) {
+        return txQueueWrite(pHandle->pTxQueue, (const uint8_t *)pData, length);
+    }
+
+    struct iovec iov = { .iov_base = (void *)pData, .iov_len = length };
+    return writeAll(pHandle, &iov, 1);
+}
+
+int32_t uPortUartWritev(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov, size_t iovCount)
+{
+    if ((handle == NULL) || (pIov == NULL)) {
+        return -1;
+    }
+
+    uPortUartHandle *pHandle = (uPortUartHandle *)handle;
+    struct iovec iov[MAX_IOV];
+    int32_t total = 0;
+
+    while (iovCount > 0) {
+        int count = 0;
+        size_t length = 0;
+        for (; (count < MAX_IOV) && (iovCount > 0); pIov++, iovCount--) {
+            if (pIov->length > 0) {
+                iov[count].iov_base = (void *)pIov->pData;
+                iov[count].iov_len = pIov->length;
+                length += pIov->length;
+                count++;
             }
-            return -1;
         }
-        totalWritten += (size_t)written;
+        if (count == 0) {
+            break;
+        }
+        int32_t written;
+        if (pHandle->pTxQueue != NULL) {
+            // The writer thread merges queued data anyway
+            written = 0;
+            for (int i = 0; i < count; i++) {
+                int32_t ret = txQueueWrite(pHandle->pTxQueue, (const uint8_t *)iov[i].iov_base,
+                                           iov[i].iov_len);
+                if (ret < 0) {
+                    return ret;
+                }
+                written += ret;
+                if ((size_t)ret < iov[i].iov_len) {
+                    break;
+                }
+            }
+        } else {
+            written = writeAll(pHandle, iov, count);
+        }
+        if (written < 0) {
+            return written;
+        }
+        total += written;
+        if ((size_t)written < length) {
+            break;  // TX queue timeout
+        }
     }
 
-    return (int32_t)totalWritten;
+    return total;
 }
 
 int32_t uPortUartRead(uPortUartHandle_t handle,
@@ -195,13 +703,32 @@ int32_t uPortUartRead(uPortUartHandle_t handle,
 
     uPortUartHandle *pHandle = (uPortUartHandle *)handle;
 
-    // For zero timeout, check if data is available without blocking
-    if (timeoutMs == 0) {
-        int available = 0;
-        ioctl(pHandle->fd, FIONREAD, &available);
-        if (available == 0) {
-            return 0;
-        }
+#if U_PORT_UART_READ_AHEAD_SIZE > 0
+    // Serve the request from data that has already been read ahead
+    if ((pHandle->rxCount > 0) && (pData != NULL)) {
+        size_t count = (length < pHandle->rxCount) ? length : pHandle->rxCount;
+        memcpy(pData, &pHandle->rxBuf[pHandle->rxPos], count);
+        pHandle->rxPos += count;
+        pHandle->rxCount -= count;
+        return (int32_t)count;
+    }
+#endif
+
+    // Wait for data with poll() so that the caller sleeps instead of spinning
+    // on empty reads (VMIN=0/VTIME=0 makes read() itself non-blocking)
+    struct pollfd pfd = { .fd = pHandle->fd, .events = POLLIN, .revents = 0 };
+    int ret;
+    do {
+        ret = poll(&pfd, 1, (timeoutMs < 0) ? -1 : timeoutMs);
+    } while ((ret < 0) && (errno == EINTR));
+    if (ret < 0) {
+        return -1;
+    }
+    if (ret == 0) {
+        return 0;  // Timeout
+    }
+    if ((pfd.revents & (POLLERR | POLLNVAL)) != 0) {
+        return -1;
     }
 
     // If pData is NULL, just return 0 (test case)
@@ -209,11 +736,37 @@ int32_t uPortUartRead(uPortUartHandle_t handle,
         return 0;
     }
 
-    // Read data (blocking read handled by termios VTIME setting)
-    ssize_t bytesRead = read(pHandle->fd, pData, length);
-    if (bytesRead < 0) {
+#if U_PORT_UART_READ_AHEAD_SIZE > 0
+    if (length < sizeof(pHandle->rxBuf)) {
+        // Small read: fill the read-ahead buffer with everything available
+        int32_t bytesRead = readFd(pHandle, pHandle->rxBuf, sizeof(pHandle->rxBuf), pfd.revents);
+        if (bytesRead <= 0) {
+            return bytesRead;
+        }
+        size_t count = (length < (size_t)bytesRead) ? length : (size_t)bytesRead;
+        memcpy(pData, pHandle->rxBuf, count);
+        pHandle->rxPos = count;
+        pHandle->rxCount = (size_t)bytesRead - count;
+        return (int32_t)count;
+    }
+#endif
+
+    // Read everything that is available, up to length
+    return readFd(pHandle, pData, length, pfd.revents);
+}
+
+int32_t uPortUartGetTxStats(uPortUartHandle_t handle, uPortUartTxStats_t *pStats)
+{
+    uPortUartHandle *pHandle = (uPortUartHandle *)handle;
+    if ((pHandle == NULL) || (pHandle->pTxQueue == NULL) || (pStats == NULL)) {
         return -1;
     }
 
-    return (int32_t)bytesRead;
+    uPortUartTxQueue *pQueue = pHandle->pTxQueue;
+    pthread_mutex_lock(&pQueue->mutex);
+    *pStats = pQueue->stats;
+    pStats->queued = pQueue->count;
+    pthread_mutex_unlock(&pQueue->mutex);
+
+    return 0;
 }
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Linux UART port extensions
+ *
+ * Functions only implemented by the Linux UART port, in addition to the
+ * interface in u_port_uart.h that every port implements.
+ */
+
+#ifndef U_PORT_UART_LINUX_H
+#define U_PORT_UART_LINUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "u_port_uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** TX queue statistics, see uPortUartGetTxStats() */
+typedef struct {
+    size_t capacity;        /**< Size of the TX queue in bytes */
+    size_t queued;          /**< Bytes currently waiting in the TX queue */
+    size_t maxQueued;       /**< Highest number of queued bytes seen */
+    uint32_t enqueueCount;  /**< Number of uPortUartWrite() calls */
+    uint32_t writeCount;    /**< Number of writes to the device, lower than enqueueCount
+                                 when small writes have been merged */
+    uint32_t fullCount;     /**< Number of uPortUartWrite() calls that found the queue full */
+    uint32_t timeoutCount;  /**< Number of uPortUartWrite() calls that returned early
+                                 because the queue stayed full */
+} uPortUartTxStats_t;
+
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+/**
+ * @brief Operations of the Linux UART port
+ *
+ * Same functions as uPortUartOpenEx() etc. plus writev and the file
+ * descriptor of the device or socket.
+ */
+extern const uPortUartOps_t gUPortUartLinuxOps;
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/**
+ * @brief Write several buffers to UART
+ *
+ * Same as calling uPortUartWrite() for each buffer but with one writev().
+ *
+ * @param[in]  handle    UART handle from uPortUartOpen()
+ * @param[in]  pIov      Buffers to write, in order
+ * @param      iovCount  Number of buffers
+ * @return               Total number of bytes written, or negative on error
+ */
+int32_t uPortUartWritev(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov, size_t iovCount);
+
+/**
+ * @brief Get TX queue statistics
+ *
+ * @param[in]  handle  UART handle from uPortUartOpenEx() with U_PORT_UART_FLAG_TX_QUEUE
+ * @param[out] pStats  Statistics, queued is the current queue depth
+ * @return             0 on success, negative if the handle has no TX queue
+ */
+int32_t uPortUartGetTxStats(uPortUartHandle_t handle, uPortUartTxStats_t *pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // U_PORT_UART_LINUX_H
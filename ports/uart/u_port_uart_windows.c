@@ -189,6 +189,14 @@ int32_t uPortUartRead(uPortUartHandle_t handle, void *pData, size_t length, int3
 
 uPortUartHandle_t uPortUartOpen(const char *pDevName, int32_t baudRate, bool useFlowControl)
 {
+    return uPortUartOpenEx(pDevName, baudRate, useFlowControl, 0);
+}
+
+uPortUartHandle_t uPortUartOpenEx(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    // COM ports are always opened for exclusive access and Windows has no
+    // generic low latency setting (it's an FTDI/CP210x driver property)
     if (pDevName == NULL) {
         return NULL;
     }
@@ -208,6 +216,10 @@ uPortUartHandle_t uPortUartOpen(const char *pDevName, int32_t baudRate, bool use
         return NULL;
     }
 
+    if ((flags & U_PORT_UART_FLAG_FLUSH_INPUT) != 0) {
+        PurgeComm(pHandle->hComPort, PURGE_RXCLEAR);
+    }
+
     return (uPortUartHandle_t)pHandle;
 }
 
@@ -105,6 +105,16 @@ static void uartIsr(const struct device *dev, void *user_data)
 
 uPortUartHandle_t uPortUartOpen(const char *pDevName, int32_t baudRate, bool useFlowControl)
 {
+    return uPortUartOpenEx(pDevName, baudRate, useFlowControl, 0);
+}
+
+uPortUartHandle_t uPortUartOpenEx(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    // The RX interrupt already gives the lowest latency, the handle is
+    // exclusive and the RX ring buffer always starts empty
+    (void)flags;
+
     if (pDevName == NULL) {
         return NULL;
     }
@@ -25,7 +25,6 @@
 #include <stdlib.h>
 #include <string.h>  // memcpy(), strcmp(), strcspn(), strspm()
 #include <stdio.h>   // snprintf()
-#include <ctype.h>   // isprint()
 
 #include "u_cx_at_config.h"
 
@@ -39,9 +38,6 @@
 
 #define NO_STATUS   (INT_MAX)
 
-/* Special character sent for entering binary mode */
-#define U_CX_SOH_CHAR    0x01
-
 #define CHECK_READ_ERROR(CLIENT, READ_RET)  \
     if (READ_RET < 0) {                     \
         CLIENT->lastIoError = READ_RET;     \
@@ -74,6 +70,17 @@ enum uCxAtParserCode {
 
 static int32_t gNextInstance = 0;
 
+// UART backend when uCxAtClientConfig_t.pUartOps is NULL
+static const uPortUartOps_t gDefaultUartOps = {
+    .openFn = uPortUartOpenEx,
+    .closeFn = uPortUartClose,
+    .writeFn = uPortUartWrite,
+    .readFn = uPortUartRead,
+    .writevFn = NULL,
+    .getFdFn = NULL,
+    .caps = 0
+};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -90,61 +97,97 @@ static void setupBinaryRxBuffer(uCxAtClient_t *pClient, uCxAtBinaryState_t state
     pBinRx->remainingDataBytes = remainingBytes;
 }
 
+// Get the buffer that the current line is being assembled in
+static inline char *getLineBuffer(uCxAtClient_t *pClient)
+{
+#if U_CX_USE_URC_QUEUE == 1
+    if (pClient->pUrcLine != NULL) {
+        return pClient->pUrcLine;
+    }
+#endif
+    return (char *)pClient->pConfig->pRxBuffer;
+}
+
+#if U_CX_USE_URC_QUEUE == 1
+// Release the URC queue slot reserved for the current line (if any)
+// unless the line was enqueued as a URC
+static void releaseUrcLineSlot(uCxAtClient_t *pClient, int32_t parserRet)
+{
+    if (pClient->pUrcLine != NULL) {
+        if (parserRet != AT_PARSER_GOT_URC) {
+            // The line data is left untouched until next reservation so
+            // pClient->pRspParams may still point into the slot
+            uCxAtUrcQueueEnqueueAbort(&pClient->urcQueue);
+        }
+        pClient->pUrcLine = NULL;
+    }
+}
+#endif
+
 static int32_t parseLine(uCxAtClient_t *pClient, char *pLine, size_t lineLength)
 {
     int32_t ret = AT_PARSER_NOP;
 
-    char *pPtr = pLine;
-    bool emptyLine = true;
-    while (pPtr < &pLine[lineLength]) {
-        if ((*pPtr != '\n') && (*pPtr != '\r')) {
-            emptyLine = false;
-            break;
-        }
-        pPtr++;
+    uCxAtLineType_t lineType;
+    if (pClient->executingCmd) {
+        lineType = uCxAtUtilClassifyLine(pLine, lineLength,
+                                         pClient->pExpectedRsp, pClient->pExpectedRspLen);
+    } else {
+        lineType = uCxAtUtilClassifyLine(pLine, lineLength, NULL, 0);
     }
-    if (emptyLine) {
+    if (lineType == U_CX_AT_LINE_EMPTY) {
         return AT_PARSER_NOP;
     }
 
     U_CX_LOG_LINE_I(U_CX_LOG_CH_RX, pClient->instance, "%s", pLine);
 
     if (pClient->executingCmd) {
-        if ((pClient->pExpectedRsp != NULL) &&
-            (*pClient->pExpectedRsp != 0) &&
-            (strncmp(pLine, pClient->pExpectedRsp, pClient->pExpectedRspLen) == 0)) {
-            pClient->pRspParams = &pLine[pClient->pExpectedRspLen];
-            ret = AT_PARSER_GOT_RSP;
-        } else if (strcmp(pLine, "OK") == 0) {
-            pClient->status = 0;
-            ret = AT_PARSER_GOT_STATUS;
-        } else if (strncmp(pLine, "ERROR", 5) == 0) {
-            if (pLine[5] == 0) {
-                pClient->status = U_CX_ERROR_STATUS_ERROR;
-                U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pClient->instance, "Command failed");
+        switch (lineType) {
+            case U_CX_AT_LINE_EXPECTED_RSP:
+                pClient->pRspParams = &pLine[pClient->pExpectedRspLen];
+                ret = AT_PARSER_GOT_RSP;
+                break;
+            case U_CX_AT_LINE_OK:
+                pClient->status = 0;
                 ret = AT_PARSER_GOT_STATUS;
-            } else if (pLine[5] == ':') {
-                // Extended error code
-                char *pEnd;
-                char *pCodeStr = &pLine[6];
-                int code = (int)strtol(pCodeStr, &pEnd, 10);
-                if (isdigit((int) * pCodeStr) && (*pEnd == 0)) {
-                    pClient->status = U_CX_EXTENDED_ERROR_OFFSET - code;
-                    U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pClient->instance, "Command failed with error code: %d", code);
+                break;
+            case U_CX_AT_LINE_ERROR:
+                if (pLine[5] == 0) {
+                    pClient->status = U_CX_ERROR_STATUS_ERROR;
+                    U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pClient->instance, "Command failed");
                     ret = AT_PARSER_GOT_STATUS;
+                } else if (pLine[5] == ':') {
+                    // Extended error code
+                    char *pEnd;
+                    char *pCodeStr = &pLine[6];
+                    int code = (int)strtol(pCodeStr, &pEnd, 10);
+                    if ((*pCodeStr >= '0') && (*pCodeStr <= '9') && (*pEnd == 0)) {
+                        pClient->status = U_CX_EXTENDED_ERROR_OFFSET - code;
+                        U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pClient->instance, "Command failed with error code: %d", code);
+                        ret = AT_PARSER_GOT_STATUS;
+                    }
                 }
-            }
-        } else if ((pLine[0] != '+') && (pLine[0] != '*') && (strncmp(pLine, "AT+", 3) != 0)) {
-            pClient->pRspParams = &pLine[0];
-            ret = AT_PARSER_GOT_RSP;
+                break;
+            case U_CX_AT_LINE_OTHER:
+                pClient->pRspParams = &pLine[0];
+                ret = AT_PARSER_GOT_RSP;
+                break;
+            default:
+                break;
         }
     }
 
     if (ret == AT_PARSER_NOP) {
         // Check if this is URC data
-        if ((pLine[0] == '+') || (pLine[0] == '*')) {
+        if (lineType == U_CX_AT_LINE_URC) {
 #if U_CX_USE_URC_QUEUE == 1
             if (uCxAtUrcQueueEnqueueBegin(&pClient->urcQueue, pLine, lineLength)) {
+                if ((pClient->urcExecutor != NULL) || (pClient->urcQueue.numCoalesceRules > 0)) {
+                    // Timestamp is needed for tracking latency and for URC coalescing
+                    // (0 is reserved for "no timestamp")
+                    int32_t now = U_CX_PORT_GET_TIME_MS();
+                    uCxAtUrcQueueEnqueueSetTimestamp(&pClient->urcQueue, (now != 0) ? now : 1);
+                }
                 ret = AT_PARSER_GOT_URC;
             } else {
                 // Urc queue full
@@ -170,31 +213,76 @@ static int32_t parseLine(uCxAtClient_t *pClient, char *pLine, size_t lineLength)
 static int32_t parseIncomingChar(uCxAtClient_t *pClient, char ch)
 {
     int32_t ret = AT_PARSER_NOP;
-    char *pRxBuffer = (char *)pClient->pConfig->pRxBuffer;
-
-    if (ch == U_CX_SOH_CHAR) {
-        pRxBuffer[pClient->rxBufferPos] = 0;
-        ret = AT_PARSER_START_BINARY;
-    } else if ((ch == '\r') || (ch == '\n')) {
-        pRxBuffer[pClient->rxBufferPos] = 0;
-        ret = parseLine(pClient, pRxBuffer, pClient->rxBufferPos);
-        pClient->rxBufferPos = 0;
+    char *pLineBuffer = getLineBuffer(pClient);
+
+    switch (gUCxAtByteClass[(uint8_t)ch]) {
+        case U_CX_AT_BYTE_PRINT: {
 #if U_CX_USE_URC_QUEUE == 1
-        if (ret == AT_PARSER_GOT_URC) {
-            // We got URC in character mode so no binary transfer is needed
-            // hence we can complete the URC enqueueing
-            uCxAtUrcQueueEnqueueEnd(&pClient->urcQueue, 0);
-            // Make sure we continue calling parseIncomingChar() as the
-            // URC will be handled after the command has completed
-            ret = AT_PARSER_NOP;
-        }
+            const struct uCxAtClientConfig *pConfig = pClient->pConfig;
+            if (pClient->rxBufferPos == 0) {
+                pClient->urcLineChecked = false;
+            } else if ((pClient->pUrcLine != NULL) &&
+                       (pClient->rxBufferPos == pClient->urcLineMaxLen)) {
+                // No more space in the URC queue slot - continue in the RX buffer
+                if (pClient->rxBufferPos < pConfig->rxBufferLen) {
+                    memcpy(pConfig->pRxBuffer, pClient->pUrcLine, pClient->rxBufferPos);
+                } else {
+                    // Overflow - discard everything and start over
+                    pClient->rxBufferPos = 0;
+                }
+                releaseUrcLineSlot(pClient, AT_PARSER_NOP);
+            } else if ((ch == ':') && !pClient->urcLineChecked) {
+                char *pRxBuffer = (char *)pConfig->pRxBuffer;
+                pClient->urcLineChecked = true;
+                if ((pRxBuffer[0] == '+') || (pRxBuffer[0] == '*')) {
+                    // This is probably a URC and the URC name is now known so the
+                    // URC class can be selected. Assemble the rest of the line directly
+                    // in the URC queue to avoid copying it once the line is complete.
+                    pClient->urcLineMaxLen = uCxAtUrcQueueEnqueueReserve(&pClient->urcQueue,
+                                                                         pRxBuffer,
+                                                                         pClient->rxBufferPos,
+                                                                         &pClient->pUrcLine);
+                    if (pClient->urcLineMaxLen <= pClient->rxBufferPos) {
+                        releaseUrcLineSlot(pClient, AT_PARSER_NOP);
+                    }
+                }
+            }
+            pLineBuffer = getLineBuffer(pClient);
 #endif
-    } else if (isprint(ch)) {
-        pRxBuffer[pClient->rxBufferPos++] = ch;
-        if (pClient->rxBufferPos == pClient->pConfig->rxBufferLen) {
-            // Overflow - discard everything and start over
-            pClient->rxBufferPos = 0;
+            pLineBuffer[pClient->rxBufferPos++] = ch;
+            if (pClient->rxBufferPos == pClient->pConfig->rxBufferLen) {
+                // Overflow - discard everything and start over
+                pClient->rxBufferPos = 0;
+#if U_CX_USE_URC_QUEUE == 1
+                // The URC queue slot may be larger than the RX buffer
+                releaseUrcLineSlot(pClient, AT_PARSER_NOP);
+#endif
+            }
+            break;
         }
+        case U_CX_AT_BYTE_EOL:
+            pLineBuffer[pClient->rxBufferPos] = 0;
+            ret = parseLine(pClient, pLineBuffer, pClient->rxBufferPos);
+            pClient->rxBufferPos = 0;
+#if U_CX_USE_URC_QUEUE == 1
+            releaseUrcLineSlot(pClient, ret);
+            if (ret == AT_PARSER_GOT_URC) {
+                // We got URC in character mode so no binary transfer is needed
+                // hence we can complete the URC enqueueing
+                uCxAtUrcQueueEnqueueEnd(&pClient->urcQueue, 0);
+                // Make sure we continue calling parseIncomingChar() as the
+                // URC will be handled after the command has completed
+                ret = AT_PARSER_NOP;
+            }
+#endif
+            break;
+        case U_CX_AT_BYTE_SOH:
+            pLineBuffer[pClient->rxBufferPos] = 0;
+            ret = AT_PARSER_START_BINARY;
+            break;
+        default:
+            // Non-printable characters are ignored
+            break;
     }
 
     return ret;
@@ -236,10 +324,10 @@ static void setupBinaryTransfer(uCxAtClient_t *pClient, int32_t parserRet, uint1
 #else
             size_t bufPos = pClient->rxBufferPos;
             uint8_t *pPtr = pConfig->pRxBuffer;
-            size_t len = pConfig->rxBufferLen - bufPos;
+            size_t len = U_MIN(pConfig->rxBufferLen - bufPos, (size_t)UINT16_MAX);
             if (len > binLength) {
                 setupBinaryRxBuffer(pClient, U_CX_BIN_STATE_BINARY_URC,
-                                    &pPtr[bufPos], len, binLength);
+                                    &pPtr[bufPos], (uint16_t)len, binLength);
             } else {
                 // The binary data can't be fitted into the queue so we need to drop it
                 U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance,  "Not enough space for URC binary data");
@@ -256,7 +344,7 @@ static void setupBinaryTransfer(uCxAtClient_t *pClient, int32_t parserRet, uint1
     }
 }
 
-static int32_t handleBinaryRx(uCxAtClient_t *pClient)
+static int32_t handleBinaryRx(uCxAtClient_t *pClient, int32_t timeoutMs)
 {
     int32_t ret = AT_PARSER_NOP;
 
@@ -267,9 +355,9 @@ static int32_t handleBinaryRx(uCxAtClient_t *pClient)
     static uint8_t lengthBuf[2];
     if (pBinRx->rxHeaderCount < 2) {
         size_t readLen = sizeof(lengthBuf) - pBinRx->rxHeaderCount;
-        readStatus = uPortUartRead(pClient->uartHandle,
+        readStatus = pClient->pUartOps->readFn(pClient->uartHandle,
                                    &lengthBuf[pBinRx->rxHeaderCount], readLen,
-                                   pClient->pConfig->timeoutMs);
+                                   timeoutMs);
         CHECK_READ_ERROR(pClient, readStatus);
         if (readStatus > 0) {
             pBinRx->rxHeaderCount += (uint8_t)readStatus;
@@ -280,9 +368,11 @@ static int32_t handleBinaryRx(uCxAtClient_t *pClient)
             // The two length bytes have now been received
             int32_t parse_code;
             uint16_t length = (uint16_t)(lengthBuf[0] << 8) | lengthBuf[1];
-            char *pRxBuffer = (char *)pClient->pConfig->pRxBuffer;
-            parse_code = parseLine(pClient, pRxBuffer, pClient->rxBufferPos);
+            parse_code = parseLine(pClient, getLineBuffer(pClient), pClient->rxBufferPos);
             setupBinaryTransfer(pClient, parse_code, length);
+#if U_CX_USE_URC_QUEUE == 1
+            releaseUrcLineSlot(pClient, parse_code);
+#endif
             pClient->rxBufferPos = 0;
         }
     }
@@ -292,9 +382,9 @@ static int32_t handleBinaryRx(uCxAtClient_t *pClient)
         if (remainingBuf > 0) {
             // There are buffer left, continue to read
             size_t readLen = U_MIN(remainingBuf, pBinRx->remainingDataBytes);
-            readStatus = uPortUartRead(pClient->uartHandle,
+            readStatus = pClient->pUartOps->readFn(pClient->uartHandle,
                                        &pBinRx->pBuffer[pBinRx->bufferPos], readLen,
-                                       pClient->pConfig->timeoutMs);
+                                       timeoutMs);
             CHECK_READ_ERROR(pClient, readStatus);
             if (readStatus > 0) {
                 pBinRx->bufferPos += (uint16_t)readStatus;
@@ -303,9 +393,9 @@ static int32_t handleBinaryRx(uCxAtClient_t *pClient)
             // There are no buffer space - just throw away all data until binary transfer is done
             uint8_t buf[64];
             size_t readLen = U_MIN(sizeof(buf), pBinRx->remainingDataBytes);
-            readStatus = uPortUartRead(pClient->uartHandle,
+            readStatus = pClient->pUartOps->readFn(pClient->uartHandle,
                                        &buf[0], readLen,
-                                       pClient->pConfig->timeoutMs);
+                                       timeoutMs);
             CHECK_READ_ERROR(pClient, readStatus);
         }
 
@@ -354,57 +444,83 @@ static int32_t handleBinaryRx(uCxAtClient_t *pClient)
     return ret;
 }
 
-static int32_t handleRxData(uCxAtClient_t *pClient)
+/* timeoutMs is how long the UART read may wait when no data is available */
+static int32_t handleRxData(uCxAtClient_t *pClient, int32_t timeoutMs)
 {
     int32_t ret = AT_PARSER_NOP;
+    bool readMore;
 
     do {
         int32_t readStatus;
 
+        readMore = false;
         if (!pClient->isBinaryRx) {
             // Loop for receiving string data
             do {
                 char ch;
-                readStatus = uPortUartRead(pClient->uartHandle, &ch, 1,
-                                           pClient->pConfig->timeoutMs);
+                readStatus = pClient->pUartOps->readFn(pClient->uartHandle, &ch, 1,
+                                           timeoutMs);
                 CHECK_READ_ERROR(pClient, readStatus);
                 if (readStatus != 1) {
                     break;
                 }
+                bool lineEnd = (pClient->rxBufferPos > 0) && ((ch == '\r') || (ch == '\n'));
                 ret = parseIncomingChar(pClient, ch);
+                if (lineEnd && !pClient->executingCmd) {
+                    // Only continue with data that is already available so that a
+                    // steady stream of URCs can't keep cmdMutex locked and hold back
+                    // both commands and URC dispatching
+                    timeoutMs = 0;
+                }
             } while (ret == AT_PARSER_NOP);
         } else {
-            ret = handleBinaryRx(pClient);
+            ret = handleBinaryRx(pClient, timeoutMs);
+            if ((ret == AT_PARSER_NOP) && !pClient->isBinaryRx && !pClient->executingCmd) {
+                // A binary URC is done. Continue with data that is already available,
+                // as after a string URC, since it may be held in a read-ahead buffer
+                // of the port where polling the device won't report it.
+                timeoutMs = 0;
+                readMore = true;
+            }
         }
 
         if (ret == AT_PARSER_START_BINARY) {
             pClient->isBinaryRx = true;
+            readMore = true;
         }
-    } while (ret == AT_PARSER_START_BINARY);
+    } while (readMore);
 
     return ret;
 }
 
 #if U_CX_USE_URC_QUEUE == 1
-static void processUrcs(uCxAtClient_t *pClient)
+static void dispatchUrcs(uCxAtClient_t *pClient)
 {
-    while (true) {
-        uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&pClient->urcQueue);
-        if (pEntry == NULL) {
-            break;
-        }
-        if (pClient->urcCallback) {
-            char *pUrcLine = (char *)&pEntry->data[0];
-            uint8_t *pPayload = NULL;
-            if (pEntry->payloadSize > 0) {
-                pPayload = &pEntry->data[pEntry->strLineLen + 1];
-            }
-            pClient->urcCallback(pClient, pClient->pUrcCallbackTag, pUrcLine,
-                                 pEntry->strLineLen, pPayload, pEntry->payloadSize);
-        }
-        uCxAtUrcQueueDequeueEnd(&pClient->urcQueue, pEntry);
+    // The executor is called with urcMutex held so that it can't be called
+    // with a stale argument after uCxAtClientSetUrcExecutor() has returned
+    U_CX_MUTEX_LOCK(pClient->urcMutex);
+    uUrcExecutor_t executor = pClient->urcExecutor;
+    if ((executor != NULL) && (uCxAtUrcQueueGetCount(&pClient->urcQueue, NULL) > 0)) {
+        executor(pClient, pClient->pUrcExecutorArg);
+    }
+    U_CX_MUTEX_UNLOCK(pClient->urcMutex);
+
+    if (executor == NULL) {
+        uCxAtClientProcessUrcs(pClient);
     }
 }
+
+// Must be called with urcMutex locked.
+static void updateUrcStats(uCxAtClient_t *pClient, const uUrcEntry_t *pEntry)
+{
+    if (pEntry->timestampMs != 0) {
+        int32_t latency = U_CX_PORT_GET_TIME_MS() - pEntry->timestampMs;
+        pClient->urcMaxLatencyMs = U_MAX(pClient->urcMaxLatencyMs, latency);
+        pClient->urcTotLatencyMs += (uint64_t)U_MAX(latency, 0);
+        pClient->urcLatencyCount++;
+    }
+    pClient->urcDispatchCount++;
+}
 #endif
 
 static void cmdBeginF(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt, va_list args)
@@ -419,15 +535,27 @@ static void cmdBeginF(uCxAtClient_t *pClient, const char *pCmd, const char *pPar
     pClient->executingCmd = true;
     pClient->status = NO_STATUS;
     pClient->cmdStartTime = U_CX_PORT_GET_TIME_MS();
-    uCxAtClientSendCmdVaList(pClient, pCmd, pParamFmt, args);
+    if (uCxAtClientSendCmdVaList(pClient, pCmd, pParamFmt, args) != 0) {
+        // The module got an incomplete command so there is no status to wait for
+        pClient->status = U_CX_ERROR_IO;
+    }
+}
+
+// While waiting for a command response the UART read blocks until data
+// arrives or the command times out, instead of spinning on empty reads
+static int32_t cmdRxTimeout(const uCxAtClient_t *pClient, int32_t now)
+{
+    int32_t remainingMs = pClient->cmdTimeout - (now - pClient->cmdStartTime);
+    return U_MAX(remainingMs, 0);
 }
 
 static int32_t cmdEnd(uCxAtClient_t *pClient)
 {
+    int32_t now = pClient->cmdStartTime;
     while (pClient->status == NO_STATUS) {
-        handleRxData(pClient);
+        handleRxData(pClient, cmdRxTimeout(pClient, now));
 
-        int32_t now = U_CX_PORT_GET_TIME_MS();
+        now = U_CX_PORT_GET_TIME_MS();
         if ((now - pClient->cmdStartTime) > pClient->cmdTimeout) {
             pClient->status = U_CX_ERROR_CMD_TIMEOUT;
             U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance, "Command timeout");
@@ -447,21 +575,45 @@ static int32_t cmdEnd(uCxAtClient_t *pClient)
 
 #if U_CX_USE_URC_QUEUE == 1
     // We may have received URCs during command execution
-    processUrcs(pClient);
+    dispatchUrcs(pClient);
 #endif
 
     return pClient->status;
 }
 
-static inline int32_t writeAndLog(uCxAtClient_t *pClient, const void *pData, size_t dataLen)
+// Check the result of a UART write. A backend may accept only part of the
+// data, e.g. the TX queue of the Linux port when flow control stalls.
+static int32_t checkWrite(uCxAtClient_t *pClient, int32_t writeStatus, size_t dataLen)
 {
-    U_CX_LOG(U_CX_LOG_CH_TX, "%s", (char *)pData);
-    return uPortUartWrite(pClient->uartHandle, pData, dataLen);
+    if ((writeStatus != (int32_t)dataLen) && !pClient->txError) {
+        pClient->txError = true;
+        pClient->lastIoError = (writeStatus < 0) ? writeStatus : U_CX_ERROR_IO;
+        U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance,
+                        "write() of %d bytes returned: %d", (int)dataLen, writeStatus);
+    }
+    return writeStatus;
 }
 
 static inline int32_t writeNoLog(uCxAtClient_t *pClient, const void *pData, size_t dataLen)
 {
-    return uPortUartWrite(pClient->uartHandle, pData, dataLen);
+    if (pClient->txError) {
+        // Don't send the rest of a command that is already incomplete
+        return U_CX_ERROR_IO;
+    }
+    return checkWrite(pClient, pClient->pUartOps->writeFn(pClient->uartHandle, pData, dataLen),
+                      dataLen);
+}
+
+static inline int32_t writeAndLog(uCxAtClient_t *pClient, const void *pData, size_t dataLen)
+{
+    U_CX_LOG(U_CX_LOG_CH_TX, "%.*s", (int)dataLen, (const char *)pData);
+    return writeNoLog(pClient, pData, dataLen);
+}
+
+// Write function for uCxAtUtilWriteEscStringStream()
+static int32_t writeAndLogCallback(void *pArg, const void *pData, size_t dataLen)
+{
+    return writeAndLog((uCxAtClient_t *)pArg, pData, dataLen);
 }
 
 /* ----------------------------------------------------------------
@@ -472,12 +624,14 @@ void uCxAtClientInit(const uCxAtClientConfig_t *pConfig, uCxAtClient_t *pClient)
 {
     memset(pClient, 0, sizeof(uCxAtClient_t));
     pClient->pConfig = pConfig;
+    pClient->pUartOps = &gDefaultUartOps;
     pClient->cmdTimeoutLastPerm = U_CX_DEFAULT_CMD_TIMEOUT_MS;
     pClient->cmdTimeout = pClient->cmdTimeoutLastPerm;
     pClient->instance = gNextInstance++;
 
 #if U_CX_USE_URC_QUEUE == 1
     uCxAtUrcQueueInit(&pClient->urcQueue, pConfig->pUrcBuffer, pConfig->urcBufferLen);
+    U_CX_MUTEX_CREATE(pClient->urcMutex);
 #endif
     U_CX_MUTEX_CREATE(pClient->cmdMutex);
 
@@ -492,6 +646,7 @@ void uCxAtClientDeinit(uCxAtClient_t *pClient)
 
 #if U_CX_USE_URC_QUEUE == 1
     uCxAtUrcQueueDeInit(&pClient->urcQueue);
+    U_CX_MUTEX_DELETE(pClient->urcMutex);
 #endif
     U_CX_MUTEX_DELETE(pClient->cmdMutex);
 }
@@ -509,7 +664,9 @@ int32_t uCxAtClientOpen(uCxAtClient_t *pClient, int32_t baudRate, bool flowContr
         return U_CX_ERROR_INVALID_PARAMETER;
     }
 
-    pClient->uartHandle = uPortUartOpen(pConfig->pUartDevName, baudRate, flowControl);
+    pClient->pUartOps = (pConfig->pUartOps != NULL) ? pConfig->pUartOps : &gDefaultUartOps;
+    pClient->uartHandle = pClient->pUartOps->openFn(pConfig->pUartDevName, baudRate, flowControl,
+                                                    pConfig->uartFlags);
     if (pClient->uartHandle == NULL) {
         return U_CX_ERROR_IO;
     }
@@ -525,25 +682,35 @@ void uCxAtClientClose(uCxAtClient_t *pClient)
     }
 
     if (pClient->uartHandle != NULL) {
-        uPortUartClose(pClient->uartHandle);
+        pClient->pUartOps->closeFn(pClient->uartHandle);
         pClient->uartHandle = NULL;
     }
 
     pClient->opened = false;
 }
 
+int32_t uCxAtClientGetPollFd(const uCxAtClient_t *pClient)
+{
+    if (!pClient->opened || ((pClient->pUartOps->caps & U_PORT_UART_CAP_POLL_FD) == 0)) {
+        return -1;
+    }
+    return pClient->pUartOps->getFdFn(pClient->uartHandle);
+}
+
 void uCxAtClientSetUrcCallback(uCxAtClient_t *pClient, uUrcCallback_t urcCallback, void *pTag)
 {
     pClient->urcCallback = urcCallback;
     pClient->pUrcCallbackTag = pTag;
 }
 
-void uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt,
-                              va_list args)
+int32_t uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt,
+                                 va_list args)
 {
     bool binaryTransfer = false;
     char buf[U_IP_STRING_MAX_LENGTH_BYTES];
 
+    pClient->txError = false;
+
     U_CX_LOG_BEGIN_I(U_CX_LOG_CH_TX, pClient->instance);
 
     writeAndLog(pClient, pCmd, strlen(pCmd));
@@ -585,30 +752,16 @@ void uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const ch
             case 's': {
                 // String
                 char *pStr = va_arg(args, char *);
-                size_t len = uCxAtUtilWriteEscString(pStr, strlen(pStr), buf, sizeof(buf));
-                if (len > 0) {
-                    writeAndLog(pClient, buf, len);
-                } else {
-                    // Buffer too small, fall back to unescaped
-                    writeAndLog(pClient, "\"", 1);
-                    writeAndLog(pClient, pStr, strlen(pStr));
-                    writeAndLog(pClient, "\"", 1);
-                }
+                uCxAtUtilWriteEscStringStream(pStr, strlen(pStr), buf, sizeof(buf),
+                                              writeAndLogCallback, pClient);
             }
             break;
             case '$': {
                 // Binary string (uses a length arg instead)
                 char *pStr = va_arg(args, char *);
                 size_t strLen = va_arg(args, size_t);
-                size_t len = uCxAtUtilWriteEscString(pStr, strLen, buf, sizeof(buf));
-                if (len > 0) {
-                    writeAndLog(pClient, buf, len);
-                } else {
-                    // Buffer too small, fall back to unescaped
-                    writeAndLog(pClient, "\"", 1);
-                    writeAndLog(pClient, pStr, strLen);
-                    writeAndLog(pClient, "\"", 1);
-                }
+                uCxAtUtilWriteEscStringStream(pStr, strLen, buf, sizeof(buf),
+                                              writeAndLogCallback, pClient);
             }
             break;
             case 'i': {
@@ -644,8 +797,19 @@ void uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const ch
                 binHeader[1] = (char)(len >> 8);
                 binHeader[2] = (char)(len & 0xFF);
                 U_CX_AT_PORT_ASSERT(len > 0);
-                writeNoLog(pClient, binHeader, sizeof(binHeader));
-                writeNoLog(pClient, pData, (size_t)len);
+                if (((pClient->pUartOps->caps & U_PORT_UART_CAP_WRITEV) != 0) &&
+                    !pClient->txError) {
+                    // Header and payload in one write
+                    const uPortUartIoVec_t iov[2] = {
+                        { binHeader, sizeof(binHeader) },
+                        { pData, (size_t)len }
+                    };
+                    checkWrite(pClient, pClient->pUartOps->writevFn(pClient->uartHandle, iov, 2),
+                               sizeof(binHeader) + (size_t)len);
+                } else {
+                    writeNoLog(pClient, binHeader, sizeof(binHeader));
+                    writeNoLog(pClient, pData, (size_t)len);
+                }
                 U_CX_LOG(U_CX_LOG_CH_TX, "[%d bytes]", len);
 
                 // Binary transfer must always be last param
@@ -676,9 +840,11 @@ void uCxAtClientSendCmdVaList(uCxAtClient_t *pClient, const char *pCmd, const ch
     }
 
     if (!binaryTransfer) {
-        uPortUartWrite(pClient->uartHandle, "\r", 1);
+        writeNoLog(pClient, "\r", 1);
     }
     U_CX_LOG_END(U_CX_LOG_CH_TX);
+
+    return pClient->txError ? U_CX_ERROR_IO : 0;
 }
 
 int32_t uCxAtClientExecSimpleCmdF(uCxAtClient_t *pClient, const char *pCmd, const char *pParamFmt,
@@ -721,13 +887,14 @@ char *uCxAtClientCmdGetRspParamLine(uCxAtClient_t *pClient, const char *pExpecte
         pClient->pExpectedRspLen = 0;
     }
 
+    int32_t now = pClient->cmdStartTime;
     while (pClient->status == NO_STATUS) {
-        if (handleRxData(pClient) == AT_PARSER_GOT_RSP) {
+        if (handleRxData(pClient, cmdRxTimeout(pClient, now)) == AT_PARSER_GOT_RSP) {
             pRet = pClient->pRspParams;
             break;
         }
         // Check for timeout
-        int32_t now = U_CX_PORT_GET_TIME_MS();
+        now = U_CX_PORT_GET_TIME_MS();
         if ((now - pClient->cmdStartTime) > pClient->cmdTimeout) {
             U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance, "Command timeout");
             return NULL;
@@ -768,16 +935,86 @@ void uCxAtClientHandleRx(uCxAtClient_t *pClient)
     U_CX_MUTEX_LOCK(pClient->cmdMutex);
 
     if (!pClient->executingCmd) {
-        handleRxData(pClient);
+        handleRxData(pClient, pClient->pConfig->timeoutMs);
     }
 
     U_CX_MUTEX_UNLOCK(pClient->cmdMutex);
 
 #if U_CX_USE_URC_QUEUE == 1
-    processUrcs(pClient);
+    dispatchUrcs(pClient);
 #endif
 }
 
+#if U_CX_USE_URC_QUEUE == 1
+void uCxAtClientSetUrcExecutor(uCxAtClient_t *pClient, uUrcExecutor_t executor, void *pArg)
+{
+    U_CX_MUTEX_LOCK(pClient->urcMutex);
+    pClient->pUrcExecutorArg = pArg;
+    pClient->urcExecutor = executor;
+    U_CX_MUTEX_UNLOCK(pClient->urcMutex);
+}
+
+void uCxAtClientSetUrcCoalesceRules(uCxAtClient_t *pClient,
+                                    const uCxAtUrcCoalesceRule_t *pRules, size_t numRules)
+{
+    uCxAtUrcQueueSetCoalesceRules(&pClient->urcQueue, pRules, numRules);
+}
+
+int32_t uCxAtClientSetUrcClasses(uCxAtClient_t *pClient,
+                                 const uCxAtUrcClassConfig_t *pClassConfigs,
+                                 const uCxAtUrcClassRule_t *pRules, size_t numRules)
+{
+    if (!uCxAtUrcQueueSetClasses(&pClient->urcQueue, pClassConfigs, pRules, numRules)) {
+        return U_CX_ERROR_INVALID_PARAMETER;
+    }
+    return 0;
+}
+
+void uCxAtClientProcessUrcs(uCxAtClient_t *pClient)
+{
+    while (true) {
+        uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&pClient->urcQueue);
+        if (pEntry == NULL) {
+            break;
+        }
+        if (pClient->urcCallback) {
+            char *pUrcLine = (char *)&pEntry->data[0];
+            uint8_t *pPayload = NULL;
+            if (pEntry->payloadSize > 0) {
+                pPayload = &pEntry->data[pEntry->strLineLen + 1];
+            }
+            pClient->urcCallback(pClient, pClient->pUrcCallbackTag, pUrcLine,
+                                 pEntry->strLineLen, pPayload, pEntry->payloadSize);
+        }
+        U_CX_MUTEX_LOCK(pClient->urcMutex);
+        updateUrcStats(pClient, pEntry);
+        U_CX_MUTEX_UNLOCK(pClient->urcMutex);
+        uCxAtUrcQueueDequeueEnd(&pClient->urcQueue, pEntry);
+    }
+}
+
+void uCxAtClientGetUrcStats(uCxAtClient_t *pClient, uCxAtUrcStats_t *pStats)
+{
+    memset(pStats, 0, sizeof(uCxAtUrcStats_t));
+    pStats->queueDepth = uCxAtUrcQueueGetCount(&pClient->urcQueue, &pStats->peakQueueDepth);
+    pStats->coalescedCount = pClient->urcQueue.coalescedCount;
+    for (size_t i = 0; i < U_CX_URC_CLASS_COUNT; i++) {
+        uint32_t classDropCount;
+        uCxAtUrcQueueGetClassStats(&pClient->urcQueue, (uCxAtUrcClass_t)i,
+                                   &pStats->classQueueDepth[i], &classDropCount);
+        pStats->classDropCount[i] = classDropCount;
+        pStats->dropCount += classDropCount;
+    }
+    U_CX_MUTEX_LOCK(pClient->urcMutex);
+    pStats->dispatchCount = pClient->urcDispatchCount;
+    pStats->maxLatencyMs = pClient->urcMaxLatencyMs;
+    if (pClient->urcLatencyCount > 0) {
+        pStats->avgLatencyMs = (int32_t)(pClient->urcTotLatencyMs / pClient->urcLatencyCount);
+    }
+    U_CX_MUTEX_UNLOCK(pClient->urcMutex);
+}
+#endif
+
 int32_t uCxAtClientGetLastIoError(uCxAtClient_t *pClient)
 {
     return pClient->lastIoError;
@@ -22,6 +22,9 @@
 #include "stdint.h"
 #include "stdbool.h"
 #include "string.h"
+#include "stdlib.h"
+#include "stdio.h"
+#include "ctype.h"
 
 #include "u_cx_log.h"
 #include "u_cx_at_urc_queue.h"
@@ -32,8 +35,14 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
-#define U_URC_ENTRY_SIZE(ENTRY) \
-    ((size_t)(ENTRY->strLineLen + 1 + ENTRY->payloadSize))
+/* All entries start at an aligned offset so that the entry header can be accessed safely */
+#define U_URC_ENTRY_ALIGN  sizeof(int32_t)
+
+#define U_URC_ALIGN_UP(SIZE) \
+    (((SIZE) + U_URC_ENTRY_ALIGN - 1) & ~(U_URC_ENTRY_ALIGN - 1))
+
+#define U_URC_ALIGN_DOWN(SIZE) \
+    ((SIZE) & ~(U_URC_ENTRY_ALIGN - 1))
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -51,9 +60,310 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-static inline size_t getUnusedBuf(uCxAtUrcQueue_t *pUrcQueue)
+static uint32_t fnv1aHash(uint32_t hash, const void *pData, size_t len)
+{
+    const uint8_t *pBytes = (const uint8_t *)pData;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= pBytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static inline size_t alignedEntrySize(size_t strLineLen, size_t payloadSize)
+{
+    return U_URC_ALIGN_UP(sizeof(uUrcEntry_t) + strLineLen + 1 + payloadSize);
+}
+
+static inline bool isEmpty(uCxAtUrcPartition_t *pPart)
+{
+    return (pPart->wrapPos == 0) && (pPart->readPos == pPart->writePos);
+}
+
+static inline uUrcEntry_t *getOldestEntry(uCxAtUrcPartition_t *pPart)
+{
+    return (uUrcEntry_t *)&pPart->pBuffer[pPart->readPos];
+}
+
+static void initPartition(uCxAtUrcPartition_t *pPart, uint8_t *pBuffer, size_t bufferLen,
+                          uCxAtUrcDropPolicy_t dropPolicy)
+{
+    memset(pPart, 0, sizeof(uCxAtUrcPartition_t));
+    pPart->pBuffer = pBuffer;
+    pPart->bufferLen = bufferLen;
+    pPart->dropPolicy = dropPolicy;
+}
+
+// Select the partition for a URC based on the URC class rules
+static uCxAtUrcPartition_t *getPartition(uCxAtUrcQueue_t *pUrcQueue,
+                                         const char *pLine, size_t lineLen)
+{
+    uCxAtUrcClass_t urcClass = U_CX_URC_CLASS_DATA;
+    for (size_t i = 0; i < pUrcQueue->numClassRules; i++) {
+        const uCxAtUrcClassRule_t *pRule = &pUrcQueue->pClassRules[i];
+        size_t prefixLen = strlen(pRule->pPrefix);
+        if ((lineLen >= prefixLen) && (memcmp(pLine, pRule->pPrefix, prefixLen) == 0)) {
+            urcClass = pRule->urcClass;
+            break;
+        }
+    }
+    if (pUrcQueue->partitions[urcClass].bufferLen == 0) {
+        // Class is not used
+        urcClass = U_CX_URC_CLASS_DATA;
+    }
+    return &pUrcQueue->partitions[urcClass];
+}
+
+// Remove the oldest entry of a partition
+// Must be called with queueMutex locked.
+static void popEntry(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcPartition_t *pPart)
+{
+    uUrcEntry_t *pEntry = getOldestEntry(pPart);
+
+    pPart->readPos += pEntry->entrySize;
+    if ((pPart->wrapPos != 0) && (pPart->readPos >= pPart->wrapPos)) {
+        // All entries before the wrap have been removed - continue from start of buffer
+        pPart->readPos = 0;
+        pPart->wrapPos = 0;
+    }
+    if (pPart->pLastEntry == pEntry) {
+        pPart->pLastEntry = NULL;
+    }
+    pPart->count--;
+    pUrcQueue->count--;
+}
+
+// Drop the oldest entry of a partition (U_CX_URC_DROP_OLDEST)
+// Must be called with queueMutex locked.
+static bool dropOldest(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcPartition_t *pPart)
+{
+    if ((pPart->count == 0) || (getOldestEntry(pPart) == pUrcQueue->pDequeueEntry)) {
+        return false;
+    }
+    popEntry(pUrcQueue, pPart);
+    pPart->dropCount++;
+    return true;
+}
+
+// Try to reserve a contiguous slot of at least minSize bytes in a partition.
+// When preferLargest is true the largest available slot is reserved.
+// Must be called with queueMutex locked.
+static bool tryReserveSlot(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcPartition_t *pPart,
+                           size_t minSize, bool preferLargest)
+{
+    size_t offset;
+    size_t len;
+    bool wrap = false;
+
+    if (isEmpty(pPart)) {
+        // Nothing in the partition so start over from the beginning
+        pPart->readPos = 0;
+        pPart->writePos = 0;
+    }
+
+    if (pPart->wrapPos != 0) {
+        // Already wrapped - only the space up to the oldest entry is free
+        offset = pPart->writePos;
+        len = pPart->readPos - pPart->writePos;
+    } else {
+        size_t tailLen = pPart->bufferLen - pPart->writePos;
+        size_t headLen = pPart->readPos;
+        if (preferLargest) {
+            wrap = (headLen > tailLen);
+        } else {
+            wrap = (tailLen < minSize) && (headLen >= minSize);
+        }
+        offset = wrap ? 0 : pPart->writePos;
+        len = wrap ? headLen : tailLen;
+    }
+
+    if ((len < sizeof(uUrcEntry_t) + 1) || (len < minSize)) {
+        return false;
+    }
+
+    pUrcQueue->pEnqueueEntry = (uUrcEntry_t *)&pPart->pBuffer[offset];
+    pUrcQueue->pEnqueuePartition = pPart;
+    pUrcQueue->enqueueSlotLen = len;
+    pUrcQueue->enqueueWrap = wrap;
+    pUrcQueue->enqueueReplace = false;
+    return true;
+}
+
+// Reserve a slot and apply U_CX_URC_DROP_OLDEST if there is no room
+// Must be called with queueMutex locked.
+static bool reserveSlot(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcPartition_t *pPart,
+                        size_t minSize, bool preferLargest)
+{
+    U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry == NULL);
+
+    bool ret = tryReserveSlot(pUrcQueue, pPart, minSize, preferLargest);
+    while (!ret && (pPart->dropPolicy == U_CX_URC_DROP_OLDEST) && dropOldest(pUrcQueue, pPart)) {
+        ret = tryReserveSlot(pUrcQueue, pPart, minSize, preferLargest);
+    }
+    return ret;
+}
+
+// Find a queued entry with the same URC name and first param that the new
+// line fits in and reserve it for replacement (U_CX_URC_DROP_COALESCE)
+// Must be called with queueMutex locked.
+static bool reserveReplaceSlot(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcPartition_t *pPart,
+                               const char *pLine, size_t lineLen)
+{
+    const char *pSep = memchr(pLine, ',', lineLen);
+    size_t keyLen = (pSep != NULL) ? (size_t)(pSep - pLine) : lineLen;
+    size_t pos = pPart->readPos;
+
+    for (size_t i = 0; i < pPart->count; i++) {
+        uUrcEntry_t *pEntry = (uUrcEntry_t *)&pPart->pBuffer[pos];
+        if ((pEntry != pUrcQueue->pDequeueEntry) &&
+            (pEntry->strLineLen >= keyLen) &&
+            ((pEntry->strLineLen == keyLen) || (pEntry->data[keyLen] == ',')) &&
+            (memcmp(&pEntry->data[0], pLine, keyLen) == 0) &&
+            (alignedEntrySize(lineLen, 0) <= pEntry->entrySize)) {
+            pUrcQueue->pEnqueueEntry = pEntry;
+            pUrcQueue->pEnqueuePartition = pPart;
+            pUrcQueue->enqueueSlotLen = pEntry->entrySize;
+            pUrcQueue->enqueueWrap = false;
+            pUrcQueue->enqueueReplace = true;
+            return true;
+        }
+        pos += pEntry->entrySize;
+        if ((pPart->wrapPos != 0) && (pos >= pPart->wrapPos)) {
+            pos = 0;
+        }
+    }
+
+    return false;
+}
+
+// Try to merge the new entry into the last queued entry by summing the last param
+// Must be called with queueMutex locked.
+static bool coalesceSum(uCxAtUrcQueue_t *pUrcQueue, uUrcEntry_t *pNew, size_t prefixLen)
+{
+    uCxAtUrcPartition_t *pPart = pUrcQueue->pEnqueuePartition;
+    uUrcEntry_t *pLast = pPart->pLastEntry;
+    if ((pLast == NULL) || (pLast == pUrcQueue->pDequeueEntry) || (pLast->payloadSize > 0)) {
+        return false;
+    }
+
+    const char *pNewLine = (const char *)&pNew->data[0];
+    char *pLastLine = (char *)&pLast->data[0];
+    const char *pSep = strrchr(pNewLine, ',');
+    if (pSep == NULL) {
+        return false;
+    }
+    // The key is everything up to and including the last ','
+    size_t keyLen = (size_t)(pSep - pNewLine) + 1;
+    if ((keyLen <= prefixLen) || (pLast->strLineLen <= keyLen) ||
+        (memcmp(pLastLine, pNewLine, keyLen) != 0) ||
+        (strchr(&pLastLine[keyLen], ',') != NULL) ||
+        !isdigit((int)pLastLine[keyLen]) || !isdigit((int)pNewLine[keyLen])) {
+        return false;
+    }
+
+    char *pEnd;
+    long lastValue = strtol(&pLastLine[keyLen], &pEnd, 10);
+    if (*pEnd != 0) {
+        return false;
+    }
+    long newValue = strtol(&pNewLine[keyLen], &pEnd, 10);
+    if ((*pEnd != 0) || (lastValue > INT32_MAX - newValue)) {
+        return false;
+    }
+
+    char sumStr[12];
+    int sumLen = snprintf(sumStr, sizeof(sumStr), "%ld", lastValue + newValue);
+    size_t newLineLen = keyLen + (size_t)sumLen;
+
+    // The last entry may grow into the slot of the new entry if they are adjacent
+    uint8_t *pLastEnd = (uint8_t *)pLast + pLast->entrySize;
+    size_t capacity = pLast->entrySize;
+    if (pLastEnd == (uint8_t *)pNew) {
+        capacity += pUrcQueue->enqueueSlotLen;
+    }
+    if (alignedEntrySize(newLineLen, 0) > capacity) {
+        return false;
+    }
+
+    memcpy(&pLastLine[keyLen], sumStr, (size_t)sumLen + 1);
+    pLast->strLineLen = (uint16_t)newLineLen;
+    if (alignedEntrySize(newLineLen, 0) > pLast->entrySize) {
+        pLast->entrySize = (uint32_t)alignedEntrySize(newLineLen, 0);
+        pPart->writePos = (size_t)((uint8_t *)pLast - pPart->pBuffer) + pLast->entrySize;
+    }
+    return true;
+}
+
+// Check if the first param of the new entry has been seen within the rule window
+// Must be called with queueMutex locked.
+static bool coalesceDedup(uCxAtUrcQueue_t *pUrcQueue, uUrcEntry_t *pNew,
+                          const uCxAtUrcCoalesceRule_t *pRule, size_t prefixLen)
+{
+    const char *pNewLine = (const char *)&pNew->data[0];
+    size_t keyLen = prefixLen + strcspn(&pNewLine[prefixLen], ",");
+    uint32_t hash = fnv1aHash(2166136261u, pNewLine, keyLen);
+    int32_t now = pNew->timestampMs;
+    uCxAtUrcDedupEntry_t *pOldest = &pUrcQueue->dedupHistory[0];
+
+    for (size_t i = 0; i < U_CX_URC_DEDUP_HISTORY_SIZE; i++) {
+        uCxAtUrcDedupEntry_t *pHist = &pUrcQueue->dedupHistory[i];
+        if (!pHist->used) {
+            pOldest = pHist;
+            continue;
+        }
+        if ((pHist->hash == hash) && ((now - pHist->timestampMs) < pRule->windowMs)) {
+            return true;
+        }
+        if (pOldest->used && ((now - pHist->timestampMs) > (now - pOldest->timestampMs))) {
+            pOldest = pHist;
+        }
+    }
+
+    pOldest->hash = hash;
+    pOldest->timestampMs = now;
+    pOldest->used = true;
+    return false;
+}
+
+// Apply the coalescing rules to the entry being enqueued
+// Returns true if the entry has been merged or dropped.
+// Must be called with queueMutex locked.
+static bool coalesce(uCxAtUrcQueue_t *pUrcQueue, uUrcEntry_t *pNew)
 {
-    return pUrcQueue->bufferLen - pUrcQueue->bufferPos;
+    const char *pNewLine = (const char *)&pNew->data[0];
+
+    for (size_t i = 0; i < pUrcQueue->numCoalesceRules; i++) {
+        const uCxAtUrcCoalesceRule_t *pRule = &pUrcQueue->pCoalesceRules[i];
+        size_t prefixLen = strlen(pRule->pPrefix);
+        if ((pNew->strLineLen < prefixLen) ||
+            (memcmp(pNewLine, pRule->pPrefix, prefixLen) != 0)) {
+            continue;
+        }
+        if (pRule->mode == U_CX_URC_COALESCE_SUM) {
+            return coalesceSum(pUrcQueue, pNew, prefixLen);
+        }
+        return coalesceDedup(pUrcQueue, pNew, pRule, prefixLen);
+    }
+
+    return false;
+}
+
+// Get the partition holding the oldest entry (NULL if the queue is empty)
+// Must be called with queueMutex locked.
+static uCxAtUrcPartition_t *getOldestPartition(uCxAtUrcQueue_t *pUrcQueue)
+{
+    uCxAtUrcPartition_t *pOldestPart = NULL;
+    for (size_t i = 0; i < U_CX_URC_CLASS_COUNT; i++) {
+        uCxAtUrcPartition_t *pPart = &pUrcQueue->partitions[i];
+        if (pPart->count == 0) {
+            continue;
+        }
+        if ((pOldestPart == NULL) ||
+            ((int32_t)(getOldestEntry(pPart)->seq - getOldestEntry(pOldestPart)->seq) < 0)) {
+            pOldestPart = pPart;
+        }
+    }
+    return pOldestPart;
 }
 
 /* ----------------------------------------------------------------
@@ -62,11 +372,21 @@ static inline size_t getUnusedBuf(uCxAtUrcQueue_t *pUrcQueue)
 
 void uCxAtUrcQueueInit(uCxAtUrcQueue_t *pUrcQueue, void *pBuffer, size_t bufferLen)
 {
+    uint8_t *pAlignedBuffer = (uint8_t *)pBuffer;
+    size_t misalignment = (size_t)((uintptr_t)pAlignedBuffer % U_URC_ENTRY_ALIGN);
+    if ((misalignment > 0) && (bufferLen >= U_URC_ENTRY_ALIGN)) {
+        pAlignedBuffer += U_URC_ENTRY_ALIGN - misalignment;
+        bufferLen -= U_URC_ENTRY_ALIGN - misalignment;
+    }
+
     memset(pUrcQueue, 0, sizeof(uCxAtUrcQueue_t));
     U_CX_MUTEX_CREATE(pUrcQueue->queueMutex);
     U_CX_MUTEX_CREATE(pUrcQueue->dequeueMutex);
-    pUrcQueue->pBuffer = pBuffer;
-    pUrcQueue->bufferLen = bufferLen;
+    pUrcQueue->pBuffer = pAlignedBuffer;
+    pUrcQueue->bufferLen = U_URC_ALIGN_DOWN(bufferLen);
+    // Without URC classes all URCs are placed in the data class
+    initPartition(&pUrcQueue->partitions[U_CX_URC_CLASS_DATA],
+                  pUrcQueue->pBuffer, pUrcQueue->bufferLen, U_CX_URC_DROP_NEWEST);
 }
 
 void uCxAtUrcQueueDeInit(uCxAtUrcQueue_t *pUrcQueue)
@@ -75,28 +395,121 @@ void uCxAtUrcQueueDeInit(uCxAtUrcQueue_t *pUrcQueue)
     U_CX_MUTEX_DELETE(pUrcQueue->dequeueMutex);
 }
 
+bool uCxAtUrcQueueSetClasses(uCxAtUrcQueue_t *pUrcQueue,
+                             const uCxAtUrcClassConfig_t *pClassConfigs,
+                             const uCxAtUrcClassRule_t *pRules, size_t numRules)
+{
+    bool ret = false;
+
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    if ((pUrcQueue->count == 0) &&
+        (pUrcQueue->pEnqueueEntry == NULL) &&
+        (pUrcQueue->pDequeueEntry == NULL)) {
+        if (pClassConfigs == NULL) {
+            memset(&pUrcQueue->partitions[0], 0, sizeof(pUrcQueue->partitions));
+            initPartition(&pUrcQueue->partitions[U_CX_URC_CLASS_DATA],
+                          pUrcQueue->pBuffer, pUrcQueue->bufferLen, U_CX_URC_DROP_NEWEST);
+            pUrcQueue->pClassRules = NULL;
+            pUrcQueue->numClassRules = 0;
+            ret = true;
+        } else {
+            uint32_t totPercent = 0;
+            for (size_t i = 0; i < U_CX_URC_CLASS_COUNT; i++) {
+                totPercent += pClassConfigs[i].budgetPercent;
+            }
+            if ((totPercent <= 100) && (pClassConfigs[U_CX_URC_CLASS_DATA].budgetPercent > 0)) {
+                size_t offset = 0;
+                for (size_t i = 0; i < U_CX_URC_CLASS_COUNT; i++) {
+                    size_t len = U_URC_ALIGN_DOWN(pUrcQueue->bufferLen *
+                                                  pClassConfigs[i].budgetPercent / 100);
+                    initPartition(&pUrcQueue->partitions[i], &pUrcQueue->pBuffer[offset],
+                                  len, pClassConfigs[i].dropPolicy);
+                    offset += len;
+                }
+                pUrcQueue->pClassRules = pRules;
+                pUrcQueue->numClassRules = (pRules != NULL) ? numRules : 0;
+                ret = true;
+            }
+        }
+    }
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
+
+    return ret;
+}
+
+void uCxAtUrcQueueGetClassStats(uCxAtUrcQueue_t *pUrcQueue, uCxAtUrcClass_t urcClass,
+                                size_t *pCount, uint32_t *pDropCount)
+{
+    U_CX_AT_PORT_ASSERT(urcClass < U_CX_URC_CLASS_COUNT);
+
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    *pCount = pUrcQueue->partitions[urcClass].count;
+    *pDropCount = pUrcQueue->partitions[urcClass].dropCount;
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
+}
+
+void uCxAtUrcQueueSetCoalesceRules(uCxAtUrcQueue_t *pUrcQueue,
+                                   const uCxAtUrcCoalesceRule_t *pRules, size_t numRules)
+{
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    pUrcQueue->pCoalesceRules = pRules;
+    pUrcQueue->numCoalesceRules = (pRules != NULL) ? numRules : 0;
+    memset(&pUrcQueue->dedupHistory[0], 0, sizeof(pUrcQueue->dedupHistory));
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
+}
+
+size_t uCxAtUrcQueueEnqueueReserve(uCxAtUrcQueue_t *pUrcQueue, const char *pLineStart,
+                                   size_t lineStartLen, char **ppLine)
+{
+    size_t ret = 0;
+
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    uCxAtUrcPartition_t *pPart = getPartition(pUrcQueue, pLineStart, lineStartLen);
+    if (reserveSlot(pUrcQueue, pPart, sizeof(uUrcEntry_t) + lineStartLen + 1, true)) {
+        char *pLine = (char *)&pUrcQueue->pEnqueueEntry->data[0];
+        memcpy(pLine, pLineStart, lineStartLen);
+        *ppLine = pLine;
+        // Leave room for the null terminator
+        ret = U_MIN(pUrcQueue->enqueueSlotLen - sizeof(uUrcEntry_t) - 1, UINT16_MAX);
+    }
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
+
+    return ret;
+}
+
 bool uCxAtUrcQueueEnqueueBegin(uCxAtUrcQueue_t *pUrcQueue, const char *pUrcLine, size_t urcLineLen)
 {
-    bool ret;
+    bool ret = true;
+    size_t requiredLen = sizeof(uUrcEntry_t) + urcLineLen + 1;
 
     U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
-    U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry == NULL);
+    if (pUrcQueue->pEnqueueEntry == NULL) {
+        uCxAtUrcPartition_t *pPart = getPartition(pUrcQueue, pUrcLine, urcLineLen);
+        ret = reserveSlot(pUrcQueue, pPart, requiredLen, false);
+        if (!ret && (pPart->dropPolicy == U_CX_URC_DROP_COALESCE)) {
+            ret = reserveReplaceSlot(pUrcQueue, pPart, pUrcLine, urcLineLen);
+        }
+        if (!ret) {
+            pPart->dropCount++;
+        }
+    } else if (pUrcQueue->enqueueSlotLen < requiredLen) {
+        // Not enough space in the reserved slot
+        pUrcQueue->pEnqueuePartition->dropCount++;
+        pUrcQueue->pEnqueueEntry = NULL;
+        ret = false;
+    }
 
-    int32_t availableDataSpace = (int32_t)(getUnusedBuf(pUrcQueue) - sizeof(uUrcEntry_t));
-    if (availableDataSpace >= (int32_t)urcLineLen + 1) {
-        uUrcEntry_t *pEntry = (uUrcEntry_t *)&pUrcQueue->pBuffer[pUrcQueue->bufferPos];
-        memcpy(&pEntry->data[0], pUrcLine, urcLineLen);
+    if (ret) {
+        uUrcEntry_t *pEntry = pUrcQueue->pEnqueueEntry;
+        if (pUrcLine != (const char *)&pEntry->data[0]) {
+            memcpy(&pEntry->data[0], pUrcLine, urcLineLen);
+        }
         pEntry->data[urcLineLen] = 0; // Add null term
+        pEntry->timestampMs = 0;
         pEntry->strLineLen = (uint16_t)urcLineLen;
         pEntry->payloadSize = 0;
-        pUrcQueue->bufferPos += sizeof(uUrcEntry_t) + urcLineLen + 1;
-        pUrcQueue->pEnqueueEntry = pEntry;
-        ret = true;
-    } else {
-        // Not enough space available
-        U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
-        ret = false;
     }
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
 
     return ret;
 }
@@ -106,28 +519,73 @@ uint16_t uCxAtUrcQueueEnqueueGetPayloadPtr(uCxAtUrcQueue_t *pUrcQueue, uint8_t *
     U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry);
 
     uUrcEntry_t *pEntry = pUrcQueue->pEnqueueEntry;
+    size_t usedLen = sizeof(uUrcEntry_t) + pEntry->strLineLen + 1;
     *ppPayload = &pEntry->data[pEntry->strLineLen + 1];
-    return (uint16_t)getUnusedBuf(pUrcQueue);
+    return (uint16_t)U_MIN(pUrcQueue->enqueueSlotLen - usedLen, UINT16_MAX);
 }
 
 void uCxAtUrcQueueEnqueueEnd(uCxAtUrcQueue_t *pUrcQueue, uint16_t payloadSize)
 {
     U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry);
-    U_CX_AT_PORT_ASSERT(getUnusedBuf(pUrcQueue) >= payloadSize);
 
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
     uUrcEntry_t *pEntry = pUrcQueue->pEnqueueEntry;
+    uCxAtUrcPartition_t *pPart = pUrcQueue->pEnqueuePartition;
+    size_t entryLen = sizeof(uUrcEntry_t) + pEntry->strLineLen + 1 + payloadSize;
+    U_CX_AT_PORT_ASSERT(pUrcQueue->enqueueSlotLen >= entryLen);
+
     pEntry->payloadSize = payloadSize;
-    pUrcQueue->bufferPos += payloadSize;
+    if (pUrcQueue->enqueueReplace) {
+        // A queued URC was replaced (U_CX_URC_DROP_COALESCE) - it keeps its
+        // position in the queue
+        pPart->dropCount++;
+    } else if ((payloadSize == 0) && (pUrcQueue->numCoalesceRules > 0) &&
+               coalesce(pUrcQueue, pEntry)) {
+        // The URC was merged or dropped so the slot is just released
+        pUrcQueue->coalescedCount++;
+    } else {
+        size_t offset = (size_t)((uint8_t *)pEntry - pPart->pBuffer);
+        if (pUrcQueue->enqueueWrap) {
+            if (pPart->readPos == pPart->writePos) {
+                // All entries before the wrap were dequeued while we were enqueueing
+                pPart->readPos = 0;
+            } else {
+                pPart->wrapPos = pPart->writePos;
+            }
+        }
+        // The slot always ends at an aligned offset so it is safe to align up
+        pEntry->entrySize = (uint32_t)U_URC_ALIGN_UP(entryLen);
+        pEntry->seq = pUrcQueue->nextSeq++;
+        pPart->writePos = offset + pEntry->entrySize;
+        pPart->pLastEntry = pEntry;
+        pPart->count++;
+        pUrcQueue->count++;
+        pUrcQueue->peakCount = U_MAX(pUrcQueue->peakCount, pUrcQueue->count);
+    }
     pUrcQueue->pEnqueueEntry = NULL;
     U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
 }
 
+void uCxAtUrcQueueEnqueueSetTimestamp(uCxAtUrcQueue_t *pUrcQueue, int32_t timestampMs)
+{
+    U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry);
+
+    pUrcQueue->pEnqueueEntry->timestampMs = timestampMs;
+}
+
 void uCxAtUrcQueueEnqueueAbort(uCxAtUrcQueue_t *pUrcQueue)
 {
     U_CX_AT_PORT_ASSERT(pUrcQueue->pEnqueueEntry);
 
-    uint8_t *pEntry = (uint8_t *)pUrcQueue->pEnqueueEntry;
-    pUrcQueue->bufferPos = (size_t)(pEntry - pUrcQueue->pBuffer);
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    if (pUrcQueue->enqueueReplace) {
+        // The replaced URC has already been overwritten so turn it into an
+        // empty entry that will be skipped when dequeueing
+        pUrcQueue->pEnqueueEntry->strLineLen = 0;
+        pUrcQueue->pEnqueueEntry->payloadSize = 0;
+        pUrcQueue->pEnqueuePartition->dropCount++;
+    }
+    // Nothing has been committed so just forget about the slot
     pUrcQueue->pEnqueueEntry = NULL;
     U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
 }
@@ -140,14 +598,29 @@ uUrcEntry_t *uCxAtUrcQueueDequeueBegin(uCxAtUrcQueue_t *pUrcQueue)
         U_CX_AT_PORT_ASSERT(pUrcQueue->pDequeueEntry == NULL);
 
         U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
-        if (pUrcQueue->bufferPos > 0) {
-            pEntry = (uUrcEntry_t *)&pUrcQueue->pBuffer[0];
+        while (true) {
+            uCxAtUrcPartition_t *pPart = getOldestPartition(pUrcQueue);
+            if (pPart == NULL) {
+                break;
+            }
+            uUrcEntry_t *pOldest = getOldestEntry(pPart);
+            if (pOldest == pUrcQueue->pEnqueueEntry) {
+                // The oldest URC is currently being replaced - wait for it to complete
+                break;
+            }
+            if (pOldest->strLineLen == 0) {
+                // Skip aborted entries
+                popEntry(pUrcQueue, pPart);
+                continue;
+            }
+            pEntry = pOldest;
+            pUrcQueue->pDequeueEntry = pEntry;
+            pUrcQueue->pDequeuePartition = pPart;
+            break;
         }
         U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
 
-        if (pEntry) {
-            pUrcQueue->pDequeueEntry = pEntry;
-        } else {
+        if (pEntry == NULL) {
             U_CX_MUTEX_UNLOCK(pUrcQueue->dequeueMutex);
         }
     }
@@ -157,27 +630,30 @@ uUrcEntry_t *uCxAtUrcQueueDequeueBegin(uCxAtUrcQueue_t *pUrcQueue)
 
 void uCxAtUrcQueueDequeueEnd(uCxAtUrcQueue_t *pUrcQueue, uUrcEntry_t *pEntry)
 {
-    int32_t remainingData;
+    (void)pEntry; // Only used for asserts
     U_CX_AT_PORT_ASSERT(pUrcQueue->pDequeueEntry != NULL);
     U_CX_AT_PORT_ASSERT(pUrcQueue->pDequeueEntry == pEntry);
 
     U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
-    size_t totEntrySize = sizeof(uUrcEntry_t) + U_URC_ENTRY_SIZE(pEntry);
-    remainingData = (int32_t)pUrcQueue->bufferPos - (int32_t)totEntrySize;
-    if (remainingData > 0) {
-        // Move the remaining data to start of buffer
-        // TODO: Replace with ring buffer to improve performance
-        memmove(pUrcQueue->pBuffer, &pUrcQueue->pBuffer[totEntrySize], (size_t)remainingData);
-        pUrcQueue->bufferPos -= totEntrySize;
-    } else {
-        // This was the only entry so no need to move anything
-        pUrcQueue->bufferPos = 0;
-    }
-    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
-
+    U_CX_AT_PORT_ASSERT(getOldestEntry(pUrcQueue->pDequeuePartition) == pEntry);
+    popEntry(pUrcQueue, pUrcQueue->pDequeuePartition);
     pUrcQueue->pDequeueEntry = NULL;
+    pUrcQueue->pDequeuePartition = NULL;
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
 
     U_CX_MUTEX_UNLOCK(pUrcQueue->dequeueMutex);
 }
 
+size_t uCxAtUrcQueueGetCount(uCxAtUrcQueue_t *pUrcQueue, size_t *pPeakCount)
+{
+    U_CX_MUTEX_LOCK(pUrcQueue->queueMutex);
+    size_t count = pUrcQueue->count;
+    if (pPeakCount != NULL) {
+        *pPeakCount = pUrcQueue->peakCount;
+    }
+    U_CX_MUTEX_UNLOCK(pUrcQueue->queueMutex);
+
+    return count;
+}
+
 #endif // U_CX_USE_URC_QUEUE == 1
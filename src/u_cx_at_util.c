@@ -30,6 +30,19 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/* SIMD hex conversion and escape scanning is selected at build time based on the target CPU */
+#if (U_CX_USE_SIMD == 1) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+# define U_UTIL_USE_SSE2
+# include <emmintrin.h>
+#elif (U_CX_USE_SIMD == 1) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+# define U_UTIL_USE_NEON
+# include <arm_neon.h>
+#endif
+
+/* Number of bytes processed per SIMD iteration */
+#define U_UTIL_SIMD_BLOCK_SIZE   16
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -39,12 +52,45 @@
  * -------------------------------------------------------------- */
 
 static int32_t hexToNibble(char c);
-static size_t unescapeString(char *pStr);
+static size_t unescapeString(char *pStr, size_t length);
 
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
+/* ----------------------------------------------------------------
+ * PUBLIC VARIABLES
+ * -------------------------------------------------------------- */
+
+#define IGN  U_CX_AT_BYTE_IGNORE
+#define PRT  U_CX_AT_BYTE_PRINT
+#define EOL  U_CX_AT_BYTE_EOL
+#define SOH  U_CX_AT_BYTE_SOH
+
+const uint8_t gUCxAtByteClass[256] = {
+    /* 0x00 */ IGN, SOH, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, EOL, IGN, IGN, EOL, IGN, IGN,
+    /* 0x10 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0x20 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT,
+    /* 0x30 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT,
+    /* 0x40 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT,
+    /* 0x50 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT,
+    /* 0x60 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT,
+    /* 0x70 */ PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, PRT, IGN,
+    /* 0x80 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0x90 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xA0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xB0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xC0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xD0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xE0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN,
+    /* 0xF0 */ IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN, IGN
+};
+
+#undef IGN
+#undef PRT
+#undef EOL
+#undef SOH
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -69,6 +115,241 @@ static inline int32_t hexToNibble(char hexChar)
     return -1;
 }
 
+#if defined(U_UTIL_USE_SSE2)
+// Convert 16 nibbles (0-15) to upper case hex characters
+static inline __m128i nibblesToHexSse2(__m128i nibbles)
+{
+    __m128i letterAdjust = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                         _mm_set1_epi8('A' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letterAdjust);
+}
+
+// Convert 16 hex characters to nibbles. *pValidMask will have bits set for valid characters.
+static inline __m128i hexToNibblesSse2(__m128i hex, __m128i *pValidMask)
+{
+    // Setting bit 5 makes 'A'-'F' lower case. The digits are checked on the
+    // unmodified characters as the bit would also turn 0x10-0x19 into '0'-'9'.
+    __m128i lower = _mm_or_si128(hex, _mm_set1_epi8(0x20));
+    __m128i digit = _mm_sub_epi8(hex, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(lower, _mm_set1_epi8('a'));
+    __m128i digitMask = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)),
+                                      _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+    __m128i letterMask = _mm_and_si128(_mm_cmpgt_epi8(letter, _mm_set1_epi8(-1)),
+                                       _mm_cmplt_epi8(letter, _mm_set1_epi8(6)));
+    *pValidMask = _mm_or_si128(digitMask, letterMask);
+    return _mm_or_si128(_mm_and_si128(digitMask, digit),
+                        _mm_and_si128(letterMask, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// Combine the nibble pairs of 16 nibbles into 8 bytes (in the low byte of each 16 bit lane)
+static inline __m128i packNibblesSse2(__m128i nibbles)
+{
+    __m128i bytes = _mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8));
+    return _mm_and_si128(bytes, _mm_set1_epi16(0x00FF));
+}
+#endif
+
+#if defined(U_UTIL_USE_NEON)
+// Check if all bytes of a comparison result are set
+static inline bool allSetNeon(uint8x16_t mask)
+{
+# if defined(__aarch64__)
+    return vminvq_u8(mask) == 0xFF;
+# else
+    uint8x8_t min = vpmin_u8(vget_low_u8(mask), vget_high_u8(mask));
+    min = vpmin_u8(min, min);
+    min = vpmin_u8(min, min);
+    min = vpmin_u8(min, min);
+    return vget_lane_u8(min, 0) == 0xFF;
+# endif
+}
+#endif
+
+// Convert dataLen bytes to hex (no null terminator is added)
+static void hexEncode(const uint8_t *pData, size_t dataLen, char *pOut)
+{
+    size_t i = 0;
+
+#if defined(U_UTIL_USE_SSE2)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= dataLen; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        __m128i data = _mm_loadu_si128((const __m128i *)&pData[i]);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(data, 4), _mm_set1_epi8(0x0F));
+        __m128i low = _mm_and_si128(data, _mm_set1_epi8(0x0F));
+        high = nibblesToHexSse2(high);
+        low = nibblesToHexSse2(low);
+        _mm_storeu_si128((__m128i *)&pOut[i * 2], _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i *)&pOut[(i * 2) + 16], _mm_unpackhi_epi8(high, low));
+    }
+#elif defined(U_UTIL_USE_NEON)
+    const uint8x16_t nibbleMask = vdupq_n_u8(0x0F);
+    const uint8x16_t nine = vdupq_n_u8(9);
+    const uint8x16_t letterAdjust = vdupq_n_u8('A' - '0' - 10);
+    const uint8x16_t zeroChar = vdupq_n_u8('0');
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= dataLen; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        uint8x16_t data = vld1q_u8(&pData[i]);
+        uint8x16x2_t hex;
+        hex.val[0] = vshrq_n_u8(data, 4);
+        hex.val[1] = vandq_u8(data, nibbleMask);
+        for (int j = 0; j < 2; j++) {
+            uint8x16_t adjust = vandq_u8(vcgtq_u8(hex.val[j], nine), letterAdjust);
+            hex.val[j] = vaddq_u8(vaddq_u8(hex.val[j], zeroChar), adjust);
+        }
+        // Store high and low nibble characters interleaved
+        vst2q_u8((uint8_t *)&pOut[i * 2], hex);
+    }
+#endif
+
+    for (; i < dataLen; i++) {
+        pOut[i * 2] = nibbleToHex(pData[i] >> 4);
+        pOut[(i * 2) + 1] = nibbleToHex(pData[i] & 0x0F);
+    }
+}
+
+// Convert up to numBytes bytes from hex and stop at first invalid character.
+// pOut may point to pHex (i.e. in-place conversion).
+// Returns the number of converted bytes.
+static size_t hexDecode(const char *pHex, size_t numBytes, uint8_t *pOut)
+{
+    size_t i = 0;
+
+#if defined(U_UTIL_USE_SSE2)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= numBytes; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        __m128i valid0;
+        __m128i valid1;
+        __m128i nibbles0 = hexToNibblesSse2(_mm_loadu_si128((const __m128i *)&pHex[i * 2]),
+                                            &valid0);
+        __m128i nibbles1 = hexToNibblesSse2(_mm_loadu_si128((const __m128i *)&pHex[(i * 2) + 16]),
+                                            &valid1);
+        if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF) {
+            // Let the scalar code find the exact position of the invalid character
+            break;
+        }
+        _mm_storeu_si128((__m128i *)&pOut[i],
+                         _mm_packus_epi16(packNibblesSse2(nibbles0), packNibblesSse2(nibbles1)));
+    }
+#elif defined(U_UTIL_USE_NEON)
+    const uint8x16_t caseBit = vdupq_n_u8(0x20);
+    const uint8x16_t zeroChar = vdupq_n_u8('0');
+    const uint8x16_t aChar = vdupq_n_u8('a');
+    const uint8x16_t ten = vdupq_n_u8(10);
+    const uint8x16_t six = vdupq_n_u8(6);
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= numBytes; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        // De-interleave high nibble characters (val[0]) and low nibble characters (val[1])
+        uint8x16x2_t hex = vld2q_u8((const uint8_t *)&pHex[i * 2]);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        for (int j = 0; j < 2; j++) {
+            // Setting bit 5 makes 'A'-'F' lower case. The digits are checked on the
+            // unmodified characters as the bit would also turn 0x10-0x19 into '0'-'9'.
+            uint8x16_t lower = vorrq_u8(hex.val[j], caseBit);
+            uint8x16_t digit = vsubq_u8(hex.val[j], zeroChar);
+            uint8x16_t letter = vsubq_u8(lower, aChar);
+            uint8x16_t digitMask = vcltq_u8(digit, ten);
+            uint8x16_t letterMask = vcltq_u8(letter, six);
+            valid = vandq_u8(valid, vorrq_u8(digitMask, letterMask));
+            hex.val[j] = vbslq_u8(digitMask, digit, vaddq_u8(letter, ten));
+        }
+        if (!allSetNeon(valid)) {
+            // Let the scalar code find the exact position of the invalid character
+            break;
+        }
+        vst1q_u8(&pOut[i], vorrq_u8(vshlq_n_u8(hex.val[0], 4), hex.val[1]));
+    }
+#endif
+
+    for (; i < numBytes; i++) {
+        if (uCxAtUtilHexToByte(&pHex[i * 2], &pOut[i]) < 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+// Find the first '\\', '"', '[', ']' or ',' in pStr
+static size_t findParamChar(const char *pStr, size_t length)
+{
+    size_t i = 0;
+
+#if defined(U_UTIL_USE_SSE2)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= length; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        __m128i chars = _mm_loadu_si128((const __m128i *)&pStr[i]);
+        __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')),
+                                     _mm_cmpeq_epi8(chars, _mm_set1_epi8('"')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8('[')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8(']')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(chars, _mm_set1_epi8(',')));
+        if (_mm_movemask_epi8(match) != 0) {
+            break;
+        }
+    }
+#elif defined(U_UTIL_USE_NEON)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= length; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        uint8x16_t chars = vld1q_u8((const uint8_t *)&pStr[i]);
+        uint8x16_t match = vorrq_u8(vceqq_u8(chars, vdupq_n_u8('\\')),
+                                    vceqq_u8(chars, vdupq_n_u8('"')));
+        match = vorrq_u8(match, vceqq_u8(chars, vdupq_n_u8('[')));
+        match = vorrq_u8(match, vceqq_u8(chars, vdupq_n_u8(']')));
+        match = vorrq_u8(match, vceqq_u8(chars, vdupq_n_u8(',')));
+        if (!allSetNeon(vmvnq_u8(match))) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        char c = pStr[i];
+        if ((c == '\\') || (c == '"') || (c == '[') || (c == ']') || (c == ',')) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+// Same as uCxAtUtilFindParamEnd() but for a string with known end
+static char *findParamEnd(char *pStr, const char *pEnd)
+{
+    bool insideString = false;
+    bool insideBracket = false;
+
+    char *pIter = pStr;
+    while (true) {
+        // Skip characters that can't change the state
+        pIter += findParamChar(pIter, (size_t)(pEnd - pIter));
+        if (pIter == pEnd) {
+            break;
+        }
+        if (*pIter == '\\') {
+            if (&pIter[1] == pEnd) {
+                // Escape without any following character
+                return NULL;
+            }
+            pIter += 2;
+            continue;
+        }
+        if (insideString) {
+            if (*pIter == '"') {
+                insideString = false;
+            }
+        } else if (*pIter == '"') {
+            insideString = true;
+        } else if (*pIter == '[') {
+            insideBracket = true;
+        } else if (*pIter == ']') {
+            insideBracket = false;
+        } else if (*pIter == ',' && !insideBracket) {
+            break;
+        }
+        pIter++;
+    }
+
+    if (insideString || insideBracket) {
+        return NULL;
+    }
+
+    return pIter;
+}
+
 static bool binaryToHex(const uint8_t *pData, size_t dataLen, char *pBuf,
                         size_t bufSize, bool reverse)
 {
@@ -84,14 +365,16 @@ static bool binaryToHex(const uint8_t *pData, size_t dataLen, char *pBuf,
     }
     pBuf[2 * dataLen] = 0;
 
-    if (pData != NULL) {
+    if (pData == NULL) {
+        strncpy(pBuf, "(null)", bufSize);
+    } else if (!reverse) {
+        hexEncode(pData, dataLen, pBuf);
+    } else {
         for (i = 0; i < dataLen; i++) {
-            size_t dataIndex = reverse ? dataLen - i - 1 : i;
+            size_t dataIndex = dataLen - i - 1;
             pBuf[i * 2] = nibbleToHex(pData[dataIndex] >> 4);
             pBuf[(i * 2) + 1] = nibbleToHex(pData[dataIndex] & 0x0F);
         }
-    } else {
-        strncpy(pBuf, "(null)", bufSize);
     }
 
     return true;
@@ -121,23 +404,10 @@ int32_t uCxAtUtilHexToByte(const char *pHex, uint8_t *pOutByte)
 
 uint32_t uCxAtUtilHexToBinary(const char *pHexString, uint8_t *pBuf, size_t bufSize)
 {
-    uint32_t i = 0;
-    size_t len;
-    uint32_t toIndex = 0;
-
-    len = strlen(pHexString);
-
-    while ((toIndex < bufSize) && ((i + 1) < len)) {
-        int32_t ret = uCxAtUtilHexToByte(&pHexString[i], &pBuf[toIndex]);
-        if (ret < 0) {
-            // Invalid byte array return converted size
-            return toIndex;
-        }
-        toIndex++;
-        i += 2;
-    }
+    size_t numBytes = U_MIN(strlen(pHexString) / 2, bufSize);
 
-    return toIndex;
+    // Conversion stops at the first invalid character
+    return (uint32_t)hexDecode(pHexString, numBytes, pBuf);
 }
 
 bool uCxAtUtilBinaryToHex(const uint8_t *pData, size_t dataLen, char *pBuf, size_t bufSize)
@@ -152,53 +422,24 @@ bool uCxAtUtilReverseBinaryToHex(const uint8_t *pData, size_t dataLen, char *pBu
 
 char *uCxAtUtilFindParamEnd(char *pStr)
 {
-    bool insideString = false;
-    bool insideBracket = false;
-    bool escape = false;
-
-    char *pIter = pStr;
-    while (*pIter != 0) {
-        if (escape) {
-            escape = false;
-        } else if (*pIter == '\\') {
-            escape = true;
-        } else if (insideString) {
-            if (*pIter == '"') {
-                insideString = false;
-            }
-        } else if (*pIter == '"') {
-            insideString = true;
-        } else if (*pIter == '[') {
-            insideBracket = true;
-        } else if (*pIter == ']') {
-            insideBracket = false;
-        } else if (*pIter == ',' && !insideBracket) {
-            break;
-        }
-        pIter++;
-    }
-
-    if (insideString || escape || insideBracket) {
-        return NULL;
-    }
-
-    return pIter;
+    return findParamEnd(pStr, pStr + strlen(pStr));
 }
 
 int32_t uCxAtUtilParseParamsVaList(char *pParams, const char *pParamFmt, va_list args)
 {
     const char *pFmtCh = pParamFmt;
     char *pParam = pParams;
+    const char *pParamsEnd = pParams + strlen(pParams);
     bool last = false;
     int32_t ret = 0;
 
     while (*pFmtCh != 0) {
         ret++;
-        char *pParamEnd = uCxAtUtilFindParamEnd(pParam);
+        char *pParamEnd = findParamEnd(pParam, pParamsEnd);
         if (pParamEnd == NULL) {
             return -ret;
         }
-        if (*pParamEnd == 0) {
+        if (pParamEnd == pParamsEnd) {
             last = true;
         } else {
             *pParamEnd = 0;
@@ -222,11 +463,13 @@ int32_t uCxAtUtilParseParamsVaList(char *pParams, const char *pParamFmt, va_list
             case 's': {
                 char **ppStr = va_arg(args, char **);
                 U_CX_AT_PORT_ASSERT(ppStr != U_CX_AT_UTIL_PARAM_LAST);
+                char *pStrEnd = pParamEnd;
                 if (*pParam == '"') {
                     pParam++;
-                    pParamEnd[-1] = 0;
+                    pStrEnd--;
+                    *pStrEnd = 0;
                 }
-                (void)unescapeString(pParam);
+                (void)unescapeString(pParam, (size_t)(pStrEnd - pParam));
                 *ppStr = pParam;
             }
             break;
@@ -234,13 +477,15 @@ int32_t uCxAtUtilParseParamsVaList(char *pParams, const char *pParamFmt, va_list
                 // Binary string (with explicit length)
                 uBinaryString_t *pBinStr = va_arg(args, uBinaryString_t *);
                 U_CX_AT_PORT_ASSERT(pBinStr != U_CX_AT_UTIL_PARAM_LAST);
+                char *pStrEnd = pParamEnd;
                 if (*pParam == '"') {
                     pParam++;
-                    if (pParamEnd > pParam && pParamEnd[-1] == '"') {
-                        pParamEnd[-1] = 0;
+                    if (pStrEnd > pParam && pStrEnd[-1] == '"') {
+                        pStrEnd--;
+                        *pStrEnd = 0;
                     }
                 }
-                size_t len = unescapeString(pParam);
+                size_t len = unescapeString(pParam, (size_t)(pStrEnd - pParam));
                 pBinStr->pData = pParam;
                 pBinStr->length = len;
             }
@@ -281,18 +526,16 @@ int32_t uCxAtUtilParseParamsVaList(char *pParams, const char *pParamFmt, va_list
                 uByteArray_t *pByteArray = va_arg(args, uByteArray_t *);
                 U_CX_AT_PORT_ASSERT(pByteArray != U_CX_AT_UTIL_PARAM_LAST);
                 uint8_t *pBytes;
-                size_t len = strlen(pParam);
+                size_t len = (size_t)(pParamEnd - pParam);
                 if ((len % 2) != 0) {
                     return -ret;
                 }
                 pByteArray->length = len / 2;
                 pBytes = (uint8_t *)pParam;
                 pByteArray->pData = pBytes;
-                for (size_t i = 0; i < pByteArray->length; i++) {
-                    if (uCxAtUtilHexToByte(&pParam[i * 2], pBytes) < 0) {
-                        return -ret;
-                    }
-                    pBytes++;
+                // The hex string is converted in-place
+                if (hexDecode(pParam, pByteArray->length, pBytes) != pByteArray->length) {
+                    return -ret;
                 }
             }
             break;
@@ -385,65 +628,116 @@ static size_t escapeCharacter(char c, char *escapeBuffer)
     return escapedLength;
 }
 
-static size_t unescapeString(char *pStr)
+static size_t unescapeString(char *pStr, size_t length)
 {
     char *pRead = pStr;
     char *pWrite = pStr;
-    char *pStart = pStr;
-
-    while (*pRead != '\0') {
-        if (*pRead == '\\' && pRead[1] != '\0') {
-            pRead++;
-            switch (*pRead) {
-                case 'r':
-                    *pWrite++ = '\r';
-                    break;
-                case 'n':
-                    *pWrite++ = '\n';
-                    break;
-                case 't':
-                    *pWrite++ = '\t';
-                    break;
-                case 'b':
-                    *pWrite++ = '\b';
-                    break;
-                case '"':
-                    *pWrite++ = '"';
-                    break;
-                case '\\':
-                    *pWrite++ = '\\';
-                    break;
-                case '0':
-                    *pWrite++ = '\0';
-                    break;
-                case 'x':
-                    // Hex escape sequence \xNN
-                    if (pRead[1] != '\0' && pRead[2] != '\0') {
-                        int32_t high = hexToNibble(pRead[1]);
-                        int32_t low = hexToNibble(pRead[2]);
-                        if (high >= 0 && low >= 0) {
-                            *pWrite++ = (char)((high << 4) | low);
-                            pRead += 2;
-                        } else {
-                            *pWrite++ = *pRead;
-                        }
+    const char *pEnd = pStr + length;
+
+    while (pRead < pEnd) {
+        // Move the characters up to the next escape in one go
+        char *pEscape = memchr(pRead, '\\', (size_t)(pEnd - pRead));
+        size_t runLen = (size_t)(((pEscape != NULL) ? pEscape : pEnd) - pRead);
+        if (pWrite != pRead) {
+            memmove(pWrite, pRead, runLen);
+        }
+        pWrite += runLen;
+        pRead += runLen;
+        if (pRead == pEnd) {
+            break;
+        }
+        if (&pRead[1] == pEnd) {
+            // Backslash at the end is kept as is
+            *pWrite++ = *pRead++;
+            break;
+        }
+        pRead++;
+        switch (*pRead) {
+            case 'r':
+                *pWrite++ = '\r';
+                break;
+            case 'n':
+                *pWrite++ = '\n';
+                break;
+            case 't':
+                *pWrite++ = '\t';
+                break;
+            case 'b':
+                *pWrite++ = '\b';
+                break;
+            case '"':
+                *pWrite++ = '"';
+                break;
+            case '\\':
+                *pWrite++ = '\\';
+                break;
+            case '0':
+                *pWrite++ = '\0';
+                break;
+            case 'x':
+                // Hex escape sequence \xNN
+                if ((pEnd - pRead) > 2) {
+                    int32_t high = hexToNibble(pRead[1]);
+                    int32_t low = hexToNibble(pRead[2]);
+                    if (high >= 0 && low >= 0) {
+                        *pWrite++ = (char)((high << 4) | low);
+                        pRead += 2;
                     } else {
                         *pWrite++ = *pRead;
                     }
-                    break;
-                default:
-                    // Unknown escape, keep the backslash
-                    *pWrite++ = '\\';
+                } else {
                     *pWrite++ = *pRead;
-                    break;
-            }
-            pRead++;
-        } else {
-            *pWrite++ = *pRead++;
+                }
+                break;
+            default:
+                // Unknown escape, keep the backslash
+                *pWrite++ = '\\';
+                *pWrite++ = *pRead;
+                break;
         }
+        pRead++;
     }
     *pWrite = '\0';
-    return (size_t)(pWrite - pStart);
+    return (size_t)(pWrite - pStr);
+}
+
+size_t uCxAtUtilFindEscapeChar(const char *pStr, size_t length)
+{
+    size_t i = 0;
+
+#if defined(U_UTIL_USE_SSE2)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= length; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        __m128i chars = _mm_loadu_si128((const __m128i *)&pStr[i]);
+        // Signed compare so that bytes >= 0x80 are not printable
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(0x1F)),
+                                          _mm_cmplt_epi8(chars, _mm_set1_epi8(0x7F)));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')),
+                                       _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')));
+        if (_mm_movemask_epi8(_mm_andnot_si128(special, printable)) != 0xFFFF) {
+            break;
+        }
+    }
+#elif defined(U_UTIL_USE_NEON)
+    for (; (i + U_UTIL_SIMD_BLOCK_SIZE) <= length; i += U_UTIL_SIMD_BLOCK_SIZE) {
+        uint8x16_t chars = vld1q_u8((const uint8_t *)&pStr[i]);
+        uint8x16_t printable = vandq_u8(vcgeq_u8(chars, vdupq_n_u8(0x20)),
+                                        vcleq_u8(chars, vdupq_n_u8(0x7E)));
+        uint8x16_t special = vorrq_u8(vceqq_u8(chars, vdupq_n_u8('"')),
+                                      vceqq_u8(chars, vdupq_n_u8('\\')));
+        if (!allSetNeon(vbicq_u8(printable, special))) {
+            break;
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        char c = pStr[i];
+        if ((gUCxAtByteClass[(uint8_t)c] != U_CX_AT_BYTE_PRINT) || (c == '"') || (c == '\\')) {
+            break;
+        }
+    }
+
+    return i;
 }
 
 size_t uCxAtUtilWriteEscString(const char *pStr, size_t length, char *pOutBuf, size_t outBufSize)
@@ -455,18 +749,30 @@ size_t uCxAtUtilWriteEscString(const char *pStr, size_t length, char *pOutBuf, s
     char *pWrite = pOutBuf;
     char *pEnd = pOutBuf + outBufSize;
     char escapedChar[4];
+    size_t i = 0;
 
     // Opening quote
     *pWrite++ = '"';
 
-    for (size_t i = 0; i < length; i++) {
-        size_t escapedLen = escapeCharacter(pStr[i], escapedChar);
-        if (pWrite + escapedLen + 1 >= pEnd) {
-            // Not enough space for escaped char and closing quote
+    while (i < length) {
+        // Copy characters not needing escape in one go
+        size_t runLen = uCxAtUtilFindEscapeChar(&pStr[i], length - i);
+        if (pWrite + runLen + 1 >= pEnd) {
+            // Not enough space for the characters and closing quote
             return 0;
         }
-        for (size_t j = 0; j < escapedLen; j++) {
-            *pWrite++ = escapedChar[j];
+        memcpy(pWrite, &pStr[i], runLen);
+        pWrite += runLen;
+        i += runLen;
+        if (i < length) {
+            size_t escapedLen = escapeCharacter(pStr[i], escapedChar);
+            if (pWrite + escapedLen + 1 >= pEnd) {
+                // Not enough space for escaped char and closing quote
+                return 0;
+            }
+            memcpy(pWrite, escapedChar, escapedLen);
+            pWrite += escapedLen;
+            i++;
         }
     }
 
@@ -475,3 +781,94 @@ size_t uCxAtUtilWriteEscString(const char *pStr, size_t length, char *pOutBuf, s
 
     return (size_t)(pWrite - pOutBuf);
 }
+
+size_t uCxAtUtilWriteEscStringStream(const char *pStr, size_t length,
+                                     char *pScratch, size_t scratchSize,
+                                     uCxAtUtilWriteFunc_t writeFunc, void *pArg)
+{
+    size_t totLen = 0;
+    size_t scratchLen = 0;
+    size_t i = 0;
+
+    U_CX_AT_PORT_ASSERT(scratchSize >= U_CX_AT_UTIL_ESC_SCRATCH_MIN_SIZE);
+
+    // Opening quote
+    pScratch[scratchLen++] = '"';
+
+    while (i < length) {
+        size_t runLen = uCxAtUtilFindEscapeChar(&pStr[i], length - i);
+        if (scratchLen + runLen > scratchSize) {
+            writeFunc(pArg, pScratch, scratchLen);
+            totLen += scratchLen;
+            scratchLen = 0;
+        }
+        if (runLen >= scratchSize) {
+            // Long run of characters not needing escape - write it directly
+            writeFunc(pArg, &pStr[i], runLen);
+            totLen += runLen;
+        } else {
+            memcpy(&pScratch[scratchLen], &pStr[i], runLen);
+            scratchLen += runLen;
+        }
+        i += runLen;
+        if (i < length) {
+            if (scratchLen + 4 > scratchSize) {
+                writeFunc(pArg, pScratch, scratchLen);
+                totLen += scratchLen;
+                scratchLen = 0;
+            }
+            scratchLen += escapeCharacter(pStr[i], &pScratch[scratchLen]);
+            i++;
+        }
+    }
+
+    // Closing quote
+    if (scratchLen == scratchSize) {
+        writeFunc(pArg, pScratch, scratchLen);
+        totLen += scratchLen;
+        scratchLen = 0;
+    }
+    pScratch[scratchLen++] = '"';
+    writeFunc(pArg, pScratch, scratchLen);
+    totLen += scratchLen;
+
+    return totLen;
+}
+
+uCxAtLineType_t uCxAtUtilClassifyLine(const char *pLine, size_t lineLength,
+                                      const char *pExpectedRsp, size_t expectedRspLen)
+{
+    if (lineLength == 0) {
+        return U_CX_AT_LINE_EMPTY;
+    }
+
+    if ((pExpectedRsp != NULL) && (expectedRspLen > 0) && (lineLength >= expectedRspLen) &&
+        (memcmp(pLine, pExpectedRsp, expectedRspLen) == 0)) {
+        return U_CX_AT_LINE_EXPECTED_RSP;
+    }
+
+    switch (pLine[0]) {
+        case '+':
+        case '*':
+            return U_CX_AT_LINE_URC;
+        case 'O':
+            if ((lineLength == 2) && (pLine[1] == 'K')) {
+                return U_CX_AT_LINE_OK;
+            }
+            break;
+        case 'E':
+            if ((lineLength >= 5) && (memcmp(pLine, "ERROR", 5) == 0)) {
+                return U_CX_AT_LINE_ERROR;
+            }
+            break;
+        case 'A':
+            if ((lineLength >= 3) && (memcmp(pLine, "AT+", 3) == 0)) {
+                return U_CX_AT_LINE_ECHO;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return U_CX_AT_LINE_OTHER;
+}
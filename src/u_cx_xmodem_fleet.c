@@ -0,0 +1,331 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Parallel XMODEM firmware upgrade of several modules
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "u_cx_xmodem_fleet.h"
+#include "u_cx_log.h"
+#include "u_port.h"
+
+#ifdef U_PORT_POSIX
+# include <pthread.h>
+# if U_CX_XMODEM_FILE_SUPPORT
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+# endif
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define U_CX_XMODEM_FLEET_DEFAULT_ATTEMPTS  3
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+#ifdef U_PORT_POSIX
+/**
+ * State shared by all workers of a fleet upgrade
+ */
+typedef struct {
+    const uCxXmodemFleetConfig_t *pConfig;
+    const uint8_t *pData;
+    size_t dataLen;
+    const uint16_t *pBlockCrcs;     /**< CRC of each block or NULL */
+    uCxXmodemFleetPort_t *pPorts;
+    size_t numPorts;
+    size_t nextPort;                /**< Next port to hand out to a worker */
+    pthread_mutex_t mutex;          /**< Protects nextPort, pPorts and the progress callback */
+} uFleetContext_t;
+
+/**
+ * XMODEM session of one port
+ */
+typedef struct {
+    uFleetContext_t *pCtx;
+    size_t portIndex;
+} uFleetSession_t;
+#endif
+
+/* ----------------------------------------------------------------
+ * STATIC PROTOTYPES
+ * -------------------------------------------------------------- */
+
+#ifdef U_PORT_POSIX
+static void fleetReport(uFleetContext_t *pCtx, size_t portIndex);
+static void fleetSetState(uFleetContext_t *pCtx, size_t portIndex, uCxXmodemFleetState_t state);
+static void fleetProgressCallback(size_t totalBytes, size_t bytesTransferred, void *pUserData);
+static void fleetUpgradePort(uFleetContext_t *pCtx, size_t portIndex);
+static void *fleetWorker(void *pArg);
+#endif
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+#ifdef U_PORT_POSIX
+// Must be called with the mutex locked
+static void fleetReport(uFleetContext_t *pCtx, size_t portIndex)
+{
+    if (pCtx->pConfig->progressCallback != NULL) {
+        pCtx->pConfig->progressCallback(portIndex, pCtx->pPorts, pCtx->pConfig->pUserData);
+    }
+}
+
+static void fleetSetState(uFleetContext_t *pCtx, size_t portIndex, uCxXmodemFleetState_t state)
+{
+    pthread_mutex_lock(&pCtx->mutex);
+    pCtx->pPorts[portIndex].state = state;
+    fleetReport(pCtx, portIndex);
+    pthread_mutex_unlock(&pCtx->mutex);
+}
+
+static void fleetProgressCallback(size_t totalBytes, size_t bytesTransferred, void *pUserData)
+{
+    uFleetSession_t *pSession = (uFleetSession_t *)pUserData;
+    uFleetContext_t *pCtx = pSession->pCtx;
+
+    (void)totalBytes;
+    pthread_mutex_lock(&pCtx->mutex);
+    pCtx->pPorts[pSession->portIndex].bytesTransferred = bytesTransferred;
+    fleetReport(pCtx, pSession->portIndex);
+    pthread_mutex_unlock(&pCtx->mutex);
+}
+
+static void fleetUpgradePort(uFleetContext_t *pCtx, size_t portIndex)
+{
+    const uCxXmodemFleetConfig_t *pConfig = pCtx->pConfig;
+    uCxXmodemFleetPort_t *pPort = &pCtx->pPorts[portIndex];
+    uFleetSession_t session = { pCtx, portIndex };
+    int32_t maxAttempts = (pConfig->maxAttempts > 0) ? pConfig->maxAttempts : 1;
+    int32_t result = -1;
+
+    for (int32_t attempt = 1; (attempt <= maxAttempts) && (result != 0); attempt++) {
+        int32_t startTime = U_CX_PORT_GET_TIME_MS();
+
+        pthread_mutex_lock(&pCtx->mutex);
+        pPort->attempts = attempt;
+        pPort->bytesTransferred = 0;
+        pthread_mutex_unlock(&pCtx->mutex);
+
+        result = 0;
+        if (pConfig->prepareCallback != NULL) {
+            fleetSetState(pCtx, portIndex, U_CX_XMODEM_FLEET_STATE_PREPARING);
+            result = pConfig->prepareCallback(portIndex, pPort->pUartDevName, attempt,
+                                              pConfig->pUserData);
+        }
+
+        if (result == 0) {
+            uCxXmodemConfig_t xmodemConfig;
+            uCxXmodemInit(pPort->pUartDevName, &xmodemConfig);
+            xmodemConfig.use1K = pConfig->use1K;
+            xmodemConfig.timeoutMs = pConfig->timeoutMs;
+            xmodemConfig.blockDelayMs = pConfig->blockDelayMs;
+            xmodemConfig.allowStreaming = pConfig->allowStreaming;
+            xmodemConfig.instance = (int32_t)portIndex;
+
+            fleetSetState(pCtx, portIndex, U_CX_XMODEM_FLEET_STATE_SENDING);
+            result = uCxXmodemOpen(&xmodemConfig, pConfig->baudRate, pConfig->flowControl);
+            if (result == 0) {
+                result = uCxXmodemSendBuffer(&xmodemConfig, pCtx->pData, pCtx->dataLen,
+                                             pCtx->pBlockCrcs, fleetProgressCallback, &session);
+                uCxXmodemClose(&xmodemConfig);
+            }
+        }
+
+        pthread_mutex_lock(&pCtx->mutex);
+        pPort->result = result;
+        pPort->elapsedMs = U_CX_PORT_GET_TIME_MS() - startTime;
+        pthread_mutex_unlock(&pCtx->mutex);
+
+        if (result != 0) {
+            U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, (int32_t)portIndex,
+                            "XMODEM fleet: %s attempt %d failed: %d",
+                            pPort->pUartDevName, attempt, result);
+        }
+    }
+
+    fleetSetState(pCtx, portIndex,
+                  (result == 0) ? U_CX_XMODEM_FLEET_STATE_DONE : U_CX_XMODEM_FLEET_STATE_FAILED);
+}
+
+static void *fleetWorker(void *pArg)
+{
+    uFleetContext_t *pCtx = (uFleetContext_t *)pArg;
+
+    while (true) {
+        pthread_mutex_lock(&pCtx->mutex);
+        size_t portIndex = pCtx->nextPort++;
+        pthread_mutex_unlock(&pCtx->mutex);
+        if (portIndex >= pCtx->numPorts) {
+            break;
+        }
+        fleetUpgradePort(pCtx, portIndex);
+    }
+
+    return NULL;
+}
+#endif // U_PORT_POSIX
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+void uCxXmodemFleetInit(uCxXmodemFleetConfig_t *pConfig, int32_t baudRate)
+{
+    if (pConfig != NULL) {
+        uCxXmodemConfig_t xmodemConfig;
+        uCxXmodemInit(NULL, &xmodemConfig);
+
+        memset(pConfig, 0, sizeof(uCxXmodemFleetConfig_t));
+        pConfig->baudRate = baudRate;
+        pConfig->flowControl = true;
+        pConfig->use1K = xmodemConfig.use1K;
+        pConfig->timeoutMs = xmodemConfig.timeoutMs;
+        pConfig->blockDelayMs = xmodemConfig.blockDelayMs;
+        pConfig->allowStreaming = xmodemConfig.allowStreaming;
+        pConfig->maxAttempts = U_CX_XMODEM_FLEET_DEFAULT_ATTEMPTS;
+        pConfig->numWorkers = 0;
+    }
+}
+
+#ifdef U_PORT_POSIX
+
+int32_t uCxXmodemFleetSendBuffer(const uCxXmodemFleetConfig_t *pConfig,
+                                 const uint8_t *pData,
+                                 size_t dataLen,
+                                 uCxXmodemFleetPort_t *pPorts,
+                                 size_t numPorts)
+{
+    if ((pConfig == NULL) || (pData == NULL) || (dataLen == 0) ||
+        (pPorts == NULL) || (numPorts == 0)) {
+        return U_CX_ERROR_INVALID_PARAMETER;
+    }
+
+    uFleetContext_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pConfig = pConfig;
+    ctx.pData = pData;
+    ctx.dataLen = dataLen;
+    ctx.pPorts = pPorts;
+    ctx.numPorts = numPorts;
+    for (size_t i = 0; i < numPorts; i++) {
+        pPorts[i].state = U_CX_XMODEM_FLEET_STATE_PENDING;
+        pPorts[i].attempts = 0;
+        pPorts[i].result = 0;
+        pPorts[i].bytesTransferred = 0;
+        pPorts[i].elapsedMs = 0;
+    }
+
+    // The CRC of the blocks is the same for all ports so it is only calculated once.
+    // If there is no memory for it each session calculates the CRC itself instead.
+    uCxXmodemConfig_t blockConfig;
+    uCxXmodemInit(NULL, &blockConfig);
+    blockConfig.use1K = pConfig->use1K;
+    size_t blockSize = pConfig->use1K ? 1024 : 128;
+    uint16_t *pBlockCrcs = malloc(((dataLen + blockSize - 1) / blockSize) * sizeof(uint16_t));
+    if (pBlockCrcs != NULL) {
+        uCxXmodemCalcBlockCrcs(&blockConfig, pData, dataLen, pBlockCrcs);
+    }
+    ctx.pBlockCrcs = pBlockCrcs;
+
+    size_t numWorkers = pConfig->numWorkers;
+    if ((numWorkers == 0) || (numWorkers > numPorts)) {
+        numWorkers = numPorts;
+    }
+    pthread_t *pThreads = malloc(numWorkers * sizeof(pthread_t));
+    if (pThreads == NULL) {
+        numWorkers = 0;
+    }
+
+    pthread_mutex_init(&ctx.mutex, NULL);
+    size_t numStarted = 0;
+    while ((numStarted < numWorkers) &&
+           (pthread_create(&pThreads[numStarted], NULL, fleetWorker, &ctx) == 0)) {
+        numStarted++;
+    }
+    if (numStarted == 0) {
+        // Run all sessions in the calling thread if no worker could be started
+        fleetWorker(&ctx);
+    }
+    for (size_t i = 0; i < numStarted; i++) {
+        pthread_join(pThreads[i], NULL);
+    }
+    pthread_mutex_destroy(&ctx.mutex);
+
+    free(pThreads);
+    free(pBlockCrcs);
+
+    int32_t numFailed = 0;
+    for (size_t i = 0; i < numPorts; i++) {
+        if (pPorts[i].state != U_CX_XMODEM_FLEET_STATE_DONE) {
+            numFailed++;
+        }
+    }
+    return numFailed;
+}
+
+#if U_CX_XMODEM_FILE_SUPPORT
+int32_t uCxXmodemFleetSendFile(const uCxXmodemFleetConfig_t *pConfig,
+                               const char *pFilePath,
+                               uCxXmodemFleetPort_t *pPorts,
+                               size_t numPorts)
+{
+    if (pFilePath == NULL) {
+        return U_CX_ERROR_INVALID_PARAMETER;
+    }
+
+    int fd = open(pFilePath, O_RDONLY);
+    if (fd < 0) {
+        U_CX_LOG_LINE(U_CX_LOG_CH_ERROR, "XMODEM fleet: Failed to open file: %s", pFilePath);
+        return U_CX_ERROR_IO;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        U_CX_LOG_LINE(U_CX_LOG_CH_ERROR, "XMODEM fleet: Invalid file: %s", pFilePath);
+        close(fd);
+        return U_CX_ERROR_IO;
+    }
+    size_t fileSize = (size_t)st.st_size;
+
+    // One mapping shared by all sessions
+    const uint8_t *pData = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pData == MAP_FAILED) {
+        U_CX_LOG_LINE(U_CX_LOG_CH_ERROR, "XMODEM fleet: Failed to map file: %s", pFilePath);
+        close(fd);
+        return U_CX_ERROR_IO;
+    }
+
+    int32_t result = uCxXmodemFleetSendBuffer(pConfig, pData, fileSize, pPorts, numPorts);
+
+    munmap((void *)pData, fileSize);
+    close(fd);
+
+    return result;
+}
+#endif // U_CX_XMODEM_FILE_SUPPORT
+
+#endif // U_PORT_POSIX
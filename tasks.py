@@ -23,6 +23,24 @@ def examples(c, clean=False):
         c.run(f"invoke all {clean_flag}")
 
 
+@task
+def benchmarks(c, run=False):
+    """Build (and optionally run) the benchmarks."""
+    print("Building benchmarks...")
+    c.run("cmake -S benchmarks -B benchmarks/build")
+    c.run("cmake --build benchmarks/build")
+    if run:
+        c.run(os.path.join("benchmarks", "bin", "parser_benchmark"))
+
+
+@task
+def tools(c):
+    """Build the host tools."""
+    print("Building tools...")
+    c.run("cmake -S tools -B tools/build")
+    c.run("cmake --build tools/build")
+
+
 @task
 def clean_ceedling(c):
     """Clean Ceedling build artifacts."""
@@ -50,6 +68,8 @@ test_ns.add_task(ceedling, 'ceedling')
 
 build_ns = Collection('build')
 build_ns.add_task(examples, 'examples')
+build_ns.add_task(benchmarks, 'benchmarks')
+build_ns.add_task(tools, 'tools')
 
 clean_ns = Collection('clean')
 clean_ns.add_task(clean_ceedling, 'ceedling')
@@ -52,10 +52,16 @@ static uint8_t gUrcBuffer[1024];
 
 static uint8_t gTxBuffer[1024];
 static size_t gTxBufferPos;
+static size_t gTxLimit;
+static int32_t gTxIoErrorCode;
 
 static uint8_t *gPRxDataPtr;
 static int32_t gRxDataLen;
 static int32_t gRxIoErrorCode;
+static uint32_t gUartOpenFlags;
+static int32_t gReadTimeouts[4];
+static size_t gReadCount;
+static size_t gWritevCount;
 
 static uCxAtClientConfig_t gClientConfig = {
     .pContext = CONTEXT_VALUE,
@@ -90,11 +96,13 @@ int32_t uPortGetTickTimeMs_CALLBACK(int cmock_num_calls)
 }
 
 /* Mock UART open function */
-uPortUartHandle_t uPortUartOpen(const char *pDeviceName, int32_t baudRate, bool flowControl)
+uPortUartHandle_t uPortUartOpenEx(const char *pDeviceName, int32_t baudRate, bool flowControl,
+                                  uint32_t flags)
 {
     (void)pDeviceName;
     (void)baudRate;
     (void)flowControl;
+    gUartOpenFlags = flags;
     return UART_HANDLE;
 }
 
@@ -120,6 +128,11 @@ int32_t uPortUartWrite(uPortUartHandle_t handle, const void *pData, size_t lengt
 {
     TEST_ASSERT_EQUAL(UART_HANDLE, handle);
     assert(length < sizeof(gTxBuffer) - gTxBufferPos);
+    if (gTxIoErrorCode != 0) {
+        return gTxIoErrorCode;
+    }
+    // Simulate a backend that only takes part of the data, e.g. a full TX queue
+    length = U_MIN(length, gTxLimit - gTxBufferPos);
     memcpy(&gTxBuffer[gTxBufferPos], pData, length);
     gTxBufferPos += length;
     return (int32_t)length;
@@ -129,8 +142,11 @@ int32_t uPortUartWrite(uPortUartHandle_t handle, const void *pData, size_t lengt
 int32_t uPortUartRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
 {
     static int zeroCounter = 0;
-    (void)timeoutMs;
     TEST_ASSERT_EQUAL(UART_HANDLE, handle);
+    if (gReadCount < sizeof(gReadTimeouts) / sizeof(gReadTimeouts[0])) {
+        gReadTimeouts[gReadCount] = timeoutMs;
+    }
+    gReadCount++;
 
     if (gRxIoErrorCode != 0) {
         if (++zeroCounter > 10) {
@@ -153,6 +169,33 @@ int32_t uPortUartRead(uPortUartHandle_t handle, void *pData, size_t length, int3
     return cpyLen;
 }
 
+/* UART backend with writev, uses the mocks above for everything else */
+static int32_t mockWritev(uPortUartHandle_t handle, const uPortUartIoVec_t *pIov, size_t iovCount)
+{
+    int32_t total = 0;
+    gWritevCount++;
+    for (size_t i = 0; i < iovCount; i++) {
+        total += uPortUartWrite(handle, pIov[i].pData, pIov[i].length);
+    }
+    return total;
+}
+
+static int32_t mockGetFd(uPortUartHandle_t handle)
+{
+    TEST_ASSERT_EQUAL(UART_HANDLE, handle);
+    return 42;
+}
+
+static const uPortUartOps_t gMockUartOps = {
+    .openFn = uPortUartOpenEx,
+    .closeFn = uPortUartClose,
+    .writeFn = uPortUartWrite,
+    .readFn = uPortUartRead,
+    .writevFn = mockWritev,
+    .getFdFn = mockGetFd,
+    .caps = U_PORT_UART_CAP_POLL_FD | U_PORT_UART_CAP_WRITEV
+};
+
 static void uAtClientSendCmdVaList_wrapper(uCxAtClient_t *pClient, const char *pCmd,
                                            const char *pParamFmt, ...)
 {
@@ -176,10 +219,14 @@ void setUp(void)
     uCxAtClientOpen(&gClient, 115200, true);
     memset(&gTxBuffer[0], 0xc0, sizeof(gTxBuffer));
     gTxBufferPos = 0;
+    gTxLimit = sizeof(gTxBuffer);
+    gTxIoErrorCode = 0;
     gPRxDataPtr = NULL;
     gRxDataLen = -1;
     gRxIoErrorCode = 0;
     gPTickSequence = NULL;
+    gReadCount = 0;
+    gWritevCount = 0;
 
     uPortGetTickTimeMs_IgnoreAndReturn(0);
 }
@@ -385,6 +432,16 @@ void test_uCxAtClientSendCmdVaList_withStringEscapeNonPrintable(void)
     TEST_ASSERT_EQUAL_STRING(expected, &gTxBuffer[0]);
 }
 
+void test_uCxAtClientSendCmdVaList_withLongStringWithEscapes_expectAllEscaped(void)
+{
+    // Longer than the internal scratch buffer so that the escaped string is streamed
+    char str[] = "0123456789\"0123456789012345678901234567890123456789012345678901234567890123456789\"";
+    uAtClientSendCmdVaList_wrapper(&gClient, "AT+FOO=", "s",
+                                   str, U_CX_AT_UTIL_PARAM_LAST);
+    TEST_ASSERT_EQUAL_STRING("AT+FOO=\"0123456789\\\"0123456789012345678901234567890123456789012345678901234567890123456789\\\"\"\r",
+                             &gTxBuffer[0]);
+}
+
 void test_uCxAtClientExecSimpleCmdF_withStatusOk_expectSuccess(void)
 {
     char rxData[] = { "\r\nOK\r\n" };
@@ -421,6 +478,75 @@ void test_uCxAtClientExecSimpleCmdF_withInvalidStatusExtendedError_expectTimeout
     TEST_ASSERT_EQUAL_MESSAGE(0, gRxDataLen, "Test didn't read all data");
 }
 
+void test_uCxAtClientExecSimpleCmdF_withNoData_expectReadWaitsForRemainingCmdTime(void)
+{
+    gRxDataLen = 0;
+    uPortGetTickTimeMs_StopIgnore();
+    uPortGetTickTimeMs_ExpectAndReturn(0);
+    uPortGetTickTimeMs_ExpectAndReturn(1000);
+    uPortGetTickTimeMs_ExpectAndReturn(U_CX_DEFAULT_CMD_TIMEOUT_MS + 1);
+    TEST_ASSERT_EQUAL(U_CX_ERROR_CMD_TIMEOUT, uCxAtClientExecSimpleCmdF(&gClient, "DUMMY", ""));
+    TEST_ASSERT_EQUAL(2, gReadCount);
+    TEST_ASSERT_EQUAL(U_CX_DEFAULT_CMD_TIMEOUT_MS, gReadTimeouts[0]);
+    TEST_ASSERT_EQUAL(U_CX_DEFAULT_CMD_TIMEOUT_MS - 1000, gReadTimeouts[1]);
+}
+
+void test_uCxAtClientHandleRx_withNoData_expectConfiguredReadTimeout(void)
+{
+    gRxDataLen = 0;
+    uCxAtClientHandleRx(&gClient);
+    TEST_ASSERT_EQUAL(1, gReadCount);
+    TEST_ASSERT_EQUAL(gClientConfig.timeoutMs, gReadTimeouts[0]);
+}
+
+void test_uCxAtClientHandleRx_withCompleteLine_expectNoWaitForMoreData(void)
+{
+    char rxData[] = { "+A\r\n" };
+    gPRxDataPtr = (uint8_t *)&rxData[0];
+    gRxDataLen = strlen(rxData);
+    uCxAtClientHandleRx(&gClient);
+    TEST_ASSERT_EQUAL(5, gReadCount);
+    TEST_ASSERT_EQUAL(gClientConfig.timeoutMs, gReadTimeouts[2]);
+    TEST_ASSERT_EQUAL(0, gReadTimeouts[3]);
+}
+
+void test_uCxAtClientOpen_withUartFlags_expectFlagsPassedToPort(void)
+{
+    uCxAtClientClose(&gClient);
+    gClientConfig.uartFlags = U_PORT_UART_FLAG_LOW_LATENCY | U_PORT_UART_FLAG_FLUSH_INPUT;
+    int32_t ret = uCxAtClientOpen(&gClient, 115200, true);
+    gClientConfig.uartFlags = 0;
+    TEST_ASSERT_EQUAL(0, ret);
+    TEST_ASSERT_EQUAL(U_PORT_UART_FLAG_LOW_LATENCY | U_PORT_UART_FLAG_FLUSH_INPUT, gUartOpenFlags);
+}
+
+void test_uCxAtClientSendCmdVaList_withWritevBackend_expectBinaryInOneWritev(void)
+{
+    uint8_t data[] = {0x00,0x11,0x22,0x33,0x44,0x55};
+    uint8_t expected[] = { 'A','T','+','F','O','O','=',BIN_HDR(6),0x00,0x11,0x22,0x33,0x44,0x55};
+    uCxAtClientClose(&gClient);
+    gClientConfig.pUartOps = &gMockUartOps;
+    TEST_ASSERT_EQUAL(0, uCxAtClientOpen(&gClient, 115200, true));
+    gClientConfig.pUartOps = NULL;
+    uAtClientSendCmdVaList_wrapper(&gClient, "AT+FOO=", "B",
+                                   &data[0], sizeof(data), U_CX_AT_UTIL_PARAM_LAST);
+    TEST_ASSERT_EQUAL(1, gWritevCount);
+    TEST_ASSERT_EQUAL_MEMORY(expected, &gTxBuffer[0], sizeof(expected));
+    TEST_ASSERT_EQUAL(sizeof(expected), gTxBufferPos);
+}
+
+void test_uCxAtClientGetPollFd_withBackendCaps_expectFdOnlyWhenSupported(void)
+{
+    TEST_ASSERT_EQUAL(-1, uCxAtClientGetPollFd(&gClient));
+    uCxAtClientClose(&gClient);
+    gClientConfig.pUartOps = &gMockUartOps;
+    TEST_ASSERT_EQUAL(0, uCxAtClientOpen(&gClient, 115200, true));
+    gClientConfig.pUartOps = NULL;
+    TEST_ASSERT_EQUAL(42, uCxAtClientGetPollFd(&gClient));
+    uCxAtClientClose(&gClient);
+    TEST_ASSERT_EQUAL(-1, uCxAtClientGetPollFd(&gClient));
+}
+
 void test_uCxAtClientExecSimpleCmdF_withReadError_expectIoError(void)
 {
     gRxIoErrorCode = -1234;
@@ -428,6 +554,37 @@ void test_uCxAtClientExecSimpleCmdF_withReadError_expectIoError(void)
     TEST_ASSERT_EQUAL(-1234, uCxAtClientGetLastIoError(&gClient));
 }
 
+void test_uCxAtClientExecSimpleCmdF_withShortBinaryWrite_expectIoErrorWithoutRead(void)
+{
+    uint8_t data[] = {0x00,0x11,0x22,0x33,0x44,0x55};
+    gTxLimit = 12;
+    TEST_ASSERT_EQUAL(U_CX_ERROR_IO, uCxAtClientExecSimpleCmdF(&gClient, "AT+FOO=", "dB", 1,
+                                                               &data[0], sizeof(data),
+                                                               U_CX_AT_UTIL_PARAM_LAST));
+    TEST_ASSERT_EQUAL(U_CX_ERROR_IO, uCxAtClientGetLastIoError(&gClient));
+    TEST_ASSERT_EQUAL(12, gTxBufferPos);
+    TEST_ASSERT_EQUAL(0, gReadCount);
+}
+
+void test_uCxAtClientExecSimpleCmdF_withWriteError_expectRestOfCmdNotSent(void)
+{
+    gTxIoErrorCode = -1234;
+    TEST_ASSERT_EQUAL(U_CX_ERROR_IO, uCxAtClientExecSimpleCmdF(&gClient, "AT+FOO=", "ds", 1, "x",
+                                                               U_CX_AT_UTIL_PARAM_LAST));
+    TEST_ASSERT_EQUAL(-1234, uCxAtClientGetLastIoError(&gClient));
+    TEST_ASSERT_EQUAL(0, gTxBufferPos);
+    TEST_ASSERT_EQUAL(0, gReadCount);
+
+    // The next command is sent normally
+    gTxIoErrorCode = 0;
+    char rxData[] = { "\r\nOK\r\n" };
+    gPRxDataPtr = (uint8_t *)&rxData[0];
+    gRxDataLen = strlen(rxData);
+    TEST_ASSERT_EQUAL(0, uCxAtClientExecSimpleCmdF(&gClient, "AT", "", U_CX_AT_UTIL_PARAM_LAST));
+    gTxBuffer[gTxBufferPos] = 0;
+    TEST_ASSERT_EQUAL_STRING("AT\r", &gTxBuffer[0]);
+}
+
 void test_uCxAtClientCmdGetRspParamLine_withTimeout_expectNull(void)
 {
     // Start by putting the client in command state
@@ -543,6 +700,178 @@ void test_uCxAtClientHandleRx_withBinUrc_expectUrcCallback(void)
     uCxAtClientHandleRx(&gClient);
 }
 
+void test_uCxAtClientHandleRx_withBinUrcAndStringUrcInOneRead_expectBothUrcCallbacks(void)
+{
+    static int callbackCalls;
+    // A port with read-ahead may already hold the next URC when the binary
+    // URC is done, so it must be handled without waiting for more data
+    char strData[] = { "\r\n" TEST_URC };
+    char nextUrc[] = { "\r\n+NEXT:1\r\n" };
+    uint8_t binData[] = {BIN_HDR(2),0x00,0x11};
+    uint8_t rxData[strlen(strData) + sizeof(binData) + strlen(nextUrc)];
+    memcpy(&rxData[0], &strData[0], strlen(strData));
+    memcpy(&rxData[strlen(strData)], &binData[0], sizeof(binData));
+    memcpy(&rxData[strlen(strData) + sizeof(binData)], &nextUrc[0], strlen(nextUrc));
+    gPRxDataPtr = &rxData[0];
+    gRxDataLen = sizeof(rxData);
+    callbackCalls = 0;
+
+    void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine,
+                     size_t lineLength, uint8_t *pBinaryData, size_t binaryDataLen)
+    {
+        (void)pClient;
+        (void)pTag;
+        (void)lineLength;
+        if (callbackCalls == 0) {
+            TEST_ASSERT_EQUAL_STRING(TEST_URC, pLine);
+            TEST_ASSERT_NOT_NULL(pBinaryData);
+            TEST_ASSERT_EQUAL(2, binaryDataLen);
+        } else {
+            TEST_ASSERT_EQUAL_STRING("+NEXT:1", pLine);
+            TEST_ASSERT_EQUAL(0, binaryDataLen);
+        }
+        callbackCalls++;
+    }
+
+    uCxAtClientSetUrcCallback(&gClient, urcCallback, NULL);
+    uCxAtClientHandleRx(&gClient);
+    TEST_ASSERT_EQUAL(2, callbackCalls);
+    TEST_ASSERT_EQUAL(0, gRxDataLen);
+}
+
+void test_uCxAtClientHandleRx_withUrcLongerThanRxBuffer_expectNextUrcCallback(void)
+{
+    static int callbackCalls;
+    // The URC queue slot has room for the line, but the RX buffer hasn't
+    char rxData[] = { "\r\n+LONGURC:0123456789012345678901234567890123456789:0\r\n"
+                      TEST_URC "\r\n" };
+    gPRxDataPtr = (uint8_t *)&rxData[0];
+    gRxDataLen = strlen(rxData);
+    gClientConfig.rxBufferLen = 32;
+    callbackCalls = 0;
+
+    void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine,
+                     size_t lineLength, uint8_t *pBinaryData, size_t binaryDataLen)
+    {
+        (void)pClient;
+        (void)pTag;
+        (void)pBinaryData;
+        (void)binaryDataLen;
+        TEST_ASSERT_EQUAL_STRING(TEST_URC, pLine);
+        TEST_ASSERT_EQUAL(strlen(pLine), lineLength);
+        callbackCalls++;
+    }
+
+    uCxAtClientSetUrcCallback(&gClient, urcCallback, NULL);
+    while (gRxDataLen > 0) {
+        uCxAtClientHandleRx(&gClient);
+    }
+    gClientConfig.rxBufferLen = sizeof(gRxBuffer);
+    TEST_ASSERT_EQUAL(1, callbackCalls);
+}
+
+void test_uCxAtClientHandleRx_withUrcExecutor_expectDeferredUrcCallback(void)
+{
+    static int executorCalls;
+    static int callbackCalls;
+    uCxAtUrcStats_t stats;
+    char rxData[] = { "\r\n" TEST_URC "\r\n" };
+    gPRxDataPtr = (uint8_t *)&rxData[0];
+    gRxDataLen = strlen(rxData);
+    executorCalls = 0;
+    callbackCalls = 0;
+
+    void urcExecutor(struct uCxAtClient *pClient, void *pArg)
+    {
+        TEST_ASSERT_EQUAL(&gClient, pClient);
+        TEST_ASSERT_EQUAL_PTR(&executorCalls, pArg);
+        executorCalls++;
+    }
+
+    void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine,
+                     size_t lineLength, uint8_t *pBinaryData, size_t binaryDataLen)
+    {
+        TEST_ASSERT_EQUAL(&gClient, pClient);
+        TEST_ASSERT_NULL(pTag);
+        TEST_ASSERT_EQUAL_STRING(TEST_URC, pLine);
+        TEST_ASSERT_EQUAL(strlen(pLine), lineLength);
+        TEST_ASSERT_NULL(pBinaryData);
+        TEST_ASSERT_EQUAL(0, binaryDataLen);
+        callbackCalls++;
+    }
+
+    uPortGetTickTimeMs_StopIgnore();
+    uPortGetTickTimeMs_StubWithCallback(uPortGetTickTimeMs_CALLBACK);
+    gPTickSequence = (int32_t []) {
+        100, 150, -1
+    };
+
+    uCxAtClientSetUrcCallback(&gClient, urcCallback, NULL);
+    uCxAtClientSetUrcExecutor(&gClient, urcExecutor, &executorCalls);
+    uCxAtClientHandleRx(&gClient);
+    TEST_ASSERT_EQUAL(1, executorCalls);
+    TEST_ASSERT_EQUAL(0, callbackCalls);
+    uCxAtClientGetUrcStats(&gClient, &stats);
+    TEST_ASSERT_EQUAL(1, stats.queueDepth);
+
+    // The executor is responsible for dispatching the URCs
+    uCxAtClientProcessUrcs(&gClient);
+    TEST_ASSERT_EQUAL(1, callbackCalls);
+    uCxAtClientGetUrcStats(&gClient, &stats);
+    TEST_ASSERT_EQUAL(0, stats.queueDepth);
+    TEST_ASSERT_EQUAL(1, stats.peakQueueDepth);
+    TEST_ASSERT_EQUAL(1, stats.dispatchCount);
+    TEST_ASSERT_EQUAL(0, stats.dropCount);
+    TEST_ASSERT_EQUAL(50, stats.maxLatencyMs);
+    TEST_ASSERT_EQUAL(50, stats.avgLatencyMs);
+}
+
+void test_uCxAtClientSetUrcClasses_withClassRules_expectPerClassStats(void)
+{
+    static const uCxAtUrcClassConfig_t configs[U_CX_URC_CLASS_COUNT] = {
+        [U_CX_URC_CLASS_CRITICAL] = { 25, U_CX_URC_DROP_NEWEST },
+        [U_CX_URC_CLASS_DATA] = { 75, U_CX_URC_DROP_NEWEST },
+    };
+    static const uCxAtUrcClassRule_t rules[] = {
+        { "+STARTUP", U_CX_URC_CLASS_CRITICAL },
+    };
+    static int executorCalls;
+    uCxAtUrcStats_t stats;
+    char rxData[] = { "\r\n+STARTUP\r\n" TEST_URC "\r\n" };
+    gPRxDataPtr = (uint8_t *)&rxData[0];
+    gRxDataLen = strlen(rxData);
+    executorCalls = 0;
+
+    void urcExecutor(struct uCxAtClient *pClient, void *pArg)
+    {
+        TEST_ASSERT_EQUAL(&gClient, pClient);
+        TEST_ASSERT_EQUAL_PTR(&executorCalls, pArg);
+        executorCalls++;
+    }
+
+    uPortGetTickTimeMs_StopIgnore();
+    uPortGetTickTimeMs_StubWithCallback(uPortGetTickTimeMs_CALLBACK);
+    gPTickSequence = (int32_t []) {
+        100, 100, -1
+    };
+
+    TEST_ASSERT_EQUAL(0, uCxAtClientSetUrcClasses(&gClient, configs, rules, 1));
+    uCxAtClientSetUrcExecutor(&gClient, urcExecutor, &executorCalls);
+    uCxAtClientHandleRx(&gClient);
+    TEST_ASSERT_EQUAL(1, executorCalls);
+
+    uCxAtClientGetUrcStats(&gClient, &stats);
+    TEST_ASSERT_EQUAL(2, stats.queueDepth);
+    TEST_ASSERT_EQUAL(1, stats.classQueueDepth[U_CX_URC_CLASS_CRITICAL]);
+    TEST_ASSERT_EQUAL(1, stats.classQueueDepth[U_CX_URC_CLASS_DATA]);
+    TEST_ASSERT_EQUAL(0, stats.classQueueDepth[U_CX_URC_CLASS_BULK]);
+    TEST_ASSERT_EQUAL(0, stats.dropCount);
+
+    // Classes can't be changed while URCs are queued
+    TEST_ASSERT_EQUAL(U_CX_ERROR_INVALID_PARAMETER,
+                      uCxAtClientSetUrcClasses(&gClient, NULL, NULL, 0));
+}
+
 void test_uCxAtClientSetCommandTimeout_withNonPermanentTimeout(void)
 {
     gRxDataLen = 0;
@@ -71,11 +71,13 @@ static uCxAtClient_t gClient;
  * -------------------------------------------------------------- */
 
 /* Mock UART open function */
-uPortUartHandle_t uPortUartOpen(const char *pDeviceName, int32_t baudRate, bool flowControl)
+uPortUartHandle_t uPortUartOpenEx(const char *pDeviceName, int32_t baudRate, bool flowControl,
+                                  uint32_t flags)
 {
     (void)pDeviceName;
     (void)baudRate;
     (void)flowControl;
+    (void)flags;
     return UART_HANDLE;
 }
 
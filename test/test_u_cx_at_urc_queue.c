@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 
@@ -36,10 +37,36 @@ typedef struct {
 static uint8_t gBuffer[512];
 static uCxAtUrcQueue_t gQueue;
 
+static const uCxAtUrcClassConfig_t gClassConfigs[U_CX_URC_CLASS_COUNT] = {
+    [U_CX_URC_CLASS_CRITICAL] = { 25, U_CX_URC_DROP_NEWEST },
+    [U_CX_URC_CLASS_DATA] = { 50, U_CX_URC_DROP_NEWEST },
+    [U_CX_URC_CLASS_BULK] = { 25, U_CX_URC_DROP_OLDEST },
+};
+
+static const uCxAtUrcClassRule_t gClassRules[] = {
+    { "+STARTUP", U_CX_URC_CLASS_CRITICAL },
+    { "+UEBTBGD:", U_CX_URC_CLASS_BULK },
+};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+static void dequeueString(const char *pExpectedStr)
+{
+    uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    TEST_ASSERT_EQUAL_STRING(pExpectedStr, pEntry->data);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+}
+
+static void enqueueString(const char *pStr, int32_t timestampMs)
+{
+    TEST_ASSERT_TRUE(uCxAtUrcQueueEnqueueBegin(&gQueue, pStr, strlen(pStr)));
+    uCxAtUrcQueueEnqueueSetTimestamp(&gQueue, timestampMs);
+    uCxAtUrcQueueEnqueueEnd(&gQueue, 0);
+}
+
 /* ----------------------------------------------------------------
  * TEST FUNCTIONS
  * -------------------------------------------------------------- */
@@ -150,3 +177,221 @@ void test_uCxAtUrcQueueDequeueBegin_calledTwiceWithNonEmptyQueue_expectNull(void
     TEST_ASSERT_NOT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
     TEST_ASSERT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
 }
+
+void test_uCxAtUrcQueueEnqueueReserve_withLineInSlot_expectNoCopy(void)
+{
+    char *pLine = NULL;
+    size_t maxLen = uCxAtUrcQueueEnqueueReserve(&gQueue, "+FOO:", 5, &pLine);
+    TEST_ASSERT_NOT_NULL(pLine);
+    TEST_ASSERT_EQUAL(sizeof(gBuffer) - sizeof(uUrcEntry_t) - 1, maxLen);
+    TEST_ASSERT_EQUAL_MEMORY("+FOO:", pLine, 5);
+
+    strcpy(&pLine[5], "123");
+    TEST_ASSERT_TRUE(uCxAtUrcQueueEnqueueBegin(&gQueue, pLine, strlen("+FOO:123")));
+    uCxAtUrcQueueEnqueueEnd(&gQueue, 0);
+
+    uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    TEST_ASSERT_EQUAL_PTR(pLine, &pEntry->data[0]);
+    TEST_ASSERT_EQUAL_STRING("+FOO:123", pEntry->data);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+}
+
+void test_uCxAtUrcQueueEnqueueReserve_thenAbort_expectEmptyQueue(void)
+{
+    char *pLine = NULL;
+    TEST_ASSERT_GREATER_THAN(0, uCxAtUrcQueueEnqueueReserve(&gQueue, "+FOO:", 5, &pLine));
+    strcpy(pLine, "FOO");
+    uCxAtUrcQueueEnqueueAbort(&gQueue);
+
+    // The released slot content should be left untouched
+    TEST_ASSERT_EQUAL_STRING("FOO", pLine);
+    TEST_ASSERT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
+}
+
+void test_queueingAfterDequeue_expectWrapAround(void)
+{
+    char myStrings[3][200];
+    for (int i = 0; i < 3; i++) {
+        memset(&myStrings[i][0], 'A' + i, sizeof(myStrings[i]));
+    }
+
+    // Fill up the queue so that the third string doesn't fit at the end of the buffer
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(uCxAtUrcQueueEnqueueBegin(&gQueue, myStrings[i], sizeof(myStrings[i])));
+        uCxAtUrcQueueEnqueueEnd(&gQueue, 0);
+    }
+    TEST_ASSERT_FALSE(uCxAtUrcQueueEnqueueBegin(&gQueue, myStrings[2], sizeof(myStrings[2])));
+
+    // Dequeueing the first entry should make room at the start of the buffer
+    uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+    TEST_ASSERT_TRUE(uCxAtUrcQueueEnqueueBegin(&gQueue, myStrings[2], sizeof(myStrings[2])));
+    uCxAtUrcQueueEnqueueEnd(&gQueue, 0);
+    TEST_ASSERT_FALSE(uCxAtUrcQueueEnqueueBegin(&gQueue, myStrings[0], sizeof(myStrings[0])));
+
+    // Entries must still be dequeued in order
+    for (int i = 1; i < 3; i++) {
+        pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+        TEST_ASSERT_NOT_NULL(pEntry);
+        TEST_ASSERT_EQUAL(sizeof(myStrings[i]), pEntry->strLineLen);
+        TEST_ASSERT_EQUAL_MEMORY(myStrings[i], pEntry->data, sizeof(myStrings[i]));
+        uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+    }
+    TEST_ASSERT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
+}
+
+void test_coalesceSum_withSameHandle_expectMergedUrc(void)
+{
+    static const uCxAtUrcCoalesceRule_t rules[] = {
+        { "+UESODA:", U_CX_URC_COALESCE_SUM, 0 }
+    };
+    uCxAtUrcQueueSetCoalesceRules(&gQueue, rules, 1);
+
+    enqueueString("+UESODA:0,99", 1);
+    enqueueString("+UESODA:0,1", 2);
+    enqueueString("+UESODA:0,900", 3);
+    // Different handle must not be merged
+    enqueueString("+UESODA:1,5", 4);
+    TEST_ASSERT_EQUAL(2, uCxAtUrcQueueGetCount(&gQueue, NULL));
+
+    uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    TEST_ASSERT_EQUAL_STRING("+UESODA:0,1000", pEntry->data);
+    TEST_ASSERT_EQUAL(strlen("+UESODA:0,1000"), pEntry->strLineLen);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+
+    pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    TEST_ASSERT_EQUAL_STRING("+UESODA:1,5", pEntry->data);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+    TEST_ASSERT_EQUAL(2, gQueue.coalescedCount);
+}
+
+void test_coalesceSum_withDequeuedUrc_expectNoMerge(void)
+{
+    static const uCxAtUrcCoalesceRule_t rules[] = {
+        { "+UESODA:", U_CX_URC_COALESCE_SUM, 0 }
+    };
+    uCxAtUrcQueueSetCoalesceRules(&gQueue, rules, 1);
+
+    enqueueString("+UESODA:0,10", 1);
+    uUrcEntry_t *pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    // The entry being dequeued must not be modified
+    enqueueString("+UESODA:0,20", 2);
+    TEST_ASSERT_EQUAL_STRING("+UESODA:0,10", pEntry->data);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+
+    pEntry = uCxAtUrcQueueDequeueBegin(&gQueue);
+    TEST_ASSERT_NOT_NULL(pEntry);
+    TEST_ASSERT_EQUAL_STRING("+UESODA:0,20", pEntry->data);
+    uCxAtUrcQueueDequeueEnd(&gQueue, pEntry);
+}
+
+void test_coalesceDedup_withinWindow_expectDroppedUrc(void)
+{
+    static const uCxAtUrcCoalesceRule_t rules[] = {
+        { "+UEBTBGD:", U_CX_URC_COALESCE_DEDUP, 1000 }
+    };
+    uCxAtUrcQueueSetCoalesceRules(&gQueue, rules, 1);
+
+    enqueueString("+UEBTBGD:AABBCCDDEEFFp,-50,\"foo\",0,00", 100);
+    enqueueString("+UEBTBGD:AABBCCDDEEFFp,-52,\"foo\",0,00", 500);
+    enqueueString("+UEBTBGD:112233445566p,-60,\"bar\",0,00", 600);
+    enqueueString("+UEBTBGD:AABBCCDDEEFFp,-51,\"foo\",0,00", 1100);
+    TEST_ASSERT_EQUAL(3, uCxAtUrcQueueGetCount(&gQueue, NULL));
+    TEST_ASSERT_EQUAL(1, gQueue.coalescedCount);
+}
+
+void test_urcClasses_withBulkFlood_expectCriticalUrcQueued(void)
+{
+    TEST_ASSERT_TRUE(uCxAtUrcQueueSetClasses(&gQueue, gClassConfigs, gClassRules, 2));
+
+    char line[32];
+    for (int i = 0; i < 20; i++) {
+        snprintf(line, sizeof(line), "+UEBTBGD:0000000000%02d", i);
+        enqueueString(line, 0);
+    }
+    enqueueString("+STARTUP", 0);
+
+    size_t count;
+    uint32_t dropCount;
+    uCxAtUrcQueueGetClassStats(&gQueue, U_CX_URC_CLASS_BULK, &count, &dropCount);
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(17, dropCount);
+    uCxAtUrcQueueGetClassStats(&gQueue, U_CX_URC_CLASS_CRITICAL, &count, &dropCount);
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(0, dropCount);
+
+    // Only the newest bulk URCs are kept
+    dequeueString("+UEBTBGD:000000000017");
+    dequeueString("+UEBTBGD:000000000018");
+    dequeueString("+UEBTBGD:000000000019");
+    dequeueString("+STARTUP");
+    TEST_ASSERT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
+}
+
+void test_urcClasses_withDifferentClasses_expectReceiveOrder(void)
+{
+    TEST_ASSERT_TRUE(uCxAtUrcQueueSetClasses(&gQueue, gClassConfigs, gClassRules, 2));
+
+    enqueueString("+FOO:1", 0);
+    enqueueString("+STARTUP", 0);
+    enqueueString("+UEBTBGD:1", 0);
+    enqueueString("+FOO:2", 0);
+    TEST_ASSERT_EQUAL(4, uCxAtUrcQueueGetCount(&gQueue, NULL));
+
+    dequeueString("+FOO:1");
+    dequeueString("+STARTUP");
+    dequeueString("+UEBTBGD:1");
+    dequeueString("+FOO:2");
+    TEST_ASSERT_NULL(uCxAtUrcQueueDequeueBegin(&gQueue));
+}
+
+void test_urcClasses_withDropCoalesce_expectReplacedUrc(void)
+{
+    static const uCxAtUrcClassConfig_t configs[U_CX_URC_CLASS_COUNT] = {
+        [U_CX_URC_CLASS_DATA] = { 100, U_CX_URC_DROP_COALESCE },
+    };
+    TEST_ASSERT_TRUE(uCxAtUrcQueueSetClasses(&gQueue, configs, NULL, 0));
+
+    char line[112];
+    for (int i = 0; i < 4; i++) {
+        snprintf(line, sizeof(line), "+FOO:%d,%093d", i, 0);
+        enqueueString(line, 0);
+    }
+    // The queue is full so the queued URC with the same first param is replaced
+    snprintf(line, sizeof(line), "+FOO:%d,%093d", 1, 1);
+    enqueueString(line, 0);
+    // No queued URC to replace
+    snprintf(line, sizeof(line), "+FOO:%d,%093d", 9, 1);
+    TEST_ASSERT_FALSE(uCxAtUrcQueueEnqueueBegin(&gQueue, line, strlen(line)));
+
+    size_t count;
+    uint32_t dropCount;
+    uCxAtUrcQueueGetClassStats(&gQueue, U_CX_URC_CLASS_DATA, &count, &dropCount);
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_EQUAL(2, dropCount);
+
+    snprintf(line, sizeof(line), "+FOO:%d,%093d", 0, 0);
+    dequeueString(line);
+    snprintf(line, sizeof(line), "+FOO:%d,%093d", 1, 1);
+    dequeueString(line);
+}
+
+void test_uCxAtUrcQueueSetClasses_withInvalidConfig_expectFalse(void)
+{
+    static const uCxAtUrcClassConfig_t noDataConfigs[U_CX_URC_CLASS_COUNT] = {
+        [U_CX_URC_CLASS_CRITICAL] = { 50, U_CX_URC_DROP_NEWEST },
+        [U_CX_URC_CLASS_BULK] = { 50, U_CX_URC_DROP_OLDEST },
+    };
+    TEST_ASSERT_FALSE(uCxAtUrcQueueSetClasses(&gQueue, noDataConfigs, NULL, 0));
+
+    // Classes can't be changed while URCs are queued
+    enqueueString("+FOO:1", 0);
+    TEST_ASSERT_FALSE(uCxAtUrcQueueSetClasses(&gQueue, gClassConfigs, gClassRules, 2));
+    dequeueString("+FOO:1");
+    TEST_ASSERT_TRUE(uCxAtUrcQueueSetClasses(&gQueue, gClassConfigs, gClassRules, 2));
+}
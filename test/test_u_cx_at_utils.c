@@ -518,3 +518,362 @@ void test_uCxAtUtilReplaceChar_withNullTermTestString_replaceNullWithComma()
     uCxAtUtilReplaceChar(str, sizeof(str) - 1, 0, ',');
     TEST_ASSERT_EQUAL_STRING("My,Test,String", str);
 }
+
+void test_gUCxAtByteClass_expectSameAsIsPrint(void)
+{
+    for (int ch = 0; ch < 256; ch++) {
+        uint8_t expected = U_CX_AT_BYTE_IGNORE;
+        if (ch == U_CX_SOH_CHAR) {
+            expected = U_CX_AT_BYTE_SOH;
+        } else if ((ch == '\r') || (ch == '\n')) {
+            expected = U_CX_AT_BYTE_EOL;
+        } else if ((ch >= 0x20) && (ch <= 0x7E)) {
+            expected = U_CX_AT_BYTE_PRINT;
+        }
+        TEST_ASSERT_EQUAL(expected, gUCxAtByteClass[ch]);
+    }
+}
+
+void test_uCxAtUtilClassifyLine_withStatusLines(void)
+{
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_EMPTY, uCxAtUtilClassifyLine("", 0, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_OK, uCxAtUtilClassifyLine("OK", 2, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_OTHER, uCxAtUtilClassifyLine("OKAY", 4, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_ERROR, uCxAtUtilClassifyLine("ERROR", 5, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_ERROR, uCxAtUtilClassifyLine("ERROR:12", 8, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_OTHER, uCxAtUtilClassifyLine("ERR", 3, NULL, 0));
+}
+
+void test_uCxAtUtilClassifyLine_withExpectedRsp(void)
+{
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_EXPECTED_RSP,
+                      uCxAtUtilClassifyLine("+UWSSC:1", 8, "+UWSSC:", 7));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_URC,
+                      uCxAtUtilClassifyLine("+UEWLU:0", 8, "+UWSSC:", 7));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_URC, uCxAtUtilClassifyLine("+UWSSC", 6, "+UWSSC:", 7));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_URC, uCxAtUtilClassifyLine("*FOO", 4, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_ECHO, uCxAtUtilClassifyLine("AT+GMM", 6, NULL, 0));
+    TEST_ASSERT_EQUAL(U_CX_AT_LINE_OTHER, uCxAtUtilClassifyLine("NORA-W36", 8, NULL, 0));
+}
+
+void test_uCxAtUtilBinaryToHex_withAllLengths_expectSameAsByteToHex(void)
+{
+    uint8_t data[70];
+    char hex[(sizeof(data) * 2) + 1];
+    char expected[(sizeof(data) * 2) + 1];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)((i * 37) + 11);
+    }
+    for (size_t len = 0; len <= sizeof(data); len++) {
+        expected[0] = 0;
+        for (size_t i = 0; i < len; i++) {
+            uCxAtUtilByteToHex(data[i], &expected[i * 2]);
+        }
+        TEST_ASSERT_TRUE(uCxAtUtilBinaryToHex(data, len, hex, sizeof(hex)));
+        TEST_ASSERT_EQUAL_STRING(expected, hex);
+    }
+}
+
+void test_uCxAtUtilHexToBinary_withMixedCase_expectAllBytes(void)
+{
+    uint8_t data[40];
+    uint8_t expected[40];
+    char hex[] = "00112233445566778899aabbccddeeffAABBCCDDEEFF0123456789abcdefABCDEF00112233445566778899";
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        uCxAtUtilHexToByte(&hex[i * 2], &expected[i]);
+    }
+    TEST_ASSERT_EQUAL(sizeof(data), uCxAtUtilHexToBinary(hex, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, sizeof(data));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, data[10]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, data[29]);
+}
+
+void test_uCxAtUtilHexToBinary_withInvalidChar_expectStopAtInvalidChar(void)
+{
+    uint8_t data[32];
+    const char *pInvalidChars = "gG/:@`\x80 ";
+    for (size_t pos = 0; pos < 64; pos += 7) {
+        for (const char *pCh = pInvalidChars; *pCh != 0; pCh++) {
+            char hex[65];
+            memset(hex, 'a', 64);
+            hex[64] = 0;
+            hex[pos] = *pCh;
+            TEST_ASSERT_EQUAL(pos / 2, uCxAtUtilHexToBinary(hex, data, sizeof(data)));
+        }
+    }
+}
+
+void test_uCxAtUtilHexToBinary_withControlChar_expectSameAsHexToByte(void)
+{
+    // 0x10-0x19 only differ from '0'-'9' in bit 5
+    uint8_t data[32];
+    for (char ch = 0x10; ch <= 0x19; ch++) {
+        for (size_t pos = 0; pos < 64; pos += 5) {
+            char hex[65];
+            memset(hex, '5', 64);
+            hex[64] = 0;
+            hex[pos] = ch;
+            size_t expectedLen = 0;
+            while ((expectedLen < sizeof(data)) &&
+                   (uCxAtUtilHexToByte(&hex[expectedLen * 2], &data[expectedLen]) == 0)) {
+                expectedLen++;
+            }
+            TEST_ASSERT_EQUAL(pos / 2, expectedLen);
+            TEST_ASSERT_EQUAL(expectedLen, uCxAtUtilHexToBinary(hex, data, sizeof(data)));
+        }
+    }
+}
+
+void test_uCxAtUtilParseParamsF_withControlCharInByteArray_expectError(void)
+{
+    char buf[] = "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F";
+    buf[48] = 0x15;
+    uByteArray_t byteArray;
+    TEST_ASSERT_LESS_THAN(0, uCxAtUtilParseParamsF(buf, "h", &byteArray, U_CX_AT_UTIL_PARAM_LAST));
+}
+
+void test_uCxAtUtilParseParamsF_withLongByteArray_expectInPlaceConversion(void)
+{
+    char buf[] = "0,000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F2021";
+    int32_t num;
+    uByteArray_t byteArray;
+    TEST_ASSERT_EQUAL(2, uCxAtUtilParseParamsF(buf, "dh", &num, &byteArray, U_CX_AT_UTIL_PARAM_LAST));
+    TEST_ASSERT_EQUAL(34, byteArray.length);
+    for (size_t i = 0; i < byteArray.length; i++) {
+        TEST_ASSERT_EQUAL_HEX8(i, byteArray.pData[i]);
+    }
+}
+
+void test_uCxAtUtilParseParamsF_withInvalidByteArray_expectError(void)
+{
+    char buf[] = "000102030405060708090A0B0C0D0E0F1011121314151617181920X1";
+    uByteArray_t byteArray;
+    TEST_ASSERT_LESS_THAN(0, uCxAtUtilParseParamsF(buf, "h", &byteArray, U_CX_AT_UTIL_PARAM_LAST));
+}
+
+static char gStreamBuffer[1024];
+static size_t gStreamLen;
+
+static int32_t streamWriteFunc(void *pArg, const void *pData, size_t dataLen)
+{
+    (void)pArg;
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(gStreamBuffer), gStreamLen + dataLen);
+    memcpy(&gStreamBuffer[gStreamLen], pData, dataLen);
+    gStreamLen += dataLen;
+    return (int32_t)dataLen;
+}
+
+void test_uCxAtUtilFindEscapeChar_withEscapeCharAtAllPositions_expectPosition(void)
+{
+    const char escChars[] = { '"', '\\', '\n', '\x1F', '\x7F', '\x80', '\xFF', '\0' };
+    char buf[70];
+    memset(buf, 'a', sizeof(buf));
+    TEST_ASSERT_EQUAL(sizeof(buf), uCxAtUtilFindEscapeChar(buf, sizeof(buf)));
+    for (size_t pos = 0; pos < sizeof(buf); pos++) {
+        memset(buf, 'a', sizeof(buf));
+        buf[pos] = escChars[pos % sizeof(escChars)];
+        TEST_ASSERT_EQUAL(pos, uCxAtUtilFindEscapeChar(buf, sizeof(buf)));
+        // The escape char must not be found outside of the given length
+        TEST_ASSERT_EQUAL(pos, uCxAtUtilFindEscapeChar(buf, pos));
+    }
+}
+
+void test_uCxAtUtilWriteEscStringStream_withSmallScratch_expectSameAsWriteEscString(void)
+{
+    char str[200];
+    char expected[sizeof(gStreamBuffer)];
+    char scratch[64];
+    // Mix of long runs without escapes and escape sequences
+    for (size_t i = 0; i < sizeof(str); i++) {
+        str[i] = (char)('A' + (i % 26));
+    }
+    str[0] = '"';
+    str[20] = '\\';
+    str[21] = '\r';
+    str[22] = '\x01';
+    str[150] = '"';
+    str[sizeof(str) - 1] = '\n';
+    size_t expectedLen = uCxAtUtilWriteEscString(str, sizeof(str), expected, sizeof(expected));
+    TEST_ASSERT_GREATER_THAN(sizeof(str) + 2, expectedLen);
+
+    for (size_t scratchSize = U_CX_AT_UTIL_ESC_SCRATCH_MIN_SIZE; scratchSize <= sizeof(scratch); scratchSize++) {
+        gStreamLen = 0;
+        size_t len = uCxAtUtilWriteEscStringStream(str, sizeof(str), scratch, scratchSize,
+                                                   streamWriteFunc, NULL);
+        TEST_ASSERT_EQUAL(expectedLen, len);
+        TEST_ASSERT_EQUAL(expectedLen, gStreamLen);
+        TEST_ASSERT_EQUAL_MEMORY(expected, gStreamBuffer, expectedLen);
+    }
+}
+
+void test_uCxAtUtilWriteEscStringStream_withEmptyString_expectQuotes(void)
+{
+    char scratch[U_CX_AT_UTIL_ESC_SCRATCH_MIN_SIZE];
+    gStreamLen = 0;
+    TEST_ASSERT_EQUAL(2, uCxAtUtilWriteEscStringStream("", 0, scratch, sizeof(scratch),
+                                                       streamWriteFunc, NULL));
+    TEST_ASSERT_EQUAL_MEMORY("\"\"", gStreamBuffer, 2);
+}
+
+/* Reference implementations of the original character by character parsers.
+ * Used for checking that the optimized versions produce identical results.
+ */
+static char *refFindParamEnd(char *pStr)
+{
+    bool insideString = false;
+    bool insideBracket = false;
+    bool escape = false;
+
+    char *pIter = pStr;
+    while (*pIter != 0) {
+        if (escape) {
+            escape = false;
+        } else if (*pIter == '\\') {
+            escape = true;
+        } else if (insideString) {
+            if (*pIter == '"') {
+                insideString = false;
+            }
+        } else if (*pIter == '"') {
+            insideString = true;
+        } else if (*pIter == '[') {
+            insideBracket = true;
+        } else if (*pIter == ']') {
+            insideBracket = false;
+        } else if (*pIter == ',' && !insideBracket) {
+            break;
+        }
+        pIter++;
+    }
+
+    if (insideString || escape || insideBracket) {
+        return NULL;
+    }
+
+    return pIter;
+}
+
+static int32_t refHexToNibble(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+static size_t refUnescapeString(char *pStr)
+{
+    char *pRead = pStr;
+    char *pWrite = pStr;
+
+    while (*pRead != '\0') {
+        if (*pRead == '\\' && pRead[1] != '\0') {
+            pRead++;
+            switch (*pRead) {
+                case 'r': *pWrite++ = '\r'; break;
+                case 'n': *pWrite++ = '\n'; break;
+                case 't': *pWrite++ = '\t'; break;
+                case 'b': *pWrite++ = '\b'; break;
+                case '"': *pWrite++ = '"'; break;
+                case '\\': *pWrite++ = '\\'; break;
+                case '0': *pWrite++ = '\0'; break;
+                case 'x':
+                    if (pRead[1] != '\0' && pRead[2] != '\0' &&
+                        refHexToNibble(pRead[1]) >= 0 && refHexToNibble(pRead[2]) >= 0) {
+                        *pWrite++ = (char)((refHexToNibble(pRead[1]) << 4) | refHexToNibble(pRead[2]));
+                        pRead += 2;
+                    } else {
+                        *pWrite++ = *pRead;
+                    }
+                    break;
+                default:
+                    *pWrite++ = '\\';
+                    *pWrite++ = *pRead;
+                    break;
+            }
+            pRead++;
+        } else {
+            *pWrite++ = *pRead++;
+        }
+    }
+    *pWrite = '\0';
+    return (size_t)(pWrite - pStr);
+}
+
+// Generate a pseudo random parameter string biased towards the special characters
+static size_t generateCorpusEntry(uint32_t *pSeed, char *pBuf, size_t bufSize)
+{
+    static const char special[] = "\\\"[],x0fGnrtb\x01";
+    *pSeed = (*pSeed * 1103515245u) + 12345u;
+    size_t len = (*pSeed >> 16) % (bufSize - 1);
+    for (size_t i = 0; i < len; i++) {
+        *pSeed = (*pSeed * 1103515245u) + 12345u;
+        uint32_t r = *pSeed >> 16;
+        if ((r % 8) == 0) {
+            pBuf[i] = special[(r / 8) % (sizeof(special) - 1)];
+        } else {
+            pBuf[i] = (char)('A' + (r % 26));
+        }
+    }
+    pBuf[len] = 0;
+    return len;
+}
+
+void test_uCxAtUtilFindParamEnd_withCorpus_expectSameAsReference(void)
+{
+    char buf[160];
+    uint32_t seed = 1;
+    for (int i = 0; i < 20000; i++) {
+        generateCorpusEntry(&seed, buf, sizeof(buf));
+        char *pRef = refFindParamEnd(buf);
+        char *pEnd = uCxAtUtilFindParamEnd(buf);
+        if (pRef != pEnd) {
+            TEST_FAIL_MESSAGE(buf);
+        }
+    }
+}
+
+void test_uCxAtUtilParseParamsF_withBinaryStringCorpus_expectSameAsReference(void)
+{
+    char buf[160];
+    char ref[160];
+    uint32_t seed = 2;
+    for (int i = 0; i < 20000; i++) {
+        // Leave room for the quotes
+        size_t len = generateCorpusEntry(&seed, buf, sizeof(buf) - 2);
+        if ((i % 2) == 0) {
+            // Also cover quoted strings
+            memmove(&buf[1], buf, len);
+            buf[0] = '"';
+            buf[len + 1] = '"';
+            buf[len + 2] = 0;
+        }
+        memcpy(ref, buf, sizeof(ref));
+
+        // Reference parsing of the first param as a binary string
+        char *pRefParam = ref;
+        char *pRefEnd = refFindParamEnd(ref);
+        uBinaryString_t binStr;
+        int32_t ret = uCxAtUtilParseParamsF(buf, "$", &binStr, U_CX_AT_UTIL_PARAM_LAST);
+        if (pRefEnd == NULL) {
+            TEST_ASSERT_EQUAL(-1, ret);
+            continue;
+        }
+        TEST_ASSERT_EQUAL(1, ret);
+        *pRefEnd = 0;
+        if (*pRefParam == '"') {
+            pRefParam++;
+            if (pRefEnd > pRefParam && pRefEnd[-1] == '"') {
+                pRefEnd[-1] = 0;
+            }
+        }
+        size_t refLen = refUnescapeString(pRefParam);
+        TEST_ASSERT_EQUAL(refLen, binStr.length);
+        TEST_ASSERT_EQUAL_PTR(&buf[pRefParam - ref], binStr.pData);
+        TEST_ASSERT_EQUAL_MEMORY(pRefParam, binStr.pData, refLen + 1);
+    }
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <stdbool.h>
+
+#include "unity.h"
+#include "mock_u_cx_log.h"
+#include "mock_u_port.h"
+#include "u_cx_xmodem.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define UART_HANDLE    ((uPortUartHandle_t)0x44332211)
+
+#define XMODEM_STX     0x02
+#define XMODEM_ACK     0x06
+#define XMODEM_NAK     0x15
+#define XMODEM_CAN     0x18
+#define XMODEM_CCHR    0x43
+#define XMODEM_GCHR    0x47
+#define XMODEM_PACKET_SIZE_1K  (3 + 1024 + 2)
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static uint8_t gData[4096];
+
+static uint8_t gTxBuffer[4 * XMODEM_PACKET_SIZE_1K];
+static size_t gTxBufferPos;
+
+static const uint8_t *gPRxScript;
+static size_t gRxScriptLen;
+static size_t gRxScriptPos;
+static uint8_t gPollRxByte;
+
+// Sequence of events: 'W' = write, 'R' = read, 'P' = poll, 'D' = data callback
+static char gEvents[64];
+static size_t gEventCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Original bit by bit CRC16-CCITT implementation used as reference
+static uint16_t refCrc16(const uint8_t *pBuf, size_t len)
+{
+    uint16_t crc = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)pBuf[i] << 8;
+        for (int j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ 0x1021;
+            } else {
+                crc = crc << 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+static void fillRandom(uint8_t *pBuf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        seed = (seed * 1103515245u) + 12345u;
+        pBuf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+/* Mock UART open function */
+uPortUartHandle_t uPortUartOpen(const char *pDeviceName, int32_t baudRate, bool flowControl)
+{
+    (void)pDeviceName;
+    (void)baudRate;
+    (void)flowControl;
+    return UART_HANDLE;
+}
+
+/* Mock UART close function */
+void uPortUartClose(uPortUartHandle_t handle)
+{
+    TEST_ASSERT_EQUAL(UART_HANDLE, handle);
+}
+
+static void addEvent(char event)
+{
+    TEST_ASSERT_LESS_THAN(sizeof(gEvents) - 1, gEventCount);
+    gEvents[gEventCount++] = event;
+    gEvents[gEventCount] = 0;
+}
+
+/* Mock UART write function */
+int32_t uPortUartWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    TEST_ASSERT_EQUAL(UART_HANDLE, handle);
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(gTxBuffer), gTxBufferPos + length);
+    memcpy(&gTxBuffer[gTxBufferPos], pData, length);
+    gTxBufferPos += length;
+    addEvent('W');
+    return (int32_t)length;
+}
+
+/* Mock UART read function returning one scripted byte per call.
+ * Reads without timeout (polling) return gPollRxByte once if set.
+ */
+int32_t uPortUartRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    TEST_ASSERT_EQUAL(UART_HANDLE, handle);
+    TEST_ASSERT_EQUAL(1, length);
+    if (timeoutMs == 0) {
+        addEvent('P');
+        if (gPollRxByte == 0) {
+            return 0;
+        }
+        *(uint8_t *)pData = gPollRxByte;
+        gPollRxByte = 0;
+        return 1;
+    }
+    if (gRxScriptPos >= gRxScriptLen) {
+        TEST_FAIL_MESSAGE("Read after end of RX script");
+    }
+    *(uint8_t *)pData = gPRxScript[gRxScriptPos++];
+    addEvent('R');
+    return 1;
+}
+
+static int32_t dataCallback(uint8_t *pBuffer, size_t offset, size_t maxLen, void *pUserData)
+{
+    size_t dataLen = *(size_t *)pUserData;
+    size_t len = ((dataLen - offset) < maxLen) ? (dataLen - offset) : maxLen;
+    memcpy(pBuffer, &gData[offset], len);
+    addEvent('D');
+    return (int32_t)len;
+}
+
+static void openXmodem(uCxXmodemConfig_t *pConfig, const uint8_t *pRxScript, size_t rxScriptLen,
+                       bool flowControl)
+{
+    uCxXmodemInit("UART0", pConfig);
+    pConfig->blockDelayMs = 0;
+    TEST_ASSERT_EQUAL(0, uCxXmodemOpen(pConfig, 115200, flowControl));
+    gPRxScript = pRxScript;
+    gRxScriptLen = rxScriptLen;
+}
+
+static void assertPacket(const uint8_t *pPacket, uint8_t blockNum, const uint8_t *pData, size_t dataLen)
+{
+    TEST_ASSERT_EQUAL_HEX8(XMODEM_STX, pPacket[0]);
+    TEST_ASSERT_EQUAL_HEX8(blockNum, pPacket[1]);
+    TEST_ASSERT_EQUAL_HEX8((uint8_t)~blockNum, pPacket[2]);
+    TEST_ASSERT_EQUAL_MEMORY(pData, &pPacket[3], dataLen);
+    for (size_t i = dataLen; i < 1024; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x1A, pPacket[3 + i]);
+    }
+    uint16_t crc = refCrc16(&pPacket[3], 1024);
+    TEST_ASSERT_EQUAL_HEX8(crc >> 8, pPacket[3 + 1024]);
+    TEST_ASSERT_EQUAL_HEX8(crc & 0xFF, pPacket[3 + 1025]);
+}
+
+/* ----------------------------------------------------------------
+ * TEST FUNCTIONS
+ * -------------------------------------------------------------- */
+
+void setUp(void)
+{
+    uCxLogIsEnabled_IgnoreAndReturn(false);
+    uPortGetTickTimeMs_IgnoreAndReturn(0);
+    gTxBufferPos = 0;
+    gRxScriptPos = 0;
+    gPollRxByte = 0;
+    gEventCount = 0;
+    gEvents[0] = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_uCxXmodemCrc16_withCheckString_expectKnownCrc(void)
+{
+    const char check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x31C3, uCxXmodemCrc16(0, (const uint8_t *)check, strlen(check)));
+}
+
+void test_uCxXmodemCrc16_withEmptyData_expectInitialCrc(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0x0000, uCxXmodemCrc16(0, gData, 0));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, uCxXmodemCrc16(0x1234, gData, 0));
+}
+
+void test_uCxXmodemCrc16_withRandomData_expectSameAsReference(void)
+{
+    fillRandom(gData, sizeof(gData), 1);
+    for (size_t len = 0; len <= 1100; len++) {
+        TEST_ASSERT_EQUAL_HEX16(refCrc16(gData, len), uCxXmodemCrc16(0, gData, len));
+    }
+    // Unaligned start
+    for (size_t offset = 1; offset < 8; offset++) {
+        TEST_ASSERT_EQUAL_HEX16(refCrc16(&gData[offset], 1024),
+                                uCxXmodemCrc16(0, &gData[offset], 1024));
+    }
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(gData, sizeof(gData)), uCxXmodemCrc16(0, gData, sizeof(gData)));
+}
+
+void test_uCxXmodemCrc16_withChunkedData_expectSameAsSingleCall(void)
+{
+    fillRandom(gData, sizeof(gData), 2);
+    uint16_t expected = uCxXmodemCrc16(0, gData, 1024);
+    for (size_t split = 0; split <= 1024; split += 13) {
+        uint16_t crc = uCxXmodemCrc16(0, gData, split);
+        crc = uCxXmodemCrc16(crc, &gData[split], 1024 - split);
+        TEST_ASSERT_EQUAL_HEX16(expected, crc);
+    }
+}
+
+void test_uCxXmodemSend_withThreeBlocks_expectNextBlockPreparedBeforeAck(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_CCHR, XMODEM_ACK, XMODEM_ACK, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 2500;
+    fillRandom(gData, sizeof(gData), 3);
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+
+    // Start, then each block is written before the next one is read and the ACK arrives
+    TEST_ASSERT_EQUAL_STRING("RDWDRWDRWRWR", gEvents);
+    TEST_ASSERT_EQUAL((3 * XMODEM_PACKET_SIZE_1K) + 1, gTxBufferPos);
+    assertPacket(&gTxBuffer[0], 1, &gData[0], 1024);
+    assertPacket(&gTxBuffer[XMODEM_PACKET_SIZE_1K], 2, &gData[1024], 1024);
+    assertPacket(&gTxBuffer[2 * XMODEM_PACKET_SIZE_1K], 3, &gData[2048], dataLen - 2048);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSend_withNak_expectSameBlockResent(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_CCHR, XMODEM_NAK, XMODEM_ACK, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 2048;
+    fillRandom(gData, sizeof(gData), 4);
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+
+    // The next block must only be read once even if the current block is resent
+    TEST_ASSERT_EQUAL_STRING("RDWDRWRWRWR", gEvents);
+    assertPacket(&gTxBuffer[0], 1, &gData[0], 1024);
+    assertPacket(&gTxBuffer[XMODEM_PACKET_SIZE_1K], 1, &gData[0], 1024);
+    assertPacket(&gTxBuffer[2 * XMODEM_PACKET_SIZE_1K], 2, &gData[1024], 1024);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSend_withStreamingRequest_expectBlocksWithoutAck(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_GCHR, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 3000;
+    fillRandom(gData, sizeof(gData), 5);
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+
+    // Only the EOT is ACKed, in between the sender only polls for cancel
+    TEST_ASSERT_EQUAL_STRING("RDWDPWDPWPWR", gEvents);
+    assertPacket(&gTxBuffer[0], 1, &gData[0], 1024);
+    assertPacket(&gTxBuffer[XMODEM_PACKET_SIZE_1K], 2, &gData[1024], 1024);
+    assertPacket(&gTxBuffer[2 * XMODEM_PACKET_SIZE_1K], 3, &gData[2048], dataLen - 2048);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSend_withStreamingCancelled_expectCancelError(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_GCHR };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 3000;
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+    gPollRxByte = XMODEM_CAN;
+
+    TEST_ASSERT_EQUAL(-3, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+    TEST_ASSERT_EQUAL_STRING("RDWDP", gEvents);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSend_withStreamingNotAllowed_expectClassicXmodem(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_GCHR, XMODEM_CCHR, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 1000;
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+    config.allowStreaming = false;
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+    // 'G' is ignored and the transfer starts on 'C'
+    TEST_ASSERT_EQUAL_STRING("RRDWRWR", gEvents);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSend_withStreamingRequestNoFlowControl_expectClassicXmodem(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_GCHR, XMODEM_CCHR, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    size_t dataLen = 1000;
+    openXmodem(&config, rxScript, sizeof(rxScript), false);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSend(&config, dataLen, dataCallback, NULL, &dataLen));
+    // Nothing paces streamed blocks without flow control so 'G' is ignored
+    TEST_ASSERT_EQUAL_STRING("RRDWRWR", gEvents);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemCalcBlockCrcs_withPartialLastBlock_expectPaddedCrc(void)
+{
+    uCxXmodemConfig_t config;
+    uint16_t crcs[3];
+    uint8_t block[1024];
+    fillRandom(gData, sizeof(gData), 6);
+    uCxXmodemInit("UART0", &config);
+
+    uCxXmodemCalcBlockCrcs(&config, gData, 2500, crcs);
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(&gData[0], 1024), crcs[0]);
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(&gData[1024], 1024), crcs[1]);
+    memset(block, 0x1A, sizeof(block));
+    memcpy(block, &gData[2048], 2500 - 2048);
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(block, sizeof(block)), crcs[2]);
+
+    // 128 byte blocks
+    uint16_t crcs128[2];
+    config.use1K = false;
+    uCxXmodemCalcBlockCrcs(&config, gData, 256, crcs128);
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(&gData[0], 128), crcs128[0]);
+    TEST_ASSERT_EQUAL_HEX16(refCrc16(&gData[128], 128), crcs128[1]);
+}
+
+void test_uCxXmodemSendBuffer_withBlockCrcs_expectPacketsFromBuffer(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_CCHR, XMODEM_ACK, XMODEM_ACK, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    uint16_t crcs[3];
+    size_t dataLen = 2500;
+    fillRandom(gData, sizeof(gData), 7);
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+    uCxXmodemCalcBlockCrcs(&config, gData, dataLen, crcs);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSendBuffer(&config, gData, dataLen, crcs, NULL, NULL));
+
+    TEST_ASSERT_EQUAL_STRING("RWRWRWRWR", gEvents);
+    assertPacket(&gTxBuffer[0], 1, &gData[0], 1024);
+    assertPacket(&gTxBuffer[XMODEM_PACKET_SIZE_1K], 2, &gData[1024], 1024);
+    assertPacket(&gTxBuffer[2 * XMODEM_PACKET_SIZE_1K], 3, &gData[2048], dataLen - 2048);
+    uCxXmodemClose(&config);
+}
+
+void test_uCxXmodemSendBuffer_withBlockCrcs_expectPrecomputedCrcUsed(void)
+{
+    static const uint8_t rxScript[] = { XMODEM_CCHR, XMODEM_ACK, XMODEM_ACK };
+    uCxXmodemConfig_t config;
+    uint16_t crcs[1] = { 0xBEEF };
+    openXmodem(&config, rxScript, sizeof(rxScript), true);
+
+    TEST_ASSERT_EQUAL(0, uCxXmodemSendBuffer(&config, gData, 100, crcs, NULL, NULL));
+    TEST_ASSERT_EQUAL_HEX8(0xBE, gTxBuffer[3 + 1024]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, gTxBuffer[3 + 1025]);
+    uCxXmodemClose(&config);
+}
@@ -0,0 +1,725 @@
+/*
+ * Copyright 2025 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Offline analyzer for AT traffic capture files
+ *
+ * Reads a capture file written by the capture backend
+ * (u_port_uart_capture.c) and writes a JSON report with:
+ * - Per command latency distribution, status counts and binary transfer
+ *   throughput
+ * - The slowest single commands
+ * - URC counts, average and peak rates per URC type
+ * - Idle line gaps
+ *
+ * The captured RX is parsed by the AT client itself: the commands are
+ * split from the captured TX and started with uCxAtClientCmdBeginF() on a
+ * client whose UART backend delivers the captured RX. The RX that was
+ * captured before a command is handled with uCxAtClientHandleRx(), the RX
+ * up to the next command is read with uCxAtClientCmdGetRspParamLine() and
+ * uCxAtClientCmdEnd(). Responses, status lines and URCs are therefore
+ * classified exactly like in the application. Latencies are from the
+ * start of the command TX to the end of its status line.
+ *
+ * Usage: capture_analyzer [-i idle_ms] [-o report.json] capture_file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "u_cx_at_client.h"
+#include "u_cx_at_util.h"
+#include "u_cx_log.h"
+#include "u_port_uart_capture.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#define DEFAULT_IDLE_MS     100
+#define MAX_NAME_LEN        32
+#define MAX_CMD_TEXT_LEN    128
+#define SLOWEST_COUNT       10
+#define US_PER_SECOND       1000000ULL
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** One command split from the captured TX */
+typedef struct {
+    char text[MAX_CMD_TEXT_LEN]; /**< Command without binary data, truncated if long */
+    uint64_t startOffset;   /**< TX offset of the first byte */
+    uint64_t endOffset;     /**< TX offset after the last byte */
+    uint64_t timeUs;        /**< Time of the first byte */
+    size_t binaryBytes;     /**< Binary payload bytes */
+} command_t;
+
+/** Splits the captured TX into commands */
+typedef struct {
+    uPortUartCaptureReader_t reader;
+    uPortUartCaptureRecord_t record;
+    size_t pos;
+    uint64_t offset;
+} txParser_t;
+
+/** The UART backend of the client, delivers the captured RX */
+typedef struct {
+    uPortUartCaptureReader_t reader;
+    uPortUartCaptureRecord_t record;
+    size_t pos;
+    bool end;
+    uint64_t txCount;       /**< Captured TX bytes passed while reading RX records */
+    uint64_t txBefore;      /**< Captured TX bytes before the current RX record */
+    uint64_t releaseTx;     /**< RX captured after up to this many TX bytes is delivered */
+    bool inCommand;         /**< Running out of RX ends the command without status */
+    uint64_t lastTimeUs;    /**< Time of the last delivered byte */
+} rxFeed_t;
+
+typedef struct {
+    char name[MAX_NAME_LEN];
+    size_t count;
+    size_t ok;
+    size_t error;
+    size_t noStatus;
+    size_t responses;
+    size_t binaryTxBytes;
+    size_t binaryRxBytes;
+    uint64_t binaryUs;      /**< Total latency of the commands with binary data */
+    uint64_t *pLatencies;
+    size_t latencyCount;
+    size_t latencyCapacity;
+} cmdStats_t;
+
+typedef struct {
+    uint64_t timeUs;
+    uint64_t latencyUs;
+    int32_t status;
+    char text[MAX_CMD_TEXT_LEN];
+} slowCmd_t;
+
+typedef struct {
+    char name[MAX_NAME_LEN];
+    size_t count;
+    size_t binaryBytes;
+    uint64_t lastUs;
+    uint64_t minIntervalUs;
+    uint64_t second;        /**< Current one second window */
+    size_t secondCount;     /**< URCs in the current window */
+    size_t peakCount;
+    uint64_t peakSecond;
+} urcStats_t;
+
+typedef struct {
+    uint64_t thresholdUs;
+    size_t count;
+    uint64_t totalUs;
+    uint64_t maxUs;
+    uint64_t maxAtUs;
+    size_t histogram[4];    /**< Gaps of at least 10 ms, 100 ms, 1 s and 10 s */
+} idleStats_t;
+
+/* ----------------------------------------------------------------
+ * STATIC VARIABLES
+ * -------------------------------------------------------------- */
+
+static const uint64_t gHistogramUs[] = { 10000, 100000, 1000000, 10000000 };
+static const char *gHistogramNames[] = { "10ms", "100ms", "1s", "10s" };
+
+static rxFeed_t gFeed;
+static char gRxBuf[70000];  // Room for a binary URC of the max length
+static uint8_t gBinaryBuf[0xFFFF];
+static cmdStats_t *gCmdStats;
+static size_t gCmdStatsCount;
+static urcStats_t *gUrcStats;
+static size_t gUrcStatsCount;
+static slowCmd_t gSlowest[SLOWEST_COUNT];
+static size_t gSlowestCount;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static void *growArray(void *pArray, size_t count, size_t *pCapacity, size_t elementSize)
+{
+    if (count < *pCapacity) {
+        return pArray;
+    }
+    size_t capacity = (*pCapacity > 0) ? (*pCapacity * 2) : 16;
+    void *pNew = realloc(pArray, capacity * elementSize);
+    if (pNew == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    *pCapacity = capacity;
+    return pNew;
+}
+
+// Copies the start of a line up to one of the stop characters (included if keepStop)
+static void copyName(char *pName, const char *pLine, size_t length, const char *pStop,
+                     bool keepStop)
+{
+    size_t i = 0;
+    while ((i < length) && (i < (MAX_NAME_LEN - 1))) {
+        char ch = pLine[i];
+        if (strchr(pStop, ch) != NULL) {
+            if (keepStop && (i < (MAX_NAME_LEN - 2))) {
+                pName[i++] = ch;
+            }
+            break;
+        }
+        pName[i++] = ch;
+    }
+    pName[i] = 0;
+}
+
+// Reads the next TX byte, returns false at the end of the capture
+static bool txNextByte(txParser_t *pParser, uint8_t *pByte, uint64_t *pTimeUs)
+{
+    while (pParser->pos >= pParser->record.length) {
+        if (uPortUartCaptureReaderNext(pParser->reader, &pParser->record) <= 0) {
+            return false;
+        }
+        pParser->pos = pParser->record.rx ? pParser->record.length : 0;
+    }
+    *pByte = pParser->record.pData[pParser->pos++];
+    *pTimeUs = pParser->record.timeUs;
+    pParser->offset++;
+    return true;
+}
+
+// Splits the next command from the TX, "\r" or a binary payload ends a command
+static bool txNextCommand(txParser_t *pParser, command_t *pCmd)
+{
+    size_t textLength = 0;
+    uint8_t byte;
+    uint64_t timeUs;
+
+    memset(pCmd, 0, sizeof(command_t));
+    pCmd->startOffset = pParser->offset;
+    while (txNextByte(pParser, &byte, &timeUs)) {
+        if (pParser->offset == (pCmd->startOffset + 1)) {
+            pCmd->timeUs = timeUs;
+        }
+        if (byte == '\r') {
+            break;
+        }
+        if (byte == U_CX_SOH_CHAR) {
+            uint8_t lengthBytes[2];
+            if (!txNextByte(pParser, &lengthBytes[0], &timeUs) ||
+                !txNextByte(pParser, &lengthBytes[1], &timeUs)) {
+                break;
+            }
+            size_t length = ((size_t)lengthBytes[0] << 8) | lengthBytes[1];
+            while ((pCmd->binaryBytes < length) && txNextByte(pParser, &byte, &timeUs)) {
+                pCmd->binaryBytes++;
+            }
+            break;
+        }
+        if ((byte >= ' ') && (textLength < (sizeof(pCmd->text) - 1))) {
+            pCmd->text[textLength++] = (char)byte;
+        }
+    }
+    pCmd->endOffset = pParser->offset;
+    return (pCmd->endOffset > pCmd->startOffset);
+}
+
+static void feedNextRecord(rxFeed_t *pFeed)
+{
+    pFeed->pos = 0;
+    while (uPortUartCaptureReaderNext(pFeed->reader, &pFeed->record) > 0) {
+        if (pFeed->record.rx) {
+            pFeed->txBefore = pFeed->txCount;
+            return;
+        }
+        pFeed->txCount += pFeed->record.length;
+    }
+    pFeed->end = true;
+}
+
+static bool feedAvailable(const rxFeed_t *pFeed)
+{
+    return !pFeed->end && (pFeed->txBefore <= pFeed->releaseTx);
+}
+
+static uPortUartHandle_t feedOpen(const char *pDevName, int32_t baudRate, bool useFlowControl,
+                                  uint32_t flags)
+{
+    (void)pDevName;
+    (void)baudRate;
+    (void)useFlowControl;
+    (void)flags;
+    return &gFeed;
+}
+
+static void feedClose(uPortUartHandle_t handle)
+{
+    (void)handle;
+}
+
+// The commands are taken from the capture, what the client sends is not used
+static int32_t feedWrite(uPortUartHandle_t handle, const void *pData, size_t length)
+{
+    (void)handle;
+    (void)pData;
+    return (int32_t)length;
+}
+
+static int32_t feedRead(uPortUartHandle_t handle, void *pData, size_t length, int32_t timeoutMs)
+{
+    rxFeed_t *pFeed = (rxFeed_t *)handle;
+    size_t count = 0;
+    (void)timeoutMs;
+
+    while ((count < length) && feedAvailable(pFeed)) {
+        size_t chunk = pFeed->record.length - pFeed->pos;
+        if (chunk > (length - count)) {
+            chunk = length - count;
+        }
+        memcpy(&((uint8_t *)pData)[count], &pFeed->record.pData[pFeed->pos], chunk);
+        pFeed->pos += chunk;
+        count += chunk;
+        pFeed->lastTimeUs = pFeed->record.timeUs;
+        if (pFeed->pos == pFeed->record.length) {
+            feedNextRecord(pFeed);
+        }
+    }
+    if ((count == 0) && pFeed->inCommand) {
+        // The module didn't answer before the next command
+        return -1;
+    }
+    return (int32_t)count;
+}
+
+static const uPortUartOps_t gFeedOps = {
+    .openFn = feedOpen,
+    .closeFn = feedClose,
+    .writeFn = feedWrite,
+    .readFn = feedRead,
+    .writevFn = NULL,
+    .getFdFn = NULL,
+    .caps = 0
+};
+
+static cmdStats_t *getCmdStats(const char *pText)
+{
+    static size_t capacity;
+    char name[MAX_NAME_LEN];
+
+    copyName(name, pText, strlen(pText), "=?", true);
+    for (size_t i = 0; i < gCmdStatsCount; i++) {
+        if (strcmp(gCmdStats[i].name, name) == 0) {
+            return &gCmdStats[i];
+        }
+    }
+    gCmdStats = growArray(gCmdStats, gCmdStatsCount, &capacity, sizeof(cmdStats_t));
+    cmdStats_t *pStats = &gCmdStats[gCmdStatsCount++];
+    memset(pStats, 0, sizeof(cmdStats_t));
+    strcpy(pStats->name, name);
+    return pStats;
+}
+
+static void addSlowest(const command_t *pCmd, uint64_t latencyUs, int32_t status)
+{
+    size_t pos = gSlowestCount;
+    while ((pos > 0) && (gSlowest[pos - 1].latencyUs < latencyUs)) {
+        pos--;
+    }
+    if (pos >= SLOWEST_COUNT) {
+        return;
+    }
+    size_t moveCount = ((gSlowestCount < SLOWEST_COUNT) ? gSlowestCount : (SLOWEST_COUNT - 1)) -
+                       pos;
+    memmove(&gSlowest[pos + 1], &gSlowest[pos], moveCount * sizeof(slowCmd_t));
+    gSlowest[pos].timeUs = pCmd->timeUs;
+    gSlowest[pos].latencyUs = latencyUs;
+    gSlowest[pos].status = status;
+    strcpy(gSlowest[pos].text, pCmd->text);
+    if (gSlowestCount < SLOWEST_COUNT) {
+        gSlowestCount++;
+    }
+}
+
+static void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine, size_t lineLength,
+                        uint8_t *pBinaryData, size_t binaryDataLen)
+{
+    static size_t capacity;
+    uint64_t timeUs = gFeed.lastTimeUs;
+    char name[MAX_NAME_LEN];
+    urcStats_t *pStats = NULL;
+    (void)pClient;
+    (void)pTag;
+    (void)pBinaryData;
+
+    copyName(name, pLine, lineLength, ":", false);
+    for (size_t i = 0; (i < gUrcStatsCount) && (pStats == NULL); i++) {
+        if (strcmp(gUrcStats[i].name, name) == 0) {
+            pStats = &gUrcStats[i];
+        }
+    }
+    if (pStats == NULL) {
+        gUrcStats = growArray(gUrcStats, gUrcStatsCount, &capacity, sizeof(urcStats_t));
+        pStats = &gUrcStats[gUrcStatsCount++];
+        memset(pStats, 0, sizeof(urcStats_t));
+        strcpy(pStats->name, name);
+        pStats->minIntervalUs = UINT64_MAX;
+    } else if ((timeUs - pStats->lastUs) < pStats->minIntervalUs) {
+        pStats->minIntervalUs = timeUs - pStats->lastUs;
+    }
+    if ((pStats->count == 0) || ((timeUs / US_PER_SECOND) != pStats->second)) {
+        pStats->second = timeUs / US_PER_SECOND;
+        pStats->secondCount = 0;
+    }
+    pStats->secondCount++;
+    if (pStats->secondCount > pStats->peakCount) {
+        pStats->peakCount = pStats->secondCount;
+        pStats->peakSecond = pStats->second;
+    }
+    pStats->count++;
+    pStats->binaryBytes += binaryDataLen;
+    pStats->lastUs = timeUs;
+}
+
+// Handles the RX captured before the given TX offset as URCs
+static void handleRxUntil(uCxAtClient_t *pClient, uint64_t txOffset)
+{
+    gFeed.releaseTx = txOffset;
+    while (feedAvailable(&gFeed)) {
+        uCxAtClientHandleRx(pClient);
+    }
+}
+
+static void runCommand(uCxAtClient_t *pClient, const command_t *pCmd, uint64_t nextTxOffset)
+{
+    cmdStats_t *pStats = getCmdStats(pCmd->text);
+    char expectedRsp[MAX_NAME_LEN + 1] = "";
+    size_t binaryRxBytes = 0;
+    char *pLine;
+
+    // u-connectXpress responses start with the command name, e.g. AT+USORB -> "+USORB:"
+    if ((strncmp(pCmd->text, "AT+", 3) == 0) || (strncmp(pCmd->text, "AT*", 3) == 0)) {
+        copyName(expectedRsp, &pCmd->text[2], strlen(&pCmd->text[2]), "=?", false);
+        strcat(expectedRsp, ":");
+    }
+
+    // The client's own TX goes nowhere, only the parser state matters
+    uCxAtClientCmdBeginF(pClient, pCmd->text, "", U_CX_AT_UTIL_PARAM_LAST);
+    gFeed.releaseTx = nextTxOffset;
+    gFeed.inCommand = true;
+    do {
+        uint16_t binaryLength = sizeof(gBinaryBuf);
+        pLine = uCxAtClientCmdGetRspParamLine(pClient, expectedRsp, gBinaryBuf, &binaryLength);
+        // Echo of a command without '+', e.g. "ATE0", isn't a response
+        if ((pLine != NULL) && (strcmp(pLine, pCmd->text) != 0)) {
+            pStats->responses++;
+            // The length is only updated by a binary transfer
+            if (binaryLength != sizeof(gBinaryBuf)) {
+                binaryRxBytes += binaryLength;
+            }
+        }
+    } while (pLine != NULL);
+    int32_t status = uCxAtClientCmdEnd(pClient);
+    gFeed.inCommand = false;
+
+    pStats->count++;
+    pStats->binaryTxBytes += pCmd->binaryBytes;
+    pStats->binaryRxBytes += binaryRxBytes;
+    if ((status == U_CX_ERROR_IO) || (status == U_CX_ERROR_CMD_TIMEOUT)) {
+        pStats->noStatus++;
+        return;
+    }
+    if (status == 0) {
+        pStats->ok++;
+    } else {
+        pStats->error++;
+    }
+    uint64_t latencyUs = gFeed.lastTimeUs - pCmd->timeUs;
+    pStats->pLatencies = growArray(pStats->pLatencies, pStats->latencyCount,
+                                   &pStats->latencyCapacity, sizeof(uint64_t));
+    pStats->pLatencies[pStats->latencyCount++] = latencyUs;
+    if ((pCmd->binaryBytes > 0) || (binaryRxBytes > 0)) {
+        pStats->binaryUs += latencyUs;
+    }
+    addSlowest(pCmd, latencyUs, status);
+}
+
+static bool analyzeTraffic(const char *pFileName)
+{
+    uCxAtClientConfig_t config;
+    uCxAtClient_t client;
+    txParser_t txParser;
+    command_t cmd;
+    command_t nextCmd;
+
+    memset(&txParser, 0, sizeof(txParser));
+    memset(&gFeed, 0, sizeof(gFeed));
+    txParser.reader = uPortUartCaptureReaderOpen(pFileName, NULL);
+    gFeed.reader = uPortUartCaptureReaderOpen(pFileName, NULL);
+    if ((txParser.reader == NULL) || (gFeed.reader == NULL)) {
+        uPortUartCaptureReaderClose(txParser.reader);
+        uPortUartCaptureReaderClose(gFeed.reader);
+        return false;
+    }
+    feedNextRecord(&gFeed);
+
+    memset(&config, 0, sizeof(config));
+    config.pRxBuffer = gRxBuf;
+    config.rxBufferLen = sizeof(gRxBuf);
+    config.pUartDevName = pFileName;
+    config.pUartOps = &gFeedOps;
+    uCxAtClientInit(&config, &client);
+    uCxAtClientOpen(&client, 115200, false);
+    uCxAtClientSetUrcCallback(&client, urcCallback, NULL);
+
+    bool haveCmd = txNextCommand(&txParser, &cmd);
+    while (haveCmd) {
+        bool haveNext = txNextCommand(&txParser, &nextCmd);
+        handleRxUntil(&client, cmd.startOffset);
+        // Everything until the next command is sent belongs to this one
+        runCommand(&client, &cmd, haveNext ? nextCmd.startOffset : UINT64_MAX);
+        cmd = nextCmd;
+        haveCmd = haveNext;
+    }
+    handleRxUntil(&client, UINT64_MAX);
+
+    uCxAtClientClose(&client);
+    uCxAtClientDeinit(&client);
+    uPortUartCaptureReaderClose(txParser.reader);
+    uPortUartCaptureReaderClose(gFeed.reader);
+    return true;
+}
+
+// Totals and idle gaps from all records
+static bool analyzeRecords(const char *pFileName, uint64_t idleUs, size_t *pBytes,
+                           uint64_t *pDurationUs, idleStats_t *pIdle)
+{
+    uPortUartCaptureRecord_t record;
+    uint64_t lastUs = 0;
+    bool first = true;
+    int32_t ret;
+
+    uPortUartCaptureReader_t reader = uPortUartCaptureReaderOpen(pFileName, NULL);
+    if (reader == NULL) {
+        return false;
+    }
+    memset(pIdle, 0, sizeof(idleStats_t));
+    pIdle->thresholdUs = idleUs;
+    while ((ret = uPortUartCaptureReaderNext(reader, &record)) > 0) {
+        uint64_t gapUs = first ? 0 : (record.timeUs - lastUs);
+        if ((gapUs >= idleUs) && (gapUs > 0)) {
+            pIdle->count++;
+            pIdle->totalUs += gapUs;
+            if (gapUs > pIdle->maxUs) {
+                pIdle->maxUs = gapUs;
+                pIdle->maxAtUs = lastUs;
+            }
+        }
+        for (size_t i = 0; i < (sizeof(gHistogramUs) / sizeof(gHistogramUs[0])); i++) {
+            if (gapUs >= gHistogramUs[i]) {
+                pIdle->histogram[i]++;
+            }
+        }
+        pBytes[record.rx ? 1 : 0] += record.length;
+        lastUs = record.timeUs;
+        first = false;
+    }
+    uPortUartCaptureReaderClose(reader);
+    *pDurationUs = lastUs;
+    return (ret == 0);
+}
+
+static int compareU64(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+    return (a > b) - (a < b);
+}
+
+static uint64_t percentile(const uint64_t *pSorted, size_t count, size_t percent)
+{
+    return pSorted[((count - 1) * percent) / 100];
+}
+
+static void printJsonString(FILE *pOut, const char *pStr)
+{
+    fputc('"', pOut);
+    for (; *pStr != 0; pStr++) {
+        if ((*pStr == '"') || (*pStr == '\\')) {
+            fprintf(pOut, "\\%c", *pStr);
+        } else if ((unsigned char)*pStr < ' ') {
+            fprintf(pOut, "\\u%04x", (unsigned)(unsigned char)*pStr);
+        } else {
+            fputc(*pStr, pOut);
+        }
+    }
+    fputc('"', pOut);
+}
+
+static double perSecond(size_t count, uint64_t us)
+{
+    return (us > 0) ? ((double)count * 1e6 / (double)us) : 0.0;
+}
+
+static void printCommands(FILE *pOut)
+{
+    fprintf(pOut, "  \"commands\": [");
+    for (size_t i = 0; i < gCmdStatsCount; i++) {
+        cmdStats_t *pStats = &gCmdStats[i];
+        fprintf(pOut, "%s\n    {\"command\": ", (i > 0) ? "," : "");
+        printJsonString(pOut, pStats->name);
+        fprintf(pOut, ", \"count\": %zu, \"ok\": %zu, \"error\": %zu, \"noStatus\": %zu, "
+                "\"responses\": %zu", pStats->count, pStats->ok, pStats->error,
+                pStats->noStatus, pStats->responses);
+        if (pStats->latencyCount > 0) {
+            uint64_t total = 0;
+            qsort(pStats->pLatencies, pStats->latencyCount, sizeof(uint64_t), compareU64);
+            for (size_t j = 0; j < pStats->latencyCount; j++) {
+                total += pStats->pLatencies[j];
+            }
+            fprintf(pOut, ",\n     \"latencyUs\": {\"min\": %llu, \"mean\": %llu, \"p50\": %llu, "
+                    "\"p90\": %llu, \"p99\": %llu, \"max\": %llu}",
+                    (unsigned long long)pStats->pLatencies[0],
+                    (unsigned long long)(total / pStats->latencyCount),
+                    (unsigned long long)percentile(pStats->pLatencies, pStats->latencyCount, 50),
+                    (unsigned long long)percentile(pStats->pLatencies, pStats->latencyCount, 90),
+                    (unsigned long long)percentile(pStats->pLatencies, pStats->latencyCount, 99),
+                    (unsigned long long)pStats->pLatencies[pStats->latencyCount - 1]);
+        }
+        if ((pStats->binaryTxBytes > 0) || (pStats->binaryRxBytes > 0)) {
+            fprintf(pOut, ",\n     \"binaryTxBytes\": %zu, \"binaryRxBytes\": %zu, "
+                    "\"binaryBytesPerSecond\": %.0f", pStats->binaryTxBytes,
+                    pStats->binaryRxBytes,
+                    perSecond(pStats->binaryTxBytes + pStats->binaryRxBytes, pStats->binaryUs));
+        }
+        fprintf(pOut, "}");
+    }
+    fprintf(pOut, "\n  ],\n");
+
+    fprintf(pOut, "  \"slowestCommands\": [");
+    for (size_t i = 0; i < gSlowestCount; i++) {
+        fprintf(pOut, "%s\n    {\"timeUs\": %llu, \"latencyUs\": %llu, \"status\": %d, "
+                "\"command\": ", (i > 0) ? "," : "", (unsigned long long)gSlowest[i].timeUs,
+                (unsigned long long)gSlowest[i].latencyUs, (int)gSlowest[i].status);
+        printJsonString(pOut, gSlowest[i].text);
+        fprintf(pOut, "}");
+    }
+    fprintf(pOut, "\n  ],\n");
+}
+
+static void printUrcs(FILE *pOut, uint64_t durationUs)
+{
+    fprintf(pOut, "  \"urcs\": [");
+    for (size_t i = 0; i < gUrcStatsCount; i++) {
+        urcStats_t *pStats = &gUrcStats[i];
+        fprintf(pOut, "%s\n    {\"urc\": ", (i > 0) ? "," : "");
+        printJsonString(pOut, pStats->name);
+        fprintf(pOut, ", \"count\": %zu, \"perSecond\": %.2f, \"peakPerSecond\": %zu, "
+                "\"peakAtUs\": %llu, \"minIntervalUs\": %llu, \"binaryBytes\": %zu}",
+                pStats->count, perSecond(pStats->count, durationUs), pStats->peakCount,
+                (unsigned long long)(pStats->peakSecond * US_PER_SECOND),
+                (unsigned long long)((pStats->count > 1) ? pStats->minIntervalUs : 0),
+                pStats->binaryBytes);
+    }
+    fprintf(pOut, "\n  ],\n");
+}
+
+static void printIdle(FILE *pOut, const idleStats_t *pIdle)
+{
+    fprintf(pOut, "  \"idle\": {\"thresholdUs\": %llu, \"count\": %zu, \"totalUs\": %llu, "
+            "\"maxUs\": %llu, \"maxAtUs\": %llu,\n           \"histogram\": {",
+            (unsigned long long)pIdle->thresholdUs, pIdle->count,
+            (unsigned long long)pIdle->totalUs, (unsigned long long)pIdle->maxUs,
+            (unsigned long long)pIdle->maxAtUs);
+    for (size_t i = 0; i < (sizeof(gHistogramUs) / sizeof(gHistogramUs[0])); i++) {
+        fprintf(pOut, "%s\"%s\": %zu", (i > 0) ? ", " : "", gHistogramNames[i],
+                pIdle->histogram[i]);
+    }
+    fprintf(pOut, "}}\n");
+}
+
+/* ----------------------------------------------------------------
+ * MAIN
+ * -------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    uPortUartCaptureInfo_t info;
+    idleStats_t idle;
+    size_t bytes[2] = { 0, 0 };
+    uint64_t durationUs = 0;
+    long idleMs = DEFAULT_IDLE_MS;
+    const char *pOutName = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:o:")) != -1) {
+        if (opt == 'i') {
+            idleMs = strtol(optarg, NULL, 0);
+        } else if (opt == 'o') {
+            pOutName = optarg;
+        } else {
+            optind = argc + 1;
+            break;
+        }
+    }
+    if ((optind != (argc - 1)) || (idleMs <= 0)) {
+        fprintf(stderr, "Usage: %s [-i idle_ms] [-o report.json] capture_file\n", argv[0]);
+        return 1;
+    }
+    const char *pFileName = argv[optind];
+
+    uCxLogDisable();
+    uPortInit();
+    uPortUartCaptureReader_t reader = uPortUartCaptureReaderOpen(pFileName, &info);
+    if (reader == NULL) {
+        fprintf(stderr, "Can't read capture file %s\n", pFileName);
+        return 1;
+    }
+    uPortUartCaptureReaderClose(reader);
+    if (!analyzeRecords(pFileName, (uint64_t)idleMs * 1000, bytes, &durationUs, &idle)) {
+        fprintf(stderr, "Capture file %s is corrupt\n", pFileName);
+        return 1;
+    }
+    if (!analyzeTraffic(pFileName)) {
+        fprintf(stderr, "Can't read capture file %s\n", pFileName);
+        return 1;
+    }
+
+    FILE *pOut = (pOutName != NULL) ? fopen(pOutName, "w") : stdout;
+    if (pOut == NULL) {
+        fprintf(stderr, "Can't create %s\n", pOutName);
+        return 1;
+    }
+    fprintf(pOut, "{\n  \"file\": ");
+    printJsonString(pOut, pFileName);
+    fprintf(pOut, ",\n  \"startTimeUs\": %llu, \"durationUs\": %llu, \"baudRate\": %d, "
+            "\"flowControl\": %s, \"indexed\": %s,\n  \"txBytes\": %zu, \"rxBytes\": %zu,\n",
+            (unsigned long long)info.startTimeUs, (unsigned long long)durationUs,
+            (int)info.baudRate, info.flowControl ? "true" : "false",
+            info.indexed ? "true" : "false", bytes[0], bytes[1]);
+    printCommands(pOut);
+    printUrcs(pOut, durationUs);
+    printIdle(pOut, &idle);
+    fprintf(pOut, "}\n");
+    if (pOut != stdout) {
+        fclose(pOut);
+    }
+    uPortDeinit();
+    return 0;
+}
@@ -9,6 +9,8 @@
 
 #include "u_cx_log.h"
 #include "u_cx_urc.h"
+#include "u_cx_general.h"
+#include "u_cx_system.h"
 
 #include "u_cx.h"
 
@@ -28,6 +30,40 @@
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
+static const int32_t gDefaultBaudRates[] = { U_CX_NEGOTIATE_BAUD_RATES };
+
+#if U_CX_USE_URC_QUEUE == 1
+static const uCxAtUrcCoalesceRule_t gDefaultUrcCoalesceRules[] = {
+    { "+UESODA:", U_CX_URC_COALESCE_SUM, 0 },
+    { "+UEBTBGD:", U_CX_URC_COALESCE_DEDUP, U_CX_URC_DEDUP_WINDOW_MS },
+};
+
+static const uCxAtUrcClassConfig_t gDefaultUrcClassConfigs[U_CX_URC_CLASS_COUNT] = {
+    [U_CX_URC_CLASS_CRITICAL] = { 25, U_CX_URC_DROP_NEWEST },
+    [U_CX_URC_CLASS_DATA] = { 50, U_CX_URC_DROP_NEWEST },
+    [U_CX_URC_CLASS_BULK] = { 25, U_CX_URC_DROP_OLDEST },
+};
+
+static const uCxAtUrcClassRule_t gDefaultUrcClassRules[] = {
+    // Module and link state changes
+    { "+STARTUP", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWLU:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWLD:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWSNU", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWSND", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWAPNU", U_CX_URC_CLASS_CRITICAL },
+    { "+UEWAPND", U_CX_URC_CLASS_CRITICAL },
+    { "+UESOC:", U_CX_URC_CLASS_CRITICAL },
+    { "+UESOCL:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEBTC:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEBTDC:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEMQC:", U_CX_URC_CLASS_CRITICAL },
+    { "+UEMQDC:", U_CX_URC_CLASS_CRITICAL },
+    // Discovery results
+    { "+UEBTBGD:", U_CX_URC_CLASS_BULK },
+};
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -59,6 +95,37 @@ static void urcCallback(struct uCxAtClient *pClient, void *pTag, char *pLine, si
     uCxUrcParse(puCxHandle, pLine, pParams, paramLen);
 }
 
+static bool reopenUart(uCxAtClient_t *pClient, int32_t baudRate, bool flowControl)
+{
+    uCxAtClientClose(pClient);
+    return uCxAtClientOpen(pClient, baudRate, flowControl) == 0;
+}
+
+static bool verifyLink(uCxHandle_t *puCxHandle)
+{
+    // The first command may fail on garbage received during the switch
+    for (int32_t i = 0; i < 3; i++) {
+        uCxAtClientSetCommandTimeout(puCxHandle->pAtClient, U_CX_BAUD_VERIFY_TIMEOUT_MS, false);
+        if (uCxGeneralAttention(puCxHandle) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The module has switched to a baud rate that the link can't handle, ask it
+// to switch back over that link. The response may be garbled so it is sent
+// a few times, a module that already switched back ignores the garbage.
+static void switchModuleBack(uCxHandle_t *puCxHandle, int32_t baudRate, bool flowControl)
+{
+    for (int32_t i = 0; i < 3; i++) {
+        uCxAtClientSetCommandTimeout(puCxHandle->pAtClient, U_CX_BAUD_VERIFY_TIMEOUT_MS, false);
+        if (uCxSystemSetUartSettings3(puCxHandle, baudRate, flowControl ? 1 : 0, 1) == 0) {
+            break;
+        }
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -74,3 +141,81 @@ int32_t uCxEnd(uCxHandle_t *puCxHandle)
 {
     return uCxAtClientCmdEnd(puCxHandle->pAtClient);
 }
+
+int32_t uCxNegotiateBaudRate(uCxHandle_t *puCxHandle, int32_t baudRate, bool flowControl,
+                             const int32_t *pBaudRates, size_t numBaudRates)
+{
+    uCxAtClient_t *pClient = puCxHandle->pAtClient;
+
+    if (pBaudRates == NULL) {
+        pBaudRates = gDefaultBaudRates;
+        numBaudRates = sizeof(gDefaultBaudRates) / sizeof(gDefaultBaudRates[0]);
+    }
+
+    for (size_t i = 0; i < numBaudRates; i++) {
+        int32_t newBaudRate = pBaudRates[i];
+        if (newBaudRate <= baudRate) {
+            continue;
+        }
+
+        // Make sure the host UART accepts the baud rate before switching the module
+        bool hostSupported = reopenUart(pClient, newBaudRate, flowControl);
+        if (!reopenUart(pClient, baudRate, flowControl)) {
+            return U_CX_ERROR_IO;
+        }
+        if (!hostSupported) {
+            continue;
+        }
+
+        if (uCxSystemSetUartSettings3(puCxHandle, newBaudRate, flowControl ? 1 : 0, 1) != 0) {
+            // Not supported by the module
+            continue;
+        }
+        U_CX_PORT_SLEEP_MS(U_CX_BAUD_SWITCH_DELAY_MS);
+        if (reopenUart(pClient, newBaudRate, flowControl)) {
+            if (verifyLink(puCxHandle)) {
+                U_CX_LOG_LINE_I(U_CX_LOG_CH_DBG, pClient->instance,
+                                "Switched to %d baud", newBaudRate);
+                return newBaudRate;
+            }
+            // The module now runs at the new baud rate, so it must be told to
+            // switch back before the host can
+            U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance,
+                            "Link not working at %d baud, switching back to %d",
+                            newBaudRate, baudRate);
+            switchModuleBack(puCxHandle, baudRate, flowControl);
+            U_CX_PORT_SLEEP_MS(U_CX_BAUD_SWITCH_DELAY_MS);
+        }
+
+        if (!reopenUart(pClient, baudRate, flowControl) || !verifyLink(puCxHandle)) {
+            U_CX_LOG_LINE_I(U_CX_LOG_CH_WARN, pClient->instance,
+                            "Lost the link at both %d and %d baud, the module must be reset",
+                            newBaudRate, baudRate);
+            return U_CX_ERROR_IO;
+        }
+    }
+
+    return baudRate;
+}
+
+#if U_CX_USE_URC_QUEUE == 1
+void uCxSetDefaultUrcCoalescing(uCxHandle_t *puCxHandle, bool enable)
+{
+    if (enable) {
+        uCxAtClientSetUrcCoalesceRules(puCxHandle->pAtClient, gDefaultUrcCoalesceRules,
+                                       sizeof(gDefaultUrcCoalesceRules) / sizeof(gDefaultUrcCoalesceRules[0]));
+    } else {
+        uCxAtClientSetUrcCoalesceRules(puCxHandle->pAtClient, NULL, 0);
+    }
+}
+
+int32_t uCxSetDefaultUrcClasses(uCxHandle_t *puCxHandle, bool enable)
+{
+    if (enable) {
+        return uCxAtClientSetUrcClasses(puCxHandle->pAtClient, gDefaultUrcClassConfigs,
+                                        gDefaultUrcClassRules,
+                                        sizeof(gDefaultUrcClassRules) / sizeof(gDefaultUrcClassRules[0]));
+    }
+    return uCxAtClientSetUrcClasses(puCxHandle->pAtClient, NULL, NULL, 0);
+}
+#endif
@@ -7,6 +7,7 @@
 
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "u_cx_at_client.h"
 #include "u_cx_types.h"
@@ -15,6 +16,28 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/* Time window used for dropping duplicated discovery URCs when
+ * uCxSetDefaultUrcCoalescing() is enabled.
+ */
+#ifndef U_CX_URC_DEDUP_WINDOW_MS
+# define U_CX_URC_DEDUP_WINDOW_MS 1000
+#endif
+
+/* Baud rates tried by uCxNegotiateBaudRate() when no list is given, highest first */
+#ifndef U_CX_NEGOTIATE_BAUD_RATES
+# define U_CX_NEGOTIATE_BAUD_RATES 3000000, 2000000, 1500000, 1000000, 921600, 460800, 230400
+#endif
+
+/* Time given to the module for switching baud rate before the link is verified */
+#ifndef U_CX_BAUD_SWITCH_DELAY_MS
+# define U_CX_BAUD_SWITCH_DELAY_MS 100
+#endif
+
+/* Timeout of each "AT" sent when verifying the link after a baud rate switch */
+#ifndef U_CX_BAUD_VERIFY_TIMEOUT_MS
+# define U_CX_BAUD_VERIFY_TIMEOUT_MS 500
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -51,5 +74,78 @@ void uCxInit(uCxAtClient_t *pAtClient, uCxHandle_t *puCxHandle);
   */
 int32_t uCxEnd(uCxHandle_t *puCxHandle);
 
+/**
+  * @brief  Switch the UART to the highest baud rate supported by both ends
+  *
+  * Each baud rate in pBaudRates that is higher than the current one is tried
+  * in the given order: the host UART is first checked to accept the baud rate,
+  * then the module is told to switch directly with AT+USYUS=<baud_rate>,<flow_control>,1,
+  * the AT client UART is reopened at the new baud rate and the link is verified
+  * with "AT". If the host UART or the module doesn't accept the baud rate the
+  * next one is tried. If the link doesn't work at the new baud rate the module
+  * is told to switch back with AT+USYUS=<baudRate>,<flow_control>,1 over that
+  * link, the UART is reopened at the previous baud rate and the next one is
+  * tried. The new baud rate is not stored in the module so it returns to its
+  * configured baud rate after a reboot.
+  *
+  * If switching back fails too, the module is left at a baud rate the host
+  * can't use and U_CX_ERROR_IO is returned. The module must then be reset
+  * (or power cycled) to return to its configured baud rate.
+  *
+  * The host UART check relies on the UART port rejecting baud rates it can't
+  * set, like the Linux port does. Don't use this function over a socket
+  * device (tcp://, unix://), where the baud rate is set by the remote end.
+  *
+  * The AT client must be opened at baudRate before calling this function.
+  *
+  * @param[in]  puCxHandle:    the handle from uCxInit().
+  * @param      baudRate:      the baud rate the AT client is currently opened with.
+  * @param      flowControl:   the flow control the AT client is opened with.
+  * @param[in]  pBaudRates:    the baud rates to try, highest first, or NULL
+  *                            for U_CX_NEGOTIATE_BAUD_RATES.
+  * @param      numBaudRates:  number of entries in pBaudRates.
+  * @retval                    the baud rate in use after the call (baudRate if
+  *                            no higher baud rate worked) or U_CX_ERROR_IO if
+  *                            the link was lost and the module must be reset.
+  */
+int32_t uCxNegotiateBaudRate(uCxHandle_t *puCxHandle, int32_t baudRate, bool flowControl,
+                             const int32_t *pBaudRates, size_t numBaudRates);
+
+#if U_CX_USE_URC_QUEUE == 1
+/**
+  * @brief  Enable/disable the default URC coalescing rules
+  *
+  * When enabled the following URCs are coalesced before being queued:
+  * - "+UESODA" following each other for the same socket are merged into one
+  *   URC with the summed byte count.
+  * - "+UEBTBGD" for the same bd_addr within U_CX_URC_DEDUP_WINDOW_MS are dropped.
+  *
+  * "+UEMQDA" is never coalesced as uCxMqttReadBegin() reads one message per
+  * call, so the application needs one URC for each received message.
+  *
+  * @param[in]  puCxHandle: the handle from uCxInit().
+  * @param      enable:     true to enable coalescing, false to disable.
+  */
+void uCxSetDefaultUrcCoalescing(uCxHandle_t *puCxHandle, bool enable);
+
+/**
+  * @brief  Enable/disable the default URC classes
+  *
+  * When enabled the URC queue is split into the following URC classes:
+  * - Critical (25%): link, network, socket and connection state changes plus
+  *   "+STARTUP". Newest URCs are dropped when full.
+  * - Bulk (25%): "+UEBTBGD" discovery results. Oldest URCs are dropped when full.
+  * - Data (50%): all other URCs. Newest URCs are dropped when full.
+  *
+  * This makes sure a discovery flood can't cause state change URCs to be lost.
+  * Must be called while the URC queue is empty (e.g. directly after uCxInit()).
+  *
+  * @param[in]  puCxHandle: the handle from uCxInit().
+  * @param      enable:     true to enable the URC classes, false to use a single queue.
+  * @retval                 0 on success, negative value on error.
+  */
+int32_t uCxSetDefaultUrcClasses(uCxHandle_t *puCxHandle, bool enable);
+#endif
+
 
 #endif // U_CX_H
\ No newline at end of file